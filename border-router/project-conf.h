@@ -46,4 +46,10 @@
 #undef IEEE802154_CONF_PANID
 #define IEEE802154_CONF_PANID 0x0041
 
+/* Multicast forwarding of the group commands of the collector (enabled with "make MULTICAST=1"). */
+#ifdef SMART_ICU_MULTICAST
+#include "net/ipv6/multicast/uip-mcast6-engines.h"
+#define UIP_MCAST6_CONF_ENGINE UIP_MCAST6_ENGINE_ESMRF
+#endif
+
 #endif /* PROJECT_CONF_H_ */
@@ -7,6 +7,7 @@ import it.unipi.smartICU.coap.CoapCollector;
 import it.unipi.smartICU.mqtt.MqttCollector;
 import it.unipi.smartICU.utils.Configuration;
 import it.unipi.smartICU.analytics.PatientHealthDeterioration;
+import it.unipi.smartICU.analytics.TelemetryStatisticsReport;
 
 import org.apache.commons.cli.CommandLine;
 import org.apache.commons.cli.CommandLineParser;
@@ -40,6 +41,7 @@ public class Collector {
     private Logger logger;
     private final static String LOGGER_NAME = "it.unipi.smartICU";
     private final static String LOGGER_PROPERTIES = "/logging.properties";
+    private final static int DEFAULT_TIME_SYNCHRONIZATION_RATE = 240;   // Same interval as the refreshes of the CoAP monitors, in seconds.
 
     /**
      * Loads the configuration of the logger stored in <code>resources/LOGGER_PROPERTIES</code>.
@@ -68,7 +70,9 @@ public class Collector {
     /**
      * Starts the collector initializing the telemetry database,
      * instantiating the MQTT and CoAP collectors and starting
-     * the periodic service to check the patient health deterioration.
+     * the periodic services to check the patient health deterioration and
+     * to send the time of the collector to the MQTT monitors and, if configured,
+     * the periodic report of the telemetry statistics.
      */
     public void start() {
         logger.log(Level.INFO, "Initializing the connection to the telemetry database.");
@@ -91,6 +95,27 @@ public class Collector {
                                       configuration.getPatientHealthDeteriorationSchedulingRate(),
                                       configuration.getPatientHealthDeteriorationSchedulingRate(),
                                       TimeUnit.SECONDS);
+
+        // The CoAP monitors receive the time with the refreshes of their registration.
+        logger.log(Level.INFO, "Scheduling the time synchronization of the MQTT monitors.");
+        int timeSynchronizationRate = configuration.getTimeSynchronizationRate() > 0
+                                      ? configuration.getTimeSynchronizationRate()
+                                      : DEFAULT_TIME_SYNCHRONIZATION_RATE;
+        scheduler.scheduleAtFixedRate(mqttCollector::synchronizeTime,
+                                      timeSynchronizationRate,
+                                      timeSynchronizationRate,
+                                      TimeUnit.SECONDS);
+
+        if (configuration.getTelemetryStatisticsReportRate() > 0) {
+            logger.log(Level.INFO, "Scheduling the report of the telemetry statistics.");
+            TelemetryStatisticsReport statisticsReportTask = new TelemetryStatisticsReport(logger,
+                                                                                           mqttCollector,
+                                                                                           coapCollector);
+            scheduler.scheduleAtFixedRate(statisticsReportTask,
+                                          configuration.getTelemetryStatisticsReportRate(),
+                                          configuration.getTelemetryStatisticsReportRate(),
+                                          TimeUnit.SECONDS);
+        }
     }
 
     /**
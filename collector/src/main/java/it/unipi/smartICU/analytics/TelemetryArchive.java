@@ -6,6 +6,7 @@ import org.apache.commons.lang3.exception.ExceptionUtils;
 
 import java.sql.Connection;
 import java.sql.DriverManager;
+import java.sql.ResultSet;
 import java.sql.SQLException;
 import java.sql.Statement;
 import java.util.Locale;
@@ -41,24 +42,70 @@ public class TelemetryArchive {
 
         /*
          * Test connection to the database and create tables
-         * for telemetry data, if not already present.
+         * for telemetry data, if not already present. The timestamps
+         * are in milliseconds since the epoch, indexed for time range queries.
+         * The tables of previous versions are migrated (see migrateTable()).
          */
         String createTableQuery = "CREATE TABLE IF NOT EXISTS %s (" +
                                   "sample_id INT UNSIGNED NOT NULL AUTO_INCREMENT, " +
                                   "sample FLOAT NOT NULL, " +
                                   "unit VARCHAR(30) NOT NULL, " +
-                                  "timestamp VARCHAR(50) NOT NULL, " +
+                                  "timestamp BIGINT UNSIGNED NOT NULL, " +
                                   "patient_id VARCHAR(45) NOT NULL, " +
                                   "monitor_id VARCHAR(45) NOT NULL, " +
-                                  "PRIMARY KEY (sample_id)) " +
+                                  "PRIMARY KEY (sample_id), " +
+                                  "INDEX (patient_id, timestamp), " +
+                                  "INDEX (timestamp)) " +
                                   "ENGINE = InnoDB;";
 
+        String createAlarmEventTableQuery = "CREATE TABLE IF NOT EXISTS alarm_event (" +
+                                            "event_id INT UNSIGNED NOT NULL AUTO_INCREMENT, " +
+                                            "sequence INT UNSIGNED NOT NULL, " +
+                                            "sensor VARCHAR(30) NULL, " +
+                                            "value FLOAT NOT NULL, " +
+                                            "alarm BOOLEAN NOT NULL, " +
+                                            "timestamp BIGINT UNSIGNED NOT NULL, " +
+                                            "patient_id VARCHAR(45) NOT NULL, " +
+                                            "monitor_id VARCHAR(45) NOT NULL, " +
+                                            "PRIMARY KEY (event_id), " +
+                                            "INDEX (monitor_id, sequence), " +
+                                            "INDEX (patient_id, timestamp), " +
+                                            "INDEX (timestamp)) " +
+                                            "ENGINE = InnoDB;";
+
+        // The times of the diagnostics reports are in milliseconds, the failures are grouped by status.
+        String createDiagnosticsTableQuery = "CREATE TABLE IF NOT EXISTS monitor_diagnostics (" +
+                                             "diagnostics_id INT UNSIGNED NOT NULL AUTO_INCREMENT, " +
+                                             "period INT UNSIGNED NOT NULL, " +
+                                             "cpu INT UNSIGNED NOT NULL, " +
+                                             "lpm INT UNSIGNED NOT NULL, " +
+                                             "radio_tx INT UNSIGNED NOT NULL, " +
+                                             "radio_rx INT UNSIGNED NOT NULL, " +
+                                             "queue_high_water_mark INT UNSIGNED NOT NULL, " +
+                                             "dropped INT UNSIGNED NOT NULL, " +
+                                             "failures_queue_full INT UNSIGNED NOT NULL, " +
+                                             "failures_not_connected INT UNSIGNED NOT NULL, " +
+                                             "failures_invalid_args INT UNSIGNED NOT NULL, " +
+                                             "failures_other INT UNSIGNED NOT NULL, " +
+                                             "timestamp BIGINT UNSIGNED NOT NULL, " +
+                                             "monitor_id VARCHAR(45) NOT NULL, " +
+                                             "PRIMARY KEY (diagnostics_id), " +
+                                             "INDEX (monitor_id, timestamp), " +
+                                             "INDEX (timestamp)) " +
+                                             "ENGINE = InnoDB;";
+
         try (Connection connection = DriverManager.getConnection(url, username, password);
              Statement statement = connection.createStatement()) {
             TelemetryArchive.logger.log(Level.INFO, "Connected to the telemetry database.");
 
-            for (SensorType sensor : SensorType.values())
+            for (SensorType sensor : SensorType.values()) {
                 statement.executeUpdate(String.format(createTableQuery, sensor.name().toLowerCase()));
+                migrateTable(statement, sensor.name().toLowerCase(), "patient_id, timestamp", "timestamp");
+            }
+
+            statement.executeUpdate(createAlarmEventTableQuery);
+            migrateTable(statement, "alarm_event", "monitor_id, sequence", "patient_id, timestamp", "timestamp");
+            statement.executeUpdate(createDiagnosticsTableQuery);
 
             return true;
         } catch (SQLException exception) {
@@ -68,21 +115,64 @@ public class TelemetryArchive {
         }
     }
 
+    /**
+     * Migrates a table created by a previous version of the collector, which stored the
+     * timestamps as text (seconds since the boot of the monitor) and had no indexes on them.
+     * The timestamps become BIGINT UNSIGNED, the old ones rounded to whole numbers, which
+     * stay far below any time since the epoch. The missing indexes are then added.
+     * @param statement  the statement used to query and alter the table.
+     * @param table      the name of the table.
+     * @param indexes    the columns of each index the table must have.
+     * @throws SQLException  if the table cannot be migrated.
+     */
+    private static void migrateTable(Statement statement, String table, String... indexes) throws SQLException {
+        String selectTypeQuery = "SELECT DATA_TYPE FROM information_schema.COLUMNS " +
+                                 "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = \"%s\" AND COLUMN_NAME = \"timestamp\";";
+        String selectIndexQuery = "SELECT 1 FROM information_schema.STATISTICS " +
+                                  "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = \"%s\" " +
+                                  "AND COLUMN_NAME = \"%s\" AND SEQ_IN_INDEX = 1;";
+        boolean textTimestamps;
+
+        try (ResultSet resultSet = statement.executeQuery(String.format(selectTypeQuery, table))) {
+            textTimestamps = resultSet.next() && !resultSet.getString(1).equalsIgnoreCase("bigint");
+        }
+
+        if (textTimestamps) {
+            logger.log(Level.INFO, String.format("Migrating the timestamps of table %s to BIGINT.", table));
+            statement.executeUpdate(String.format("UPDATE %s SET timestamp = CAST(ROUND(timestamp) AS UNSIGNED);", table));
+            statement.executeUpdate(String.format("ALTER TABLE %s MODIFY timestamp BIGINT UNSIGNED NOT NULL;", table));
+        }
+
+        // An index is identified by its first column, which is different for each index of a table.
+        for (String index : indexes) {
+            boolean indexed;
+
+            try (ResultSet resultSet = statement.executeQuery(String.format(selectIndexQuery, table, index.split(",")[0]))) {
+                indexed = resultSet.next();
+            }
+
+            if (!indexed) {
+                logger.log(Level.INFO, String.format("Adding the index (%s) to table %s.", index, table));
+                statement.executeUpdate(String.format("ALTER TABLE %s ADD INDEX (%s);", table, index));
+            }
+        }
+    }
+
     /**
      * Saves a telemetry sample generated by a sensor in the telemetry archive.
      * @param sensor     the type of sensor that produced the sample.
      * @param sample     the sample produced by the sensor.
      * @param unit       the measurement unit of the sample.
-     * @param timestamp  the timestamp of the sample.
+     * @param timestamp  the timestamp of the sample, in milliseconds since the epoch.
      * @param monitorId  the ID of the monitor that produced the sample.
      * @param patientID  the ID of the patient attached to the monitor.
      */
-    public static void save(SensorType sensor, float sample, String unit, float timestamp,
+    public static void save(SensorType sensor, float sample, String unit, long timestamp,
                             String monitorId, String patientID)
     {
         TelemetryArchive.logger.log(Level.INFO, "Saving the sample into the database.");
         String insertSampleQuery = "INSERT INTO %s (sample_id, sample, unit, timestamp, patient_id, monitor_id) " +
-                                   "VALUES (NULL, %f, \"%s\", \"%s\", \"%s\", \"%s\");";
+                                   "VALUES (NULL, %f, \"%s\", %d, \"%s\", \"%s\");";
 
         try (Connection connection = DriverManager.getConnection(url, username, password);
              Statement statement = connection.createStatement()) {
@@ -103,4 +193,118 @@ public class TelemetryArchive {
             logger.log(Level.FINE, ExceptionUtils.getStackTrace(exception));
         }
     }
+
+    /**
+     * Returns the sequence number following the last alarm event of a monitor saved in the
+     * telemetry archive, so that a restarted collector does not fetch the saved events again.
+     * @param monitorId  the ID of the monitor.
+     * @return           the sequence number of the first alarm event not saved yet,
+     *                   0 if no event of the monitor was saved or the database is not reachable.
+     */
+    public static long getNextAlarmSequence(String monitorId) {
+        String selectSequenceQuery = "SELECT MAX(sequence) FROM alarm_event WHERE monitor_id = \"%s\";";
+
+        try (Connection connection = DriverManager.getConnection(url, username, password);
+             Statement statement = connection.createStatement();
+             ResultSet resultSet = statement.executeQuery(String.format(selectSequenceQuery, monitorId))) {
+            // MAX() is NULL if no event of the monitor was saved.
+            if (resultSet.next() && resultSet.getObject(1) != null)
+                return resultSet.getLong(1) + 1;
+        } catch (SQLException exception) {
+            logger.log(Level.INFO, "Error: failed to connect to the telemetry database.");
+            logger.log(Level.FINE, ExceptionUtils.getStackTrace(exception));
+        }
+        return 0;
+    }
+
+    /**
+     * Saves a transition of the alarm system of a monitor in the telemetry archive.
+     * @param sequence   the sequence number of the event assigned by the monitor.
+     * @param sensor     the type of sensor whose sample caused the transition,
+     *                   or null if the transition was not caused by a sample.
+     * @param value      the sample that caused the transition.
+     * @param alarm      the new state of the alarm system.
+     * @param timestamp  the timestamp of the event, in milliseconds since the epoch.
+     * @param monitorId  the ID of the monitor that produced the event.
+     * @param patientID  the ID of the patient attached to the monitor.
+     */
+    public static void saveAlarmEvent(long sequence, SensorType sensor, float value, boolean alarm,
+                                      long timestamp, String monitorId, String patientID)
+    {
+        TelemetryArchive.logger.log(Level.INFO, "Saving the alarm event into the database.");
+        String insertEventQuery = "INSERT INTO alarm_event (event_id, sequence, sensor, value, alarm, timestamp, patient_id, monitor_id) " +
+                                  "VALUES (NULL, %d, %s, %f, %b, %d, \"%s\", \"%s\");";
+        String sensorName = (sensor == null) ? "NULL" : "\"" + sensor.name().toLowerCase() + "\"";
+
+        try (Connection connection = DriverManager.getConnection(url, username, password);
+             Statement statement = connection.createStatement()) {
+            int insertedRows = statement.executeUpdate(String.format(Locale.US,
+                                                                     insertEventQuery,
+                                                                     sequence,
+                                                                     sensorName,
+                                                                     value,
+                                                                     alarm,
+                                                                     timestamp,
+                                                                     patientID,
+                                                                     monitorId));
+            if (insertedRows != 0)
+                TelemetryArchive.logger.log(Level.INFO, "Alarm event saved successfully.");
+            else
+                TelemetryArchive.logger.log(Level.INFO, "An error occurred while saving the alarm event.");
+        } catch (SQLException exception) {
+            logger.log(Level.INFO, "Error: failed to connect to the telemetry database.");
+            logger.log(Level.FINE, ExceptionUtils.getStackTrace(exception));
+        }
+    }
+
+    /**
+     * Saves a diagnostics report of a monitor in the telemetry archive.
+     * @param period              the length of the period covered by the report, in milliseconds.
+     * @param cpu                 the time spent by the CPU in active mode, in milliseconds.
+     * @param lpm                 the time spent by the CPU in low power mode, in milliseconds.
+     * @param radioTx             the time spent by the radio transmitting, in milliseconds.
+     * @param radioRx             the time spent by the radio listening, in milliseconds.
+     * @param queueHighWaterMark  the longest length reached by the output queue of the monitor.
+     * @param dropped             the messages discarded by the monitor without being sent.
+     * @param failures            the publications refused by the network stack of the monitor, indexed by
+     *                            status: 1 queue full, 2 not connected, 3 invalid arguments, 4 other errors.
+     * @param timestamp           the timestamp of the report, in milliseconds since the epoch.
+     * @param monitorId           the ID of the monitor that produced the report.
+     */
+    public static void saveDiagnostics(long period, long cpu, long lpm, long radioTx, long radioRx,
+                                       long queueHighWaterMark, long dropped, long[] failures,
+                                       long timestamp, String monitorId)
+    {
+        TelemetryArchive.logger.log(Level.INFO, "Saving the diagnostics report into the database.");
+        String insertDiagnosticsQuery = "INSERT INTO monitor_diagnostics (diagnostics_id, period, cpu, lpm, radio_tx, radio_rx, " +
+                                        "queue_high_water_mark, dropped, failures_queue_full, failures_not_connected, " +
+                                        "failures_invalid_args, failures_other, timestamp, monitor_id) " +
+                                        "VALUES (NULL, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d, \"%s\");";
+
+        try (Connection connection = DriverManager.getConnection(url, username, password);
+             Statement statement = connection.createStatement()) {
+            int insertedRows = statement.executeUpdate(String.format(Locale.US,
+                                                                     insertDiagnosticsQuery,
+                                                                     period,
+                                                                     cpu,
+                                                                     lpm,
+                                                                     radioTx,
+                                                                     radioRx,
+                                                                     queueHighWaterMark,
+                                                                     dropped,
+                                                                     failures[1],
+                                                                     failures[2],
+                                                                     failures[3],
+                                                                     failures[4],
+                                                                     timestamp,
+                                                                     monitorId));
+            if (insertedRows != 0)
+                TelemetryArchive.logger.log(Level.INFO, "Diagnostics report saved successfully.");
+            else
+                TelemetryArchive.logger.log(Level.INFO, "An error occurred while saving the diagnostics report.");
+        } catch (SQLException exception) {
+            logger.log(Level.INFO, "Error: failed to connect to the telemetry database.");
+            logger.log(Level.FINE, ExceptionUtils.getStackTrace(exception));
+        }
+    }
 }
@@ -0,0 +1,168 @@
+package it.unipi.smartICU.analytics;
+
+import it.unipi.smartICU.utils.SensorType;
+
+import java.util.StringJoiner;
+
+
+/**
+ * Class collecting the delivery statistics of the samples of a monitor, to benchmark
+ * the telemetry path. The losses are counted per sensor from the per-sensor sequence
+ * numbers of the samples, while the latency of each sample is split into hops:
+ * <ul>
+ *     <li>monitor: from the capture of the sample to the generation of the message carrying it,
+ *         measured with the clock of the monitor;</li>
+ *     <li>network: from the generation of the message to its arrival at the collector, broker
+ *         included. Until the monitor synchronizes its clock with the one of the collector, the
+ *         latency is measured relative to the fastest message received from the monitor since
+ *         its boot, whose network latency is taken as zero;</li>
+ *     <li>archive: from the arrival of the message to the storage of the sample in the database.</li>
+ * </ul>
+ * Each hop, and the whole path, is summarized by a histogram with power-of-two buckets in milliseconds.
+ */
+public class TelemetryStatistics {
+    private static final int HISTOGRAM_BUCKETS = 20;   // The last bucket holds the latencies of 2^18 ms or more.
+
+    /**
+     * Enumerator representing the hops of the path of a sample.
+     */
+    public enum Hop {
+        MONITOR,
+        NETWORK,
+        ARCHIVE,
+        END_TO_END
+    }
+
+    private final long[] firstSensorSequence;
+    private final long[] nextSensorSequence;
+    private final long[] receivedSamples;
+    private final long[][] histograms;
+    private long minimumOffset;
+    private long lastSentTime;
+
+    public TelemetryStatistics() {
+        int sensors = SensorType.values().length;
+
+        this.firstSensorSequence = new long[sensors];
+        this.nextSensorSequence = new long[sensors];
+        this.receivedSamples = new long[sensors];
+        this.histograms = new long[Hop.values().length][HISTOGRAM_BUCKETS];
+        this.minimumOffset = Long.MAX_VALUE;
+        this.lastSentTime = -1;
+
+        for (int sensor = 0; sensor < sensors; sensor++)
+            firstSensorSequence[sensor] = -1;
+    }
+
+    private static int getBucket(long milliseconds) {
+        int bucket = 0;
+
+        while (milliseconds > 0 && bucket < HISTOGRAM_BUCKETS - 1) {
+            milliseconds >>= 1;
+            bucket++;
+        }
+
+        return bucket;
+    }
+
+    /**
+     * Records the arrival of a message carrying samples, estimating its network latency.
+     * @param sentTime           the time at which the message was generated, in milliseconds.
+     * @param arrivalTime        the time of arrival of the message at the collector, in milliseconds since the epoch.
+     * @param synchronizedClock  true if the sent time is in milliseconds since the epoch, false if it is
+     *                           in milliseconds since the boot of the monitor.
+     * @return                   the network latency of the message, in milliseconds.
+     */
+    public synchronized long recordMessage(long sentTime, long arrivalTime, boolean synchronizedClock) {
+        long offset = arrivalTime - sentTime;
+
+        // A clock going backwards means that the monitor rebooted.
+        if (sentTime < lastSentTime)
+            minimumOffset = Long.MAX_VALUE;
+
+        lastSentTime = sentTime;
+        if (synchronizedClock)
+            return Math.max(offset, 0);
+
+        minimumOffset = Math.min(minimumOffset, offset);
+        return offset - minimumOffset;
+    }
+
+    /**
+     * Records a sample received from the monitor.
+     * @param sensor          the sensor that produced the sample.
+     * @param sensorSequence  the sequence number of the sample among the ones of the sensor.
+     */
+    public synchronized void recordSample(SensorType sensor, long sensorSequence) {
+        int index = sensor.ordinal();
+
+        // A sequence number going backwards means that the monitor rebooted.
+        if (firstSensorSequence[index] < 0 || sensorSequence < firstSensorSequence[index]) {
+            firstSensorSequence[index] = sensorSequence;
+            nextSensorSequence[index] = sensorSequence;
+            receivedSamples[index] = 0;
+        }
+
+        receivedSamples[index]++;
+        nextSensorSequence[index] = Math.max(nextSensorSequence[index], sensorSequence + 1);
+    }
+
+    /**
+     * Records the latency of a sample in a hop of its path.
+     * @param hop           the hop.
+     * @param milliseconds  the latency, in milliseconds.
+     */
+    public synchronized void recordLatency(Hop hop, long milliseconds) {
+        histograms[hop.ordinal()][getBucket(Math.max(milliseconds, 0))]++;
+    }
+
+    /**
+     * Gets the fraction of the samples of a sensor that were not received.
+     * @param sensor  the sensor.
+     * @return        the loss rate, between 0 and 1.
+     */
+    public synchronized double getLossRate(SensorType sensor) {
+        int index = sensor.ordinal();
+        long expectedSamples = nextSensorSequence[index] - firstSensorSequence[index];
+
+        if (firstSensorSequence[index] < 0 || expectedSamples <= 0)
+            return 0;
+
+        return Math.max(0, 1 - (double) receivedSamples[index] / expectedSamples);
+    }
+
+    /**
+     * Gets a textual summary of the statistics, one line per item, in the form
+     * <code>loss sensor=rate (received/expected)</code> and
+     * <code>hop bucket_upper_bound_ms:count ...</code>.
+     * @return  the summary of the statistics.
+     */
+    public synchronized String getSummary() {
+        StringJoiner summary = new StringJoiner(System.lineSeparator());
+
+        for (SensorType sensor : SensorType.values()) {
+            int index = sensor.ordinal();
+            if (firstSensorSequence[index] < 0)
+                continue;
+
+            summary.add(String.format("loss %s=%.4f (%d/%d)",
+                                      sensor.getKey(),
+                                      getLossRate(sensor),
+                                      receivedSamples[index],
+                                      nextSensorSequence[index] - firstSensorSequence[index]));
+        }
+
+        for (Hop hop : Hop.values()) {
+            StringJoiner histogram = new StringJoiner(" ", hop.name().toLowerCase() + " ", "");
+            for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++) {
+                if (histograms[hop.ordinal()][bucket] == 0)
+                    continue;
+                String upperBound = bucket == HISTOGRAM_BUCKETS - 1 ? "inf" : String.valueOf(1L << bucket);
+                histogram.add(upperBound + ":" + histograms[hop.ordinal()][bucket]);
+            }
+            summary.add(histogram.toString());
+        }
+
+        return summary.toString();
+    }
+}
@@ -0,0 +1,45 @@
+package it.unipi.smartICU.analytics;
+
+import it.unipi.smartICU.coap.CoapCollector;
+import it.unipi.smartICU.mqtt.MqttCollector;
+import it.unipi.smartICU.utils.DedicatedCollector;
+import it.unipi.smartICU.utils.VitalSignsMonitor;
+
+import java.util.logging.Level;
+import java.util.logging.Logger;
+
+/**
+ * Class implementing the periodic report of the telemetry statistics, logging
+ * for each registered monitor the loss rate of its samples per sensor and the
+ * histograms of their latency per hop (see {@link TelemetryStatistics}).
+ */
+public class TelemetryStatisticsReport implements Runnable {
+    private final Logger logger;
+    private final MqttCollector mqttCollector;
+    private final CoapCollector coapCollector;
+
+    /**
+     * Logs the telemetry statistics of the monitors registered to the given collector.
+     * @param collector  the collector holding the list of monitors.
+     */
+    private void report(DedicatedCollector collector) {
+        for (String monitorId : collector.getRegisteredMonitors().keySet()) {
+            VitalSignsMonitor monitor = collector.getRegisteredMonitors().get(monitorId);
+            logger.log(Level.INFO, String.format("Telemetry statistics of monitor %s:%n%s",
+                                                 monitorId,
+                                                 monitor.getTelemetryStatistics().getSummary()));
+        }
+    }
+
+    public TelemetryStatisticsReport(Logger logger, MqttCollector mqttCollector, CoapCollector coapCollector) {
+        this.logger = logger;
+        this.mqttCollector = mqttCollector;
+        this.coapCollector = coapCollector;
+    }
+
+    @Override
+    public void run() {
+        report(mqttCollector);
+        report(coapCollector);
+    }
+}
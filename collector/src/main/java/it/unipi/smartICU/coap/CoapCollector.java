@@ -1,23 +1,36 @@
 package it.unipi.smartICU.coap;
 
+import com.google.gson.Gson;
+import com.google.gson.JsonParseException;
+
+import it.unipi.smartICU.coap.resources.MonitorDataResource;
 import it.unipi.smartICU.coap.resources.RegisteredMonitorsResource;
+import it.unipi.smartICU.coap.resources.ResourceDirectoryResource;
 import it.unipi.smartICU.utils.Configuration;
 
 import it.unipi.smartICU.utils.DedicatedCollector;
+import it.unipi.smartICU.utils.MessageHandler;
+import it.unipi.smartICU.utils.MonitorProfile;
 import it.unipi.smartICU.utils.VitalSignsMonitor;
 import org.apache.commons.lang3.exception.ExceptionUtils;
 import org.eclipse.californium.core.CoapClient;
+import org.eclipse.californium.core.CoapHandler;
+import org.eclipse.californium.core.CoapResponse;
 import org.eclipse.californium.core.CoapServer;
+import org.eclipse.californium.core.coap.CoAP;
 import org.eclipse.californium.core.coap.MediaTypeRegistry;
+import org.eclipse.californium.core.coap.Request;
 import org.eclipse.californium.core.network.CoapEndpoint;
 
-import java.net.Inet4Address;
 import java.net.Inet6Address;
 import java.net.InetAddress;
 import java.net.InetSocketAddress;
 import java.net.UnknownHostException;
+import java.util.Collections;
 import java.util.HashMap;
 import java.util.Map;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.function.Consumer;
 import java.util.logging.Level;
 import java.util.logging.Logger;
 
@@ -26,12 +39,19 @@ import java.util.logging.Logger;
  * Class representing a CoAP collector for the smart ICU service.
  * It receives telemetry data from the smart ICU monitors, saving them in a database, and
  * sends commands to monitors to turn on their alarm systems, if requested by the patient
- * health deterioration service.
+ * health deterioration service. The monitors register to the resource directory hosted by
+ * the collector, advertising their resources: the collector observes only the ones it needs,
+ * i.e. the registered patient and, once a patient is attached to the monitor, the patient state.
+ * The alarm systems of all the monitors can be turned on at once with a multicast command.
  */
 public class CoapCollector extends CoapServer implements DedicatedCollector {
+    private static final String ALARM_GROUP_RESOURCE = "alarmGroup";
+    private static final String CONFIG_RESOURCE = "config";
     private final Logger logger;
     private final Configuration configuration;
     private final Map<String, VitalSignsMonitor> registeredMonitors;
+    private final Map<String, String> monitorIdsByAddress;
+    private final Map<String, MonitorRegistration> registrations;
     private final CoapClient alarmCommandsClient;
 
     /**
@@ -44,6 +64,8 @@ public class CoapCollector extends CoapServer implements DedicatedCollector {
         this.configuration = configuration;
         this.logger = logger;
         this.registeredMonitors = new HashMap<>();
+        this.monitorIdsByAddress = new HashMap<>();
+        this.registrations = new ConcurrentHashMap<>();
         this.alarmCommandsClient = new CoapClient();
     }
 
@@ -52,6 +74,82 @@ public class CoapCollector extends CoapServer implements DedicatedCollector {
         return registeredMonitors;
     }
 
+    /**
+     * Saves the address from which a registered monitor can be reached,
+     * so that the messages it pushes can be associated to it.
+     * @param monitorId  the ID of the monitor.
+     * @param ipAddress  the IP address of the monitor.
+     * @param port       the port of the monitor.
+     */
+    private void setMonitorAddress(String monitorId, String ipAddress, int port) {
+        registeredMonitors.get(monitorId).setIpAddress(ipAddress);
+        registeredMonitors.get(monitorId).setPort(port);
+        monitorIdsByAddress.put(ipAddress, monitorId);
+    }
+
+    /**
+     * Gets the ID of the registered monitor with the given IP address.
+     * @param ipAddress  the IP address of the monitor.
+     * @return           the ID of the monitor, or null if no monitor registered from the address.
+     */
+    public String getMonitorIdByAddress(String ipAddress) {
+        return monitorIdsByAddress.get(ipAddress);
+    }
+
+    /**
+     * Adds a monitor that registered to the resource directory, replacing the
+     * previous registration with the same endpoint name, if any. Unless the monitor
+     * pushes its data, the collector starts observing its registered patient resource.
+     * The diagnostics resource is observed in both modes.
+     * The configuration profile of the monitor, if any, is pushed to it, and the alarm
+     * transitions eventually missed while the monitor was disconnected are retrieved.
+     * @param registration  the registration of the monitor.
+     * @param ipAddress     the IP address of the monitor.
+     * @param port          the port of the monitor.
+     */
+    public void addMonitor(MonitorRegistration registration, String ipAddress, int port) {
+        String monitorId = registration.getMonitorId();
+        MessageHandler.registerMonitor(logger, registeredMonitors, monitorId);
+        setMonitorAddress(monitorId, ipAddress, port);
+
+        // The observe relations with a previous boot of the monitor are not valid anymore.
+        MonitorRegistration oldRegistration = registrations.put(monitorId, registration);
+        if (oldRegistration != null)
+            oldRegistration.cancelObserveRelations();
+
+        if (registration.getPushMode()) {
+            logger.log(Level.INFO, String.format("Monitor %s registered in push mode.", monitorId));
+        } else {
+            logger.log(Level.INFO, String.format("Establishing the observe relations with %s.", ipAddress));
+            observeRegisteredPatient(monitorId);
+        }
+        observeDiagnostics(monitorId);
+
+        MonitorProfile profile = configuration.getMonitorProfile(monitorId);
+        if (profile != null && registration.hasResource(CONFIG_RESOURCE))
+            pushProfile(profile, Collections.singletonList(monitorId));
+
+        if (registration.hasResource("patientState/alarmHistory"))
+            requestAlarmHistory(monitorId);
+    }
+
+    /**
+     * Removes a monitor whose registration to the resource directory expired
+     * or was deleted, closing the observe relations established with it.
+     * @param monitorId  the ID of the monitor.
+     */
+    public void removeMonitor(String monitorId) {
+        MonitorRegistration registration = registrations.remove(monitorId);
+        if (registration != null)
+            registration.cancelObserveRelations();
+
+        VitalSignsMonitor monitor = registeredMonitors.remove(monitorId);
+        if (monitor != null)
+            monitorIdsByAddress.remove(monitor.getIpAddress());
+
+        logger.log(Level.INFO, String.format("Removed the monitor with ID %s.", monitorId));
+    }
+
     @Override
     public void stop() {
         logger.log(Level.INFO, "Stopping the CoAP collector.");
@@ -64,34 +162,275 @@ public class CoapCollector extends CoapServer implements DedicatedCollector {
         addEndpoint(new CoapEndpoint(new InetSocketAddress(configuration.getCoapCollectorIpAddress(),
                                                            configuration.getCoapCollectorPort())));
         add(new RegisteredMonitorsResource("registeredMonitors", this, logger));
+        add(new ResourceDirectoryResource("rd", this, logger));
+        add(new MonitorDataResource("monitorData", this, logger));
         super.start();
     }
 
-    @Override
-    public void turnOnAlarm(String monitorId) {
-        String alarmMessage = "{\"alarm\": true}";
+    /**
+     * Builds the URI of a resource hosted by a registered monitor.
+     * @param monitorId  the ID of the monitor.
+     * @param resource   the path of the resource, query included.
+     * @return           the URI of the resource, or null if the address of the monitor is malformed.
+     */
+    private String getMonitorResourceURI(String monitorId, String resource) {
         InetAddress address;
 
         try {
             address = InetAddress.getByName(registeredMonitors.get(monitorId).getIpAddress());
         } catch (UnknownHostException exception) {
-            logger.log(Level.INFO, String.format("Impossible to issue the PUT: the address %s of the monitor is malformed.",
+            logger.log(Level.INFO, String.format("Impossible to issue the request: the address %s of the monitor is malformed.",
                                                  registeredMonitors.get(monitorId).getIpAddress()));
             logger.log(Level.FINE, ExceptionUtils.getStackTrace(exception));
-            return;
+            return null;
         }
 
-        if (address instanceof Inet4Address)
-            alarmCommandsClient.setURI(String.format("coap://%s:%s/patientState/alarmState",
-                                                     registeredMonitors.get(monitorId).getIpAddress(),
-                                                     registeredMonitors.get(monitorId).getPort()));
-        else if (address instanceof Inet6Address)
-            alarmCommandsClient.setURI(String.format("coap://[%s]:%s/patientState/alarmState",
-                                                     registeredMonitors.get(monitorId).getIpAddress(),
-                                                     registeredMonitors.get(monitorId).getPort()));
+        if (address instanceof Inet6Address)
+            return String.format("coap://[%s]:%s/%s",
+                                 registeredMonitors.get(monitorId).getIpAddress(),
+                                 registeredMonitors.get(monitorId).getPort(),
+                                 resource);
+
+        return String.format("coap://%s:%s/%s",
+                             registeredMonitors.get(monitorId).getIpAddress(),
+                             registeredMonitors.get(monitorId).getPort(),
+                             resource);
+    }
+
+    @Override
+    public void turnOnAlarm(String monitorId) {
+        String alarmMessage = "{\"alarm\": true}";
+        String uri = getMonitorResourceURI(monitorId, "patientState/alarmState");
+
+        if (uri == null)
+            return;
 
+        alarmCommandsClient.setURI(uri);
         logger.log(Level.INFO, String.format("Issuing a PUT to %s, with payload %s.", alarmCommandsClient.getURI(), alarmMessage));
         alarmCommandsClient.put(alarmMessage, MediaTypeRegistry.APPLICATION_JSON);;
         registeredMonitors.get(monitorId).setAlarm(true);
     }
+
+    /**
+     * Sends a command to turn on the alarm systems of all the registered monitors.
+     * A single NON request is sent to the multicast group joined by the monitors
+     * advertising the alarm group resource, which do not respond to it: their new
+     * alarm state is notified as usual. The other monitors, or all of them if no
+     * group address is configured, receive a unicast command each.
+     */
+    public void turnOnGroupAlarm() {
+        String alarmMessage = "{\"alarm\": true}";
+        String groupAddress = configuration.getCoapAlarmGroupAddress();
+
+        if (groupAddress != null) {
+            Request request = Request.newPut();
+            request.setURI(String.format("coap://[%s]:%d/%s", groupAddress, CoAP.DEFAULT_COAP_PORT, ALARM_GROUP_RESOURCE));
+            request.setType(CoAP.Type.NON);
+            request.setPayload(alarmMessage);
+            request.getOptions().setContentFormat(MediaTypeRegistry.APPLICATION_JSON);
+            logger.log(Level.INFO, String.format("Issuing a multicast PUT to %s, with payload %s.", request.getURI(), alarmMessage));
+            request.send();
+        }
+
+        for (String monitorId : registeredMonitors.keySet()) {
+            MonitorRegistration registration = registrations.get(monitorId);
+
+            if (groupAddress != null && registration != null && registration.hasResource(ALARM_GROUP_RESOURCE))
+                registeredMonitors.get(monitorId).setAlarm(true);
+            else
+                turnOnAlarm(monitorId);
+        }
+    }
+
+    @Override
+    public void sendConfiguration(String monitorId, String command) {
+        String uri = getMonitorResourceURI(monitorId, CONFIG_RESOURCE);
+
+        if (uri == null)
+            return;
+
+        CoapClient coapClient = new CoapClient(uri);
+        logger.log(Level.INFO, String.format("Issuing a POST to %s, with payload %s.", uri, command));
+        coapClient.post(new CoapHandler() {
+            @Override
+            public void onLoad(CoapResponse coapResponse) {
+                logger.log(Level.INFO, String.format("The monitor %s answered %s to the configuration command %s.",
+                                                     monitorId, coapResponse.getCode(), command));
+                coapClient.shutdown();
+            }
+
+            @Override
+            public void onError() {
+                logger.log(Level.INFO, String.format("An error occurred while issuing the POST of %s.", uri));
+                coapClient.shutdown();
+            }
+        }, command, MediaTypeRegistry.TEXT_PLAIN);
+    }
+
+    /**
+     * Parses and returns the JSON object contained in the given string.
+     * @param json  the string in JSON format.
+     * @return      the JSON object if the string is correctly formatted in JSON,
+     *              null otherwise.
+     */
+    private Map<String, Object> parseJson(String json) {
+        Map<String, Object> jsonObject = new HashMap<>();
+
+        try {
+            jsonObject = (Map<String, Object>) new Gson().fromJson(json, jsonObject.getClass());
+        } catch (JsonParseException exception) {
+            logger.log(Level.INFO, "Discarding the message: JSON parsing error.");
+            logger.log(Level.FINE, ExceptionUtils.getStackTrace(exception));
+            return null;
+        }
+
+        return jsonObject;
+    }
+
+    /**
+     * Establishes an observe relation with a resource advertised as observable by a
+     * registered monitor, passing the parsed JSON payload of each notification to the
+     * given handler. Nothing is done if the resource is already observed.
+     * @param monitorId  the ID of the monitor.
+     * @param resource   the path of the resource.
+     * @param handler    the handler of the parsed notifications.
+     */
+    private void observeMonitorResource(String monitorId, String resource, Consumer<Map<String, Object>> handler) {
+        MonitorRegistration registration = registrations.get(monitorId);
+        if (registration == null || !registration.isObservable(resource))
+            return;
+
+        String uri = getMonitorResourceURI(monitorId, resource);
+        if (uri == null)
+            return;
+
+        CoapClient coapClient = new CoapClient(uri);
+        if (!registration.addObserveRelation(resource, coapClient)) {
+            coapClient.shutdown();
+            return;
+        }
+
+        logger.log(Level.INFO, String.format("Observing %s.", uri));
+        coapClient.observe(new CoapHandler() {
+            @Override
+            public void onLoad(CoapResponse coapResponse) {
+                logger.log(Level.INFO, String.format("New observer GET of %s, with payload %s.",
+                                                     uri, coapResponse.getResponseText().trim()));
+
+                Map<String, Object> jsonObject = parseJson(coapResponse.getResponseText().trim());
+                if (jsonObject == null)
+                    return;
+
+                handler.accept(jsonObject);
+            }
+
+            @Override
+            public void onError() {
+                logger.log(Level.INFO,
+                           String.format("An error occurred while observing %s. Closing the observe relation.", uri));
+                registration.removeObserveRelation(resource);
+                coapClient.shutdown();
+            }
+        });
+    }
+
+    /**
+     * Observes the diagnostics resource of a monitor, which is notified with a new
+     * report every few minutes.
+     * @param monitorId  the ID of the monitor.
+     */
+    private void observeDiagnostics(String monitorId) {
+        observeMonitorResource(monitorId, "diagnostics", jsonObject ->
+            MessageHandler.handleDiagnostics(logger, registeredMonitors, monitorId, jsonObject));
+    }
+
+    /**
+     * Observes the registered patient resource of a monitor. Since the monitor produces
+     * samples only while a patient is attached to it, its patient state resource is
+     * observed as soon as a patient ID is received.
+     * @param monitorId  the ID of the monitor.
+     */
+    private void observeRegisteredPatient(String monitorId) {
+        observeMonitorResource(monitorId, "registeredPatient", jsonObject -> {
+            MessageHandler.handlePatientRegistration(logger, registeredMonitors, monitorId, jsonObject);
+
+            VitalSignsMonitor monitor = registeredMonitors.get(monitorId);
+            if (monitor != null && !monitor.getPatientId().isEmpty())
+                observePatientState(monitorId);
+        });
+    }
+
+    /**
+     * Observes the patient state resource of a monitor, which carries the samples of all
+     * the sensors and the alarm state. If the notifications reveal that some samples
+     * were lost, they are retrieved from the sample history of the monitor.
+     * @param monitorId  the ID of the monitor.
+     */
+    private void observePatientState(String monitorId) {
+        observeMonitorResource(monitorId, "patientState", jsonObject -> {
+            VitalSignsMonitor monitor = registeredMonitors.get(monitorId);
+            long expectedSequence = (monitor == null) ? -1 : monitor.getSampleHistorySequence();
+
+            long missedSamples = MessageHandler.handlePatientState(logger, registeredMonitors, monitorId, jsonObject);
+            if (missedSamples > 0)
+                requestSampleHistory(monitorId, expectedSequence, expectedSequence + missedSamples);
+        });
+    }
+
+    /**
+     * Issues a GET to a resource hosted by a registered monitor, passing the
+     * parsed JSON payload of the response to the given handler.
+     * @param uri      the URI of the resource.
+     * @param handler  the handler of the parsed response.
+     */
+    private void getMonitorResource(String uri, Consumer<Map<String, Object>> handler) {
+        CoapClient coapClient = new CoapClient(uri);
+        logger.log(Level.INFO, String.format("Issuing a GET to %s.", uri));
+        coapClient.get(new CoapHandler() {
+            @Override
+            public void onLoad(CoapResponse coapResponse) {
+                logger.log(Level.INFO, String.format("New response to the GET of %s, with payload %s.",
+                                                     uri, coapResponse.getResponseText().trim()));
+
+                Map<String, Object> jsonObject = parseJson(coapResponse.getResponseText().trim());
+                if (jsonObject != null)
+                    handler.accept(jsonObject);
+                coapClient.shutdown();
+            }
+
+            @Override
+            public void onError() {
+                logger.log(Level.INFO, String.format("An error occurred while issuing the GET of %s.", uri));
+                coapClient.shutdown();
+            }
+        });
+    }
+
+    @Override
+    public void requestAlarmHistory(String monitorId) {
+        String uri = getMonitorResourceURI(monitorId,
+                                           String.format("patientState/alarmHistory?since=%d",
+                                                         registeredMonitors.get(monitorId).getAlarmHistorySequence()));
+        if (uri == null)
+            return;
+
+        getMonitorResource(uri, jsonObject -> MessageHandler.handleAlarmHistory(logger, registeredMonitors,
+                                                                                monitorId, jsonObject));
+    }
+
+    /**
+     * Requests to a monitor the samples in a range of sequence numbers, which
+     * were missed by the collector, saving them in the telemetry database.
+     * @param monitorId  the ID of the monitor.
+     * @param since      the sequence number of the first missed sample.
+     * @param until      the sequence number following the last missed sample.
+     */
+    public void requestSampleHistory(String monitorId, long since, long until) {
+        String uri = getMonitorResourceURI(monitorId, String.format("patientState/history?since=%d", since));
+        if (uri == null)
+            return;
+
+        getMonitorResource(uri, jsonObject -> MessageHandler.handleSampleHistory(logger, registeredMonitors,
+                                                                                 monitorId, jsonObject, since, until));
+    }
 }
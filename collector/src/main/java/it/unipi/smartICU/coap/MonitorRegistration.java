@@ -0,0 +1,120 @@
+package it.unipi.smartICU.coap;
+
+import org.eclipse.californium.core.CoapClient;
+import org.eclipse.californium.core.WebLink;
+
+import java.util.HashMap;
+import java.util.HashSet;
+import java.util.Map;
+import java.util.Set;
+
+
+/**
+ * Class representing the registration of a CoAP monitor to the resource directory
+ * of the collector. It stores the resources advertised by the monitor in link format,
+ * the expiration time of the registration and the observe relations established
+ * with the monitor.
+ */
+public class MonitorRegistration {
+    private final String monitorId;
+    private final Set<String> resources;
+    private final Set<String> observableResources;
+    private final Map<String, CoapClient> observeRelations;
+    private boolean pushMode;
+    private long lifetime;
+    private long expirationTime;
+
+    /**
+     * Creates a new <code>MonitorRegistration</code>.
+     * @param monitorId  the ID of the monitor, i.e. its endpoint name.
+     * @param lifetime   the lifetime of the registration, in seconds.
+     */
+    public MonitorRegistration(String monitorId, long lifetime) {
+        this.monitorId = monitorId;
+        this.lifetime = lifetime;
+        this.resources = new HashSet<>();
+        this.observableResources = new HashSet<>();
+        this.observeRelations = new HashMap<>();
+        this.pushMode = false;
+        refresh();
+    }
+
+    public String getMonitorId() {
+        return monitorId;
+    }
+
+    public boolean getPushMode() {
+        return pushMode;
+    }
+
+    public void setPushMode(boolean pushMode) {
+        this.pushMode = pushMode;
+    }
+
+    /**
+     * Replaces the resources advertised by the monitor.
+     * @param links  the links of the resources, parsed from the link format payload of the registration.
+     */
+    public synchronized void setResources(Set<WebLink> links) {
+        resources.clear();
+        observableResources.clear();
+
+        // The paths of the links start with a slash, which is not part of the resource name.
+        for (WebLink link : links) {
+            String path = link.getURI().replaceFirst("^/", "");
+            resources.add(path);
+            if (link.getAttributes().containsAttribute("obs"))
+                observableResources.add(path);
+        }
+    }
+
+    public synchronized boolean hasResource(String path) {
+        return resources.contains(path);
+    }
+
+    public synchronized boolean isObservable(String path) {
+        return observableResources.contains(path);
+    }
+
+    public void setLifetime(long lifetime) {
+        this.lifetime = lifetime;
+    }
+
+    /**
+     * Extends the registration by its lifetime, starting from now.
+     */
+    public void refresh() {
+        expirationTime = System.currentTimeMillis() + lifetime * 1000;
+    }
+
+    public boolean isExpired() {
+        return System.currentTimeMillis() > expirationTime;
+    }
+
+    /**
+     * Saves the client observing a resource of the monitor.
+     * @param path        the path of the observed resource.
+     * @param coapClient  the client observing the resource.
+     * @return            true if the resource was not observed yet, false otherwise.
+     */
+    public synchronized boolean addObserveRelation(String path, CoapClient coapClient) {
+        if (observeRelations.containsKey(path))
+            return false;
+
+        observeRelations.put(path, coapClient);
+        return true;
+    }
+
+    public synchronized void removeObserveRelation(String path) {
+        observeRelations.remove(path);
+    }
+
+    /**
+     * Closes all the observe relations established with the monitor.
+     */
+    public synchronized void cancelObserveRelations() {
+        for (CoapClient coapClient : observeRelations.values())
+            coapClient.shutdown();
+        observeRelations.clear();
+    }
+}
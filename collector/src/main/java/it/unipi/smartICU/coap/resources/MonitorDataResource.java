@@ -0,0 +1,116 @@
+package it.unipi.smartICU.coap.resources;
+
+import com.google.gson.Gson;
+import com.google.gson.JsonParseException;
+
+import it.unipi.smartICU.coap.CoapCollector;
+import it.unipi.smartICU.utils.MessageHandler;
+import it.unipi.smartICU.utils.VitalSignsMonitor;
+
+import org.apache.commons.lang3.exception.ExceptionUtils;
+import org.eclipse.californium.core.CoapResource;
+import org.eclipse.californium.core.coap.CoAP;
+import org.eclipse.californium.core.server.resources.CoapExchange;
+
+import java.util.HashMap;
+import java.util.Map;
+import java.util.logging.Level;
+import java.util.logging.Logger;
+
+
+/**
+ * Class representing a CoAP resource receiving the data pushed by the monitors
+ * registered in push mode: batches of samples, alarm state changes and patient IDs.
+ * The batches of samples are sent as non-confirmable messages, which are not answered
+ * by the resource; the samples lost are retrieved from the sample history of the monitor.
+ */
+public class MonitorDataResource extends CoapResource {
+    private final Logger logger;
+    private final CoapCollector coapCollector;
+
+    /**
+     * Parses and returns the JSON object contained in the given string.
+     * @param json  the string in JSON format.
+     * @return      the JSON object if the string is correctly formatted in JSON,
+     *              null otherwise.
+     */
+    private Map<String, Object> parseJson(String json) {
+        Map<String, Object> jsonObject = new HashMap<>();
+
+        try {
+            jsonObject = (Map<String,Object>) new Gson().fromJson(json, jsonObject.getClass());
+        } catch (JsonParseException exception) {
+            logger.log(Level.INFO,"Discarding the message: JSON parsing error.");
+            logger.log(Level.FINE, ExceptionUtils.getStackTrace(exception));
+            return null;
+        }
+
+        return jsonObject;
+    }
+
+    /**
+     * Answers a request, unless it is non-confirmable and successful: the monitors
+     * do not wait for a response to their batches of samples.
+     * @param exchange  the request issued by the monitor.
+     * @param code      the response code.
+     */
+    private void respond(CoapExchange exchange, CoAP.ResponseCode code) {
+        if (exchange.advanced().getRequest().getType() == CoAP.Type.NON && CoAP.ResponseCode.isSuccess(code))
+            return;
+
+        exchange.respond(code);
+    }
+
+    /**
+     * Creates a new <code>MonitorDataResource</code>.
+     * @param name           the name with which the resource will be identified.
+     * @param coapCollector  the CoAP collector that hosts the resource.
+     * @param logger         the logger that will be used by the resource.
+     */
+    public MonitorDataResource(String name, CoapCollector coapCollector, Logger logger) {
+        super(name);
+        this.logger = logger;
+        this.coapCollector = coapCollector;
+    }
+
+    @Override
+    public void handlePOST(CoapExchange exchange) {
+        logger.log(Level.INFO,
+                   String.format("New POST from %s, with payload %s.",
+                                 exchange.getSourceAddress().getHostAddress(),
+                                 exchange.getRequestText().trim()));
+
+        String monitorId = coapCollector.getMonitorIdByAddress(exchange.getSourceAddress().getHostAddress());
+        if (monitorId == null) {
+            logger.log(Level.INFO, "Discarding the message: the monitor is not registered.");
+            respond(exchange, CoAP.ResponseCode.UNAUTHORIZED);
+            return;
+        }
+
+        Map<String, Object> jsonObject = parseJson(exchange.getRequestText().trim());
+        if (jsonObject == null) {
+            respond(exchange, CoAP.ResponseCode.BAD_REQUEST);
+            return;
+        }
+
+        if (jsonObject.containsKey("sampleHistory")) {
+            VitalSignsMonitor monitor = coapCollector.getRegisteredMonitors().get(monitorId);
+            long expectedSequence = monitor.getSampleHistorySequence();
+
+            long missedSamples = MessageHandler.handleSampleBatch(logger,
+                                                                  coapCollector.getRegisteredMonitors(),
+                                                                  monitorId,
+                                                                  jsonObject);
+            if (missedSamples > 0)
+                coapCollector.requestSampleHistory(monitorId, expectedSequence, expectedSequence + missedSamples);
+
+        } else if (jsonObject.containsKey("patientID")) {
+            MessageHandler.handlePatientRegistration(logger, coapCollector.getRegisteredMonitors(), monitorId, jsonObject);
+
+        } else {
+            MessageHandler.handleTelemetryAlarmState(logger, coapCollector.getRegisteredMonitors(), monitorId, jsonObject);
+        }
+
+        respond(exchange, CoAP.ResponseCode.CHANGED);
+    }
+}
@@ -0,0 +1,86 @@
+package it.unipi.smartICU.coap.resources;
+
+import it.unipi.smartICU.coap.MonitorRegistration;
+
+import org.eclipse.californium.core.CoapResource;
+import org.eclipse.californium.core.coap.CoAP;
+import org.eclipse.californium.core.coap.MediaTypeRegistry;
+import org.eclipse.californium.core.server.resources.CoapExchange;
+
+import java.util.Map;
+import java.util.logging.Level;
+import java.util.logging.Logger;
+
+
+/**
+ * Class representing the registration of a monitor to the resource directory
+ * of the CoAP collector. A POST without payload refreshes the lifetime of the
+ * registration, eventually changed by the lt query parameter, so that the monitor
+ * does not need to register again, and is answered with the time of the collector.
+ * A DELETE removes the registration.
+ */
+public class RegistrationResource extends CoapResource {
+    private final Logger logger;
+    private final String endpointName;
+    private final ResourceDirectoryResource resourceDirectory;
+    private volatile MonitorRegistration registration;
+
+    /**
+     * Creates a new <code>RegistrationResource</code>.
+     * @param name               the name with which the resource will be identified.
+     * @param endpointName       the endpoint name of the registered monitor.
+     * @param resourceDirectory  the resource directory that holds the registration.
+     * @param logger             the logger that will be used by the resource.
+     */
+    public RegistrationResource(String name, String endpointName, ResourceDirectoryResource resourceDirectory,
+                                Logger logger) {
+        super(name);
+        this.logger = logger;
+        this.endpointName = endpointName;
+        this.resourceDirectory = resourceDirectory;
+    }
+
+    public String getEndpointName() {
+        return endpointName;
+    }
+
+    public MonitorRegistration getRegistration() {
+        return registration;
+    }
+
+    public void setRegistration(MonitorRegistration registration) {
+        this.registration = registration;
+    }
+
+    @Override
+    public void handlePOST(CoapExchange exchange) {
+        logger.log(Level.INFO, String.format("New refresh of the registration of %s.", endpointName));
+
+        // An expired registration is not valid anymore, even if it has not been removed yet.
+        if (registration.isExpired()) {
+            resourceDirectory.removeRegistration(this);
+            exchange.respond(CoAP.ResponseCode.NOT_FOUND);
+            return;
+        }
+
+        Map<String, String> query = ResourceDirectoryResource.parseQuery(exchange.getRequestOptions().getUriQuery());
+        if (query.containsKey("lt")) {
+            long lifetime = ResourceDirectoryResource.parseLifetime(query.get("lt"));
+            if (lifetime < 0) {
+                exchange.respond(CoAP.ResponseCode.BAD_REQUEST);
+                return;
+            }
+            registration.setLifetime(lifetime);
+        }
+
+        registration.refresh();
+        exchange.respond(CoAP.ResponseCode.CHANGED, ResourceDirectoryResource.getTimePayload(), MediaTypeRegistry.APPLICATION_JSON);
+    }
+
+    @Override
+    public void handleDELETE(CoapExchange exchange) {
+        logger.log(Level.INFO, String.format("Removing the registration of %s upon request.", endpointName));
+        resourceDirectory.removeRegistration(this);
+        exchange.respond(CoAP.ResponseCode.DELETED);
+    }
+}
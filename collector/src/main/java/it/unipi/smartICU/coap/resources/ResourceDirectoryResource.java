@@ -0,0 +1,178 @@
+package it.unipi.smartICU.coap.resources;
+
+import it.unipi.smartICU.coap.CoapCollector;
+import it.unipi.smartICU.coap.MonitorRegistration;
+
+import org.eclipse.californium.core.CoapResource;
+import org.eclipse.californium.core.WebLink;
+import org.eclipse.californium.core.coap.CoAP;
+import org.eclipse.californium.core.coap.LinkFormat;
+import org.eclipse.californium.core.coap.MediaTypeRegistry;
+import org.eclipse.californium.core.server.resources.CoapExchange;
+
+import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Map;
+import java.util.Set;
+import java.util.concurrent.Executors;
+import java.util.concurrent.ScheduledExecutorService;
+import java.util.concurrent.TimeUnit;
+import java.util.logging.Level;
+import java.util.logging.Logger;
+
+
+/**
+ * Class representing the CoRE Resource Directory hosted by the CoAP collector.
+ * The monitors register with a POST carrying their endpoint name (ep) and the lifetime
+ * of the registration in seconds (lt) as query parameters, and the links of their resources
+ * in link format as payload. A monitor in push mode adds the query parameter mode=push.
+ * The directory creates a registration resource, whose location is returned to the monitor:
+ * a POST to the location refreshes the lifetime of the registration, a DELETE removes it.
+ * A monitor that registers again with the same endpoint name updates its registration.
+ * The registrations whose lifetime expired are periodically removed.
+ * The answers to the registrations and to their refreshes carry the time of the collector,
+ * so that the monitors timestamp their samples with absolute times.
+ */
+public class ResourceDirectoryResource extends CoapResource {
+    private static final long DEFAULT_LIFETIME = 90000;            // Lifetime of a registration that does not specify it, in seconds.
+    private static final long EXPIRATION_CHECK_INTERVAL = 60;      // Interval between two checks of the expired registrations, in seconds.
+    private final Logger logger;
+    private final CoapCollector coapCollector;
+    private final Map<String, RegistrationResource> registrations;
+    private final ScheduledExecutorService scheduler;
+    private int nextRegistrationId;
+
+    /**
+     * Parses the query parameters of a request.
+     * @param query  the query options of the request, in the form name=value.
+     * @return       the values of the parameters, indexed by name.
+     */
+    static Map<String, String> parseQuery(List<String> query) {
+        Map<String, String> parameters = new HashMap<>();
+
+        for (String parameter : query) {
+            int separator = parameter.indexOf('=');
+            if (separator < 0)
+                parameters.put(parameter, "");
+            else
+                parameters.put(parameter.substring(0, separator), parameter.substring(separator + 1));
+        }
+
+        return parameters;
+    }
+
+    /**
+     * Parses the lifetime of a registration.
+     * @param lifetime  the value of the lt query parameter.
+     * @return          the lifetime in seconds, or -1 if the value is not a valid lifetime.
+     */
+    static long parseLifetime(String lifetime) {
+        try {
+            long seconds = Long.parseLong(lifetime);
+            return seconds > 0 ? seconds : -1;
+        } catch (NumberFormatException exception) {
+            return -1;
+        }
+    }
+
+    /**
+     * Generates the payload carrying the current time of the collector.
+     * @return  the time in milliseconds since the epoch, in JSON format.
+     */
+    static String getTimePayload() {
+        return String.format("{\"time\": %d}", System.currentTimeMillis());
+    }
+
+    /**
+     * Creates a new <code>ResourceDirectoryResource</code>.
+     * @param name           the name with which the resource will be identified.
+     * @param coapCollector  the CoAP collector that hosts the resource.
+     * @param logger         the logger that will be used by the resource.
+     */
+    public ResourceDirectoryResource(String name, CoapCollector coapCollector, Logger logger) {
+        super(name);
+        this.logger = logger;
+        this.coapCollector = coapCollector;
+        this.registrations = new HashMap<>();
+        this.nextRegistrationId = 0;
+        this.scheduler = Executors.newSingleThreadScheduledExecutor();
+        this.scheduler.scheduleAtFixedRate(this::removeExpiredRegistrations,
+                                           EXPIRATION_CHECK_INTERVAL,
+                                           EXPIRATION_CHECK_INTERVAL,
+                                           TimeUnit.SECONDS);
+    }
+
+    /**
+     * Removes a registration from the directory, together with the registered monitor.
+     * @param registrationResource  the resource of the registration.
+     */
+    synchronized void removeRegistration(RegistrationResource registrationResource) {
+        if (registrations.get(registrationResource.getEndpointName()) != registrationResource)
+            return;
+
+        registrations.remove(registrationResource.getEndpointName());
+        registrationResource.delete();
+        coapCollector.removeMonitor(registrationResource.getEndpointName());
+    }
+
+    /**
+     * Removes the registrations whose lifetime expired.
+     */
+    private synchronized void removeExpiredRegistrations() {
+        for (RegistrationResource registrationResource : new ArrayList<>(registrations.values())) {
+            if (!registrationResource.getRegistration().isExpired())
+                continue;
+
+            logger.log(Level.INFO, String.format("The registration of %s expired.", registrationResource.getEndpointName()));
+            removeRegistration(registrationResource);
+        }
+    }
+
+    @Override
+    public void handlePOST(CoapExchange exchange) {
+        logger.log(Level.INFO,
+                   String.format("New registration from %s, with query %s and payload %s.",
+                                 exchange.getSourceAddress().getHostAddress(),
+                                 exchange.getRequestOptions().getUriQueryString(),
+                                 exchange.getRequestText().trim()));
+
+        Map<String, String> query = parseQuery(exchange.getRequestOptions().getUriQuery());
+        String endpointName = query.get("ep");
+        long lifetime = parseLifetime(query.getOrDefault("lt", String.valueOf(DEFAULT_LIFETIME)));
+
+        if (endpointName == null || endpointName.isEmpty() || lifetime < 0) {
+            logger.log(Level.INFO, "Discarding the registration: missing endpoint name or invalid lifetime.");
+            exchange.respond(CoAP.ResponseCode.BAD_REQUEST);
+            return;
+        }
+
+        if (exchange.getRequestOptions().getContentFormat() != MediaTypeRegistry.APPLICATION_LINK_FORMAT) {
+            logger.log(Level.INFO, "Discarding the registration: the payload is not in link format.");
+            exchange.respond(CoAP.ResponseCode.UNSUPPORTED_CONTENT_FORMAT);
+            return;
+        }
+
+        Set<WebLink> links = LinkFormat.parse(exchange.getRequestText());
+        MonitorRegistration registration = new MonitorRegistration(endpointName, lifetime);
+        registration.setResources(links);
+        registration.setPushMode("push".equals(query.get("mode")));
+
+        // A monitor registering again keeps the location of its registration.
+        RegistrationResource registrationResource;
+        synchronized (this) {
+            registrationResource = registrations.get(endpointName);
+            if (registrationResource == null) {
+                registrationResource = new RegistrationResource(String.valueOf(nextRegistrationId++), endpointName, this, logger);
+                registrations.put(endpointName, registrationResource);
+                add(registrationResource);
+            }
+            registrationResource.setRegistration(registration);
+        }
+
+        exchange.setLocationPath(getName() + "/" + registrationResource.getName());
+        exchange.respond(CoAP.ResponseCode.CREATED, getTimePayload(), MediaTypeRegistry.APPLICATION_JSON);
+
+        coapCollector.addMonitor(registration, exchange.getSourceAddress().getHostAddress(), exchange.getSourcePort());
+    }
+}
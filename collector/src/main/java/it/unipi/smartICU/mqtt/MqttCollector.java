@@ -6,20 +6,22 @@ import com.google.gson.JsonParseException;
 import it.unipi.smartICU.utils.Configuration;
 import it.unipi.smartICU.utils.DedicatedCollector;
 import it.unipi.smartICU.utils.MessageHandler;
+import it.unipi.smartICU.utils.MonitorProfile;
 import it.unipi.smartICU.utils.VitalSignsMonitor;
 
 import org.apache.commons.lang3.exception.ExceptionUtils;
 import org.eclipse.paho.client.mqttv3.IMqttDeliveryToken;
 import org.eclipse.paho.client.mqttv3.MqttCallback;
 import org.eclipse.paho.client.mqttv3.MqttClient;
+import org.eclipse.paho.client.mqttv3.MqttConnectOptions;
 import org.eclipse.paho.client.mqttv3.MqttException;
 import org.eclipse.paho.client.mqttv3.MqttMessage;
 
-import java.net.Inet4Address;
-import java.net.Inet6Address;
-import java.net.InetAddress;
 import java.net.UnknownHostException;
+import java.util.ArrayList;
+import java.util.Collections;
 import java.util.HashMap;
+import java.util.List;
 import java.util.Map;
 import java.util.logging.Level;
 import java.util.logging.Logger;
@@ -30,39 +32,33 @@ import java.util.logging.Logger;
  * It receives telemetry data from the smart ICU monitors, saving them in a database, and
  * sends commands to monitors to turn on their alarm systems, if requested by the patient
  * health deterioration service.
+ * At registration, each monitor is assigned a compact numeric handle, that it uses
+ * in place of its ID in the topics of the following messages (t/&lt;handle&gt;/&lt;kind&gt;).
+ * The handles and the last known state of the monitors are retained by the broker, so that
+ * a restarted collector recovers them as soon as it subscribes.
+ * The collector also sends its time to each monitor after the registration and then
+ * periodically, so that the monitors timestamp their samples with absolute times.
  */
 public class MqttCollector implements MqttCallback, DedicatedCollector {
     private final Logger logger;
     private final Configuration configuration;
     private MqttClient mqttClient;
     private final Map<String, VitalSignsMonitor> registeredMonitors;
+    private final List<VitalSignsMonitor> monitorsByHandle;
     private final String CLIENT_ID = "collector";
+    private long startTime;
 
     /**
      * Generates the URI of the broker using the available configuration.
      * @return  the URI of the broker.
      */
     private String generateBrokerURI() {
-        InetAddress address;
-
         try {
-            address = InetAddress.getByName(configuration.getMqttBrokerIpAddress());
+            return configuration.getMqttBrokerURI();
         } catch (UnknownHostException exception) {
             logger.log(Level.FINE, ExceptionUtils.getStackTrace(exception));
             return null;
         }
-
-        if (address instanceof Inet4Address)
-            return String.format("tcp://%s:%d",
-                                 configuration.getMqttBrokerIpAddress(),
-                                 configuration.getMqttBrokerPort());
-
-        if (address instanceof Inet6Address)
-            return String.format("tcp://[%s]:%d",
-                                 configuration.getMqttBrokerIpAddress(),
-                                 configuration.getMqttBrokerPort());
-
-        return null;
     }
 
     /**
@@ -74,6 +70,163 @@ public class MqttCollector implements MqttCallback, DedicatedCollector {
         this.logger = logger;
         this.configuration = configuration;
         this.registeredMonitors = new HashMap<>();
+        this.monitorsByHandle = new ArrayList<>();
+    }
+
+    /**
+     * Assigns a handle to a registered monitor. A monitor registering again
+     * keeps the handle assigned to it the first time.
+     * @param monitorId  the ID of the registered monitor.
+     * @return           the handle of the monitor.
+     */
+    private int assignHandle(String monitorId) {
+        VitalSignsMonitor monitor = registeredMonitors.get(monitorId);
+
+        if (monitor.getHandle() < 0) {
+            monitor.setHandle(monitorsByHandle.size());
+            monitorsByHandle.add(monitor);
+        } else {
+            // The registration replaced the object of the monitor.
+            monitorsByHandle.set(monitor.getHandle(), monitor);
+        }
+
+        return monitor.getHandle();
+    }
+
+    /**
+     * Returns the registered monitor to which the handle embedded in a short topic was assigned.
+     * @param topic  the short topic.
+     * @return       the registered monitor, or null if the handle was not assigned.
+     */
+    private VitalSignsMonitor getMonitorByHandle(String topic) {
+        int handle = Topic.getHandle(topic);
+
+        if (handle < 0 || handle >= monitorsByHandle.size())
+            return null;
+
+        return monitorsByHandle.get(handle);
+    }
+
+    /**
+     * Sends to a registered monitor the handle assigned to it.
+     * @param monitorId  the ID of the registered monitor.
+     * @param handle     the handle of the monitor.
+     */
+    private void sendHandle(String monitorId, int handle) {
+        String handleMessage = String.format("{\"handle\": %d}", handle);
+        String topic = String.format(Topic.MONITOR_HANDLE, monitorId);
+        MqttMessage mqttMessage = new MqttMessage(handleMessage.getBytes());
+
+        // The message is sent inside messageArrived(): see requestAlarmHistory().
+        mqttMessage.setQos(0);
+
+        // The handle is retained, so that a restarted collector can restore it (see restoreHandle()).
+        mqttMessage.setRetained(true);
+
+        try {
+            logger.log(Level.INFO, String.format("Publishing %s on topic %s.", handleMessage, topic));
+            this.mqttClient.publish(topic, mqttMessage);
+        } catch (MqttException mqttException) {
+            logger.log(Level.INFO, "Failed to send the message.");
+            logger.log(Level.FINE, ExceptionUtils.getStackTrace(mqttException));
+        }
+    }
+
+    /**
+     * Sends the current time of the collector to a registered monitor.
+     * @param monitorId  the ID of the registered monitor.
+     */
+    private void sendTime(String monitorId) {
+        String timeMessage = String.format("{\"time\": %d}", System.currentTimeMillis());
+        String topic = String.format(Topic.MONITOR_TIME, monitorId);
+        MqttMessage mqttMessage = new MqttMessage(timeMessage.getBytes());
+
+        // The message is sent inside messageArrived(): see requestAlarmHistory(). A stale time is useless, so it is not retained.
+        mqttMessage.setQos(0);
+
+        try {
+            logger.log(Level.FINE, String.format("Publishing %s on topic %s.", timeMessage, topic));
+            this.mqttClient.publish(topic, mqttMessage);
+        } catch (MqttException mqttException) {
+            logger.log(Level.INFO, "Failed to send the message.");
+            logger.log(Level.FINE, ExceptionUtils.getStackTrace(mqttException));
+        }
+    }
+
+    /**
+     * Sends the current time of the collector to all the registered monitors,
+     * correcting the drift of their clocks.
+     */
+    public void synchronizeTime() {
+        for (String monitorId : registeredMonitors.keySet())
+            sendTime(monitorId);
+    }
+
+    /**
+     * Restores the handle of a monitor from the retained message sent by a previous run
+     * of the collector, registering the monitor if needed. The handles sent by the current
+     * run are received too, and ignored.
+     * @param monitorId   the ID of the monitor.
+     * @param jsonObject  the parsed JSON message.
+     */
+    private void restoreHandle(String monitorId, Map<String, Object> jsonObject) {
+        if (!jsonObject.containsKey("handle")) {
+            logger.log(Level.INFO, "Discarding the message: bad format.");
+            return;
+        }
+
+        int handle = ((Double) jsonObject.get("handle")).intValue();
+
+        if (!registeredMonitors.containsKey(monitorId))
+            MessageHandler.registerMonitor(logger, registeredMonitors, monitorId);
+
+        VitalSignsMonitor monitor = registeredMonitors.get(monitorId);
+        if (monitor.getHandle() == handle)
+            return;
+
+        while (monitorsByHandle.size() <= handle)
+            monitorsByHandle.add(null);
+
+        if (monitorsByHandle.get(handle) != null) {
+            logger.log(Level.INFO, String.format("Discarding the handle %d of monitor %s: already assigned.", handle, monitorId));
+            return;
+        }
+
+        monitor.setHandle(handle);
+        monitorsByHandle.set(handle, monitor);
+        logger.log(Level.INFO, String.format("Restored the handle %d of monitor %s.", handle, monitorId));
+    }
+
+    /**
+     * Handles a message published by a monitor on a short topic, resolving
+     * the monitor through the handle embedded in the topic.
+     * @param topic       the short topic.
+     * @param jsonObject  the parsed JSON message.
+     */
+    private void handleShortMessage(String topic, Map<String, Object> jsonObject) {
+        VitalSignsMonitor monitor = getMonitorByHandle(topic);
+
+        if (monitor == null) {
+            logger.log(Level.INFO, String.format("Discarding the message: handle of topic %s not assigned.", topic));
+            return;
+        }
+
+        switch (Topic.getShortKind(topic)) {
+            case "b":
+                MessageHandler.handleSampleBatch(logger, monitor, jsonObject);
+                return;
+            case "as":
+                MessageHandler.handleTelemetryAlarmState(logger, monitor, jsonObject);
+                return;
+            case "ah":
+                MessageHandler.handleAlarmHistory(logger, monitor, jsonObject);
+                return;
+            case "p":
+                MessageHandler.handlePatientRegistration(logger, monitor, jsonObject);
+                return;
+            default:
+                logger.log(Level.INFO, "Discarding the message: unknown topic.");
+        }
     }
 
     @Override
@@ -99,19 +252,32 @@ public class MqttCollector implements MqttCallback, DedicatedCollector {
     public void start() {
         logger.log(Level.INFO, "Starting the MQTT collector.");
         String brokerURI = generateBrokerURI();
+        startTime = System.currentTimeMillis();
 
         try {
             logger.log(Level.INFO, String.format("Attempting to connect to the broker %s.", brokerURI));
             this.mqttClient = new MqttClient(brokerURI, CLIENT_ID);
             this.mqttClient.setCallback(this);
-            this.mqttClient.connect();
+
+            // The session is persistent, so that the broker keeps the subscriptions of the collector.
+            MqttConnectOptions connectOptions = new MqttConnectOptions();
+            connectOptions.setCleanSession(false);
+            this.mqttClient.connect(connectOptions);
             logger.log(Level.INFO, "Connected to the broker.");
 
             /*
-             * Subscribe to all the telemetry topics carrying patient data sent by monitors
-             * and to all the command topics carrying instructions for the collector.
+             * Subscribe to the retained handles and states of the monitors, which restore the
+             * registered monitors after a restart of the collector, to all the telemetry topics
+             * carrying patient data, batches of samples and diagnostics sent by monitors, to all the short topics
+             * used by the monitors after receiving their handle, and to all the command topics
+             * carrying instructions for the collector.
              */
+            this.mqttClient.subscribe(Topic.ALL_MONITOR_HANDLES);
+            this.mqttClient.subscribe(Topic.ALL_STATES_FROM_ALL_MONITORS);
             this.mqttClient.subscribe(Topic.ALL_PATIENT_STATES_FROM_ALL_MONITORS);
+            this.mqttClient.subscribe(Topic.ALL_BATCHES_FROM_ALL_MONITORS);
+            this.mqttClient.subscribe(Topic.ALL_DIAGNOSTICS_FROM_ALL_MONITORS);
+            this.mqttClient.subscribe(Topic.ALL_SHORT_TOPICS_FROM_ALL_MONITORS);
             this.mqttClient.subscribe(Topic.ALL_COMMANDS_TOWARDS_COLLECTOR);
         } catch (MqttException mqttException) {
             logger.log(Level.INFO, "Failed to connect to the broker.");
@@ -135,6 +301,44 @@ public class MqttCollector implements MqttCallback, DedicatedCollector {
         }
     }
 
+    @Override
+    public void requestAlarmHistory(String monitorId) {
+        String requestMessage = String.format("{\"since\": %d}", registeredMonitors.get(monitorId).getAlarmHistorySequence());
+        String topic = String.format(Topic.ALARM_HISTORY_REQUEST, monitorId);
+        MqttMessage mqttMessage = new MqttMessage(requestMessage.getBytes());
+
+        /*
+         * The request can be issued inside messageArrived(): QoS 0 avoids waiting for a delivery
+         * completion that would be notified by the same thread.
+         */
+        mqttMessage.setQos(0);
+
+        try {
+            logger.log(Level.INFO, String.format("Publishing %s on topic %s.", requestMessage, topic));
+            this.mqttClient.publish(topic, mqttMessage);
+        } catch (MqttException mqttException) {
+            logger.log(Level.INFO, "Failed to send the message.");
+            logger.log(Level.FINE, ExceptionUtils.getStackTrace(mqttException));
+        }
+    }
+
+    @Override
+    public void sendConfiguration(String monitorId, String command) {
+        String topic = String.format(Topic.MONITOR_CONFIG, monitorId);
+        MqttMessage mqttMessage = new MqttMessage(command.getBytes());
+
+        // The profile can be pushed inside messageArrived(): see requestAlarmHistory().
+        mqttMessage.setQos(0);
+
+        try {
+            logger.log(Level.INFO, String.format("Publishing %s on topic %s.", command, topic));
+            this.mqttClient.publish(topic, mqttMessage);
+        } catch (MqttException mqttException) {
+            logger.log(Level.INFO, "Failed to send the message.");
+            logger.log(Level.FINE, ExceptionUtils.getStackTrace(mqttException));
+        }
+    }
+
     @Override
     public void connectionLost(Throwable throwable) {
         logger.log(Level.INFO, "Lost the connection with the broker.");
@@ -157,7 +361,42 @@ public class MqttCollector implements MqttCallback, DedicatedCollector {
         }
 
         if (Topic.isCommand(topic) && Topic.isMonitorRegistration(topic)) {
-            MessageHandler.handleMonitorRegistration(logger, registeredMonitors, jsonObject);
+            String monitorId = MessageHandler.handleMonitorRegistration(logger, registeredMonitors, jsonObject);
+
+            /*
+             * Answer with the handle of the monitor, the time of the collector and the configuration
+             * profile of the monitor, if any, then retrieve the alarm transitions eventually missed
+             * while the monitor was disconnected.
+             */
+            if (monitorId != null) {
+                sendHandle(monitorId, assignHandle(monitorId));
+                sendTime(monitorId);
+                MonitorProfile profile = configuration.getMonitorProfile(monitorId);
+                if (profile != null)
+                    pushProfile(profile, Collections.singletonList(monitorId));
+                requestAlarmHistory(monitorId);
+            }
+            return;
+        }
+
+        if (Topic.isCommand(topic) && Topic.isHandle(topic)) {
+            restoreHandle(Topic.getCommandClientId(topic), jsonObject);
+            return;
+        }
+
+        if (Topic.isTelemetry(topic) && Topic.isState(topic)) {
+            String monitorId = Topic.getTelemetryClientId(topic);
+            boolean restored = MessageHandler.handleMonitorState(logger, registeredMonitors, monitorId, jsonObject);
+
+            // Measure the time needed by a starting collector to recover the state of the monitors.
+            if (restored && mqttMessage.isRetained())
+                logger.log(Level.INFO, String.format("Restored the state of monitor %s %d ms after the start.",
+                                                     monitorId, System.currentTimeMillis() - startTime));
+            return;
+        }
+
+        if (Topic.isShort(topic)) {
+            handleShortMessage(topic, jsonObject);
             return;
         }
 
@@ -172,6 +411,25 @@ public class MqttCollector implements MqttCallback, DedicatedCollector {
             return;
         }
 
+        if (Topic.isTelemetry(topic) && Topic.isAlarmHistory(topic)) {
+            String monitorId = Topic.getTelemetryClientId(topic);
+            MessageHandler.handleAlarmHistory(logger, registeredMonitors, monitorId, jsonObject);
+            return;
+        }
+
+        // The samples missed in the lost batches are only logged: MQTT monitors do not serve history requests.
+        if (Topic.isTelemetry(topic) && Topic.isBatch(topic)) {
+            String monitorId = Topic.getTelemetryClientId(topic);
+            MessageHandler.handleSampleBatch(logger, registeredMonitors, monitorId, jsonObject);
+            return;
+        }
+
+        if (Topic.isTelemetry(topic) && Topic.isDiagnostics(topic)) {
+            String monitorId = Topic.getTelemetryClientId(topic);
+            MessageHandler.handleDiagnostics(logger, registeredMonitors, monitorId, jsonObject);
+            return;
+        }
+
         if (Topic.isTelemetry(topic) && Topic.isSample(topic)) {
             String monitorId = Topic.getTelemetryClientId(topic);
             MessageHandler.handleSample(logger, registeredMonitors, monitorId, jsonObject);
@@ -5,8 +5,17 @@ package it.unipi.smartICU.mqtt;
  */
 class Topic {
     public static String ALL_PATIENT_STATES_FROM_ALL_MONITORS = "telemetry/smartICU/+/patient-state/+";
+    public static String ALL_BATCHES_FROM_ALL_MONITORS = "telemetry/smartICU/+/batch";
+    public static String ALL_STATES_FROM_ALL_MONITORS = "telemetry/smartICU/+/state";
+    public static String ALL_DIAGNOSTICS_FROM_ALL_MONITORS = "telemetry/smartICU/+/diagnostics";
+    public static String ALL_MONITOR_HANDLES = "cmd/smartICU/+/handle";
     public static String ALL_COMMANDS_TOWARDS_COLLECTOR = "cmd/smartICU/collector/+";
+    public static String ALL_SHORT_TOPICS_FROM_ALL_MONITORS = "t/+/+";
+    public static String MONITOR_HANDLE = "cmd/smartICU/%s/handle";
+    public static String MONITOR_TIME = "cmd/smartICU/%s/time";
+    public static String MONITOR_CONFIG = "cmd/smartICU/%s/config";
     public static String TURN_ON_ALARM = "cmd/smartICU/%s/patient-state/alarm-state";
+    public static String ALARM_HISTORY_REQUEST = "cmd/smartICU/%s/patient-state/alarm-history";
 
     /**
      * Checks if the given topic is a telemetry topic.
@@ -18,6 +27,44 @@ class Topic {
         return tokens[0].equals("telemetry");
     }
 
+    /**
+     * Checks if the given topic is a short topic, in the form t/&lt;handle&gt;/&lt;kind&gt;,
+     * used by the monitors after the collector assigned them a handle.
+     * @param topic  the topic.
+     * @return       true if the topic is a short topic, false otherwise.
+     */
+    public static boolean isShort(String topic) {
+        String[] tokens = topic.split("/");
+        return tokens.length == 3 && tokens[0].equals("t");
+    }
+
+    /**
+     * Parses and returns the handle embedded in the given short topic.
+     * @param topic  the topic.
+     * @return       the handle embedded in the short topic, or -1 if it is not a valid handle.
+     */
+    public static int getHandle(String topic) {
+        String[] tokens = topic.split("/");
+
+        try {
+            return Integer.parseInt(tokens[1]);
+        } catch (NumberFormatException exception) {
+            return -1;
+        }
+    }
+
+    /**
+     * Returns the kind of message carried by the given short topic: b for batches
+     * of samples, as for the alarm state, ah for the alarm history and p for
+     * the patient registration.
+     * @param topic  the topic.
+     * @return       the kind of message carried by the short topic.
+     */
+    public static String getShortKind(String topic) {
+        String[] tokens = topic.split("/");
+        return tokens[tokens.length - 1];
+    }
+
     /**
      * Checks if the given topic is a command topic.
      * @param topic  the topic.
@@ -44,6 +91,46 @@ class Topic {
                 || sensor.equals("oxygen-saturation");
     }
 
+    /**
+     * Checks if the given topic is a topic for batches of samples.
+     * @param topic  the topic.
+     * @return       true if the topic is a topic for batches of samples, false otherwise.
+     */
+    public static boolean isBatch(String topic) {
+        String[] tokens = topic.split("/");
+        return tokens[tokens.length - 1].equals("batch");
+    }
+
+    /**
+     * Checks if the given topic is a topic for the retained state of a monitor.
+     * @param topic  the topic.
+     * @return       true if the topic is a topic for the state of a monitor, false otherwise.
+     */
+    public static boolean isState(String topic) {
+        String[] tokens = topic.split("/");
+        return tokens[tokens.length - 1].equals("state");
+    }
+
+    /**
+     * Checks if the given topic is a topic for the diagnostics reports of a monitor.
+     * @param topic  the topic.
+     * @return       true if the topic is a topic for diagnostics reports, false otherwise.
+     */
+    public static boolean isDiagnostics(String topic) {
+        String[] tokens = topic.split("/");
+        return tokens[tokens.length - 1].equals("diagnostics");
+    }
+
+    /**
+     * Checks if the given topic is a topic for the handle assigned to a monitor.
+     * @param topic  the topic.
+     * @return       true if the topic is a topic for the handle of a monitor, false otherwise.
+     */
+    public static boolean isHandle(String topic) {
+        String[] tokens = topic.split("/");
+        return tokens[tokens.length - 1].equals("handle");
+    }
+
     /**
      * Checks if the given topic is a topic for alarm data.
      * @param topic  the topic.
@@ -54,6 +141,16 @@ class Topic {
         return tokens[tokens.length - 1].equals("alarm-state");
     }
 
+    /**
+     * Checks if the given topic is a topic for alarm history data.
+     * @param topic  the topic.
+     * @return       true if the topic is a topic for alarm history data, false otherwise.
+     */
+    public static boolean isAlarmHistory(String topic) {
+        String[] tokens = topic.split("/");
+        return tokens[tokens.length - 1].equals("alarm-history");
+    }
+
     /**
      * Checks if the given topic is a topic for patient registration data.
      * @param topic  the topic.
@@ -74,6 +171,16 @@ class Topic {
         return tokens[tokens.length - 1].equals("monitor-registration");
     }
 
+    /**
+     * Parses and returns the client ID embedded in the given command topic directed to a monitor.
+     * @param topic  the topic.
+     * @return       the client ID embedded in the command topic.
+     */
+    public static String getCommandClientId(String topic) {
+        String[] tokens = topic.split("/");
+        return tokens[2];
+    }
+
     /**
      * Parses and returns the client ID embedded in the given telemetry topic.
      * @param topic  the topic.
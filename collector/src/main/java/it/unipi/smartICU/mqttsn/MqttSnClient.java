@@ -0,0 +1,82 @@
+package it.unipi.smartICU.mqttsn;
+
+import java.net.InetSocketAddress;
+
+
+/**
+ * Class representing a client connected to the MQTT-SN gateway.
+ */
+class MqttSnClient {
+    private final String clientId;
+    private final InetSocketAddress address;
+    private final int keepAlive;
+    private final boolean cleanSession;
+    private boolean connected;
+    private int subscriptionQos;
+    private long lastActivity;
+
+    /**
+     * Creates a new <code>MqttSnClient</code>.
+     * @param clientId      the client ID.
+     * @param address       the address and port from which the client sends its packets.
+     * @param keepAlive     the keep-alive of the connection, in seconds.
+     * @param cleanSession  true if the subscriptions must not survive the connection.
+     */
+    MqttSnClient(String clientId, InetSocketAddress address, int keepAlive, boolean cleanSession) {
+        this.clientId = clientId;
+        this.address = address;
+        this.keepAlive = keepAlive;
+        this.cleanSession = cleanSession;
+        this.connected = true;
+        this.subscriptionQos = -1;
+        refresh();
+    }
+
+    String getClientId() {
+        return clientId;
+    }
+
+    InetSocketAddress getAddress() {
+        return address;
+    }
+
+    boolean getCleanSession() {
+        return cleanSession;
+    }
+
+    boolean isConnected() {
+        return connected;
+    }
+
+    void setConnected(boolean connected) {
+        this.connected = connected;
+    }
+
+    /**
+     * Gets the QoS with which the client subscribed to its commands.
+     * @return  the QoS of the subscription, or -1 if the client did not subscribe.
+     */
+    int getSubscriptionQos() {
+        return subscriptionQos;
+    }
+
+    void setSubscriptionQos(int subscriptionQos) {
+        this.subscriptionQos = subscriptionQos;
+    }
+
+    /**
+     * Records an activity of the client, which keeps the connection alive.
+     */
+    void refresh() {
+        lastActivity = System.currentTimeMillis();
+    }
+
+    /**
+     * Checks if the client is lost, i.e. if it did not send anything
+     * for one and a half times its keep-alive.
+     * @return  true if the client is lost, false otherwise.
+     */
+    boolean isLost() {
+        return keepAlive > 0 && System.currentTimeMillis() - lastActivity > keepAlive * 1500L;
+    }
+}
@@ -0,0 +1,444 @@
+package it.unipi.smartICU.mqttsn;
+
+import com.google.gson.JsonParseException;
+
+import it.unipi.smartICU.utils.Configuration;
+
+import org.apache.commons.cli.CommandLine;
+import org.apache.commons.cli.CommandLineParser;
+import org.apache.commons.cli.DefaultParser;
+import org.apache.commons.cli.HelpFormatter;
+import org.apache.commons.cli.Option;
+import org.apache.commons.cli.Options;
+import org.apache.commons.cli.ParseException;
+import org.apache.commons.lang3.exception.ExceptionUtils;
+import org.eclipse.paho.client.mqttv3.IMqttDeliveryToken;
+import org.eclipse.paho.client.mqttv3.MqttCallback;
+import org.eclipse.paho.client.mqttv3.MqttClient;
+import org.eclipse.paho.client.mqttv3.MqttConnectOptions;
+import org.eclipse.paho.client.mqttv3.MqttException;
+import org.eclipse.paho.client.mqttv3.MqttMessage;
+
+import java.io.IOException;
+import java.net.DatagramPacket;
+import java.net.DatagramSocket;
+import java.net.InetSocketAddress;
+import java.nio.ByteBuffer;
+import java.nio.charset.StandardCharsets;
+import java.util.Map;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.Executors;
+import java.util.concurrent.ScheduledExecutorService;
+import java.util.concurrent.TimeUnit;
+import java.util.logging.Level;
+import java.util.logging.LogManager;
+import java.util.logging.Logger;
+
+
+/**
+ * Class representing an aggregating MQTT-SN gateway for the smart ICU monitors built
+ * with the MQTT-SN transport. It runs as a separate process next to the MQTT broker and
+ * bridges the monitors, which send MQTT-SN packets over UDP, to the broker, using a single
+ * MQTT connection. Only predefined topic IDs are supported (see {@link PredefinedTopic}).
+ * The messages published by the monitors with QoS -1, 0 and 1 are published to the broker
+ * with QoS 0, 0 and 1; the commands for the monitors are delivered to them with QoS 0.
+ */
+public class MqttSnGateway implements MqttCallback {
+    private static final int MAX_PACKET_SIZE = 1024;
+    private static final int LIVENESS_CHECK_INTERVAL = 10;    // Interval between two checks of the lost clients, in seconds.
+    private static final int DEFAULT_PORT = 1884;
+    private final static String LOGGER_NAME = "it.unipi.smartICU.mqttsn";
+    private final static String LOGGER_PROPERTIES = "/logging.properties";
+    private final String CLIENT_ID = "mqtt-sn-gateway";
+    private final Logger logger;
+    private final Configuration configuration;
+    private final Map<InetSocketAddress, MqttSnClient> clients;
+    private final ScheduledExecutorService scheduler;
+    private MqttClient mqttClient;
+    private DatagramSocket socket;
+
+    /**
+     * Creates a new <code>MqttSnGateway</code>.
+     * @param configuration  the configuration holding the address of the broker and the port of the gateway.
+     * @param logger         the logger that will be used by the gateway.
+     */
+    public MqttSnGateway(Configuration configuration, Logger logger) {
+        this.logger = logger;
+        this.configuration = configuration;
+        this.clients = new ConcurrentHashMap<>();
+        this.scheduler = Executors.newSingleThreadScheduledExecutor();
+    }
+
+    /**
+     * Connects the gateway to the broker and starts receiving the packets of the clients.
+     * @return  true if the gateway started, false otherwise.
+     */
+    public boolean start() {
+        int port = configuration.getMqttSnGatewayPort() > 0 ? configuration.getMqttSnGatewayPort() : DEFAULT_PORT;
+
+        try {
+            String brokerURI = configuration.getMqttBrokerURI();
+            logger.log(Level.INFO, String.format("Attempting to connect to the broker %s.", brokerURI));
+            mqttClient = new MqttClient(brokerURI, CLIENT_ID);
+            mqttClient.setCallback(this);
+
+            // The session is persistent, so that the broker keeps the subscriptions of the clients.
+            MqttConnectOptions connectOptions = new MqttConnectOptions();
+            connectOptions.setCleanSession(false);
+            mqttClient.connect(connectOptions);
+            logger.log(Level.INFO, "Connected to the broker.");
+
+            socket = new DatagramSocket(port);
+            logger.log(Level.INFO, String.format("Listening for MQTT-SN clients on port %d.", port));
+        } catch (MqttException | IOException exception) {
+            logger.log(Level.INFO, "Failed to start the MQTT-SN gateway.");
+            logger.log(Level.FINE, ExceptionUtils.getStackTrace(exception));
+            return false;
+        }
+
+        scheduler.scheduleAtFixedRate(this::removeLostClients,
+                                      LIVENESS_CHECK_INTERVAL,
+                                      LIVENESS_CHECK_INTERVAL,
+                                      TimeUnit.SECONDS);
+        new Thread(this::receive, "mqtt-sn-receiver").start();
+        return true;
+    }
+
+    /**
+     * Receives the packets of the clients until the socket is closed.
+     */
+    private void receive() {
+        byte[] buffer = new byte[MAX_PACKET_SIZE];
+
+        while (!socket.isClosed()) {
+            DatagramPacket datagram = new DatagramPacket(buffer, buffer.length);
+
+            try {
+                socket.receive(datagram);
+            } catch (IOException exception) {
+                logger.log(Level.FINE, ExceptionUtils.getStackTrace(exception));
+                continue;
+            }
+
+            InetSocketAddress address = (InetSocketAddress) datagram.getSocketAddress();
+            MqttSnPacket packet = MqttSnPacket.parse(datagram.getData(), datagram.getLength());
+
+            if (packet == null) {
+                logger.log(Level.INFO, String.format("Discarding a malformed packet from %s.", address));
+                continue;
+            }
+
+            handlePacket(address, packet);
+        }
+    }
+
+    /**
+     * Handles a packet received from a client.
+     * @param address  the address and port of the client.
+     * @param packet   the parsed packet.
+     */
+    private void handlePacket(InetSocketAddress address, MqttSnPacket packet) {
+        MqttSnClient client = clients.get(address);
+
+        if (client != null)
+            client.refresh();
+
+        switch (packet.getType()) {
+            case MqttSnPacket.CONNECT:
+                handleConnect(address, packet.getBody());
+                return;
+            case MqttSnPacket.PUBLISH:
+                handlePublish(address, client, packet.getBody());
+                return;
+            case MqttSnPacket.SUBSCRIBE:
+                handleSubscribe(address, client, packet.getBody());
+                return;
+            case MqttSnPacket.PINGREQ:
+                send(address, MqttSnPacket.encode(MqttSnPacket.PINGRESP, new byte[0]));
+                return;
+            case MqttSnPacket.DISCONNECT:
+                if (client != null)
+                    disconnectClient(client);
+                send(address, MqttSnPacket.encode(MqttSnPacket.DISCONNECT, new byte[0]));
+                return;
+            case MqttSnPacket.PUBACK:
+                // The commands are delivered with QoS 0: nothing to acknowledge.
+                return;
+            default:
+                logger.log(Level.INFO, String.format("Discarding a packet of unsupported type 0x%02x from %s.",
+                                                     packet.getType(), address));
+        }
+    }
+
+    private void handleConnect(InetSocketAddress address, ByteBuffer body) {
+        if (body.remaining() < 4) {
+            logger.log(Level.INFO, String.format("Discarding a malformed CONNECT from %s.", address));
+            return;
+        }
+
+        int flags = body.get() & 0xFF;
+        body.get();                                 // Protocol ID.
+        int keepAlive = body.getShort() & 0xFFFF;
+        byte[] clientId = new byte[body.remaining()];
+        body.get(clientId);
+
+        MqttSnClient client = new MqttSnClient(new String(clientId, StandardCharsets.UTF_8),
+                                               address,
+                                               keepAlive,
+                                               (flags & MqttSnPacket.FLAG_CLEAN_SESSION) != 0);
+
+        // A client connecting again from the same address replaces its previous connection.
+        MqttSnClient oldClient = clients.put(address, client);
+        if (oldClient != null && oldClient.getCleanSession())
+            unsubscribe(oldClient);
+
+        // So does a client connecting again from another address or port, e.g. after a reboot.
+        for (Map.Entry<InetSocketAddress, MqttSnClient> entry : clients.entrySet()) {
+            MqttSnClient staleClient = entry.getValue();
+            if (entry.getKey().equals(address) || !staleClient.getClientId().equals(client.getClientId()))
+                continue;
+
+            if (clients.remove(entry.getKey(), staleClient)) {
+                logger.log(Level.INFO, String.format("Dropping the previous connection of %s from %s.",
+                                                     staleClient.getClientId(), entry.getKey()));
+                if (staleClient.getCleanSession())
+                    unsubscribe(staleClient);
+            }
+        }
+
+        logger.log(Level.INFO, String.format("New connection from %s (%s), keep-alive %d s.",
+                                             client.getClientId(), address, keepAlive));
+        send(address, MqttSnPacket.encode(MqttSnPacket.CONNACK, new byte[] { MqttSnPacket.RETURN_CODE_ACCEPTED }));
+    }
+
+    private void handlePublish(InetSocketAddress address, MqttSnClient client, ByteBuffer body) {
+        if (body.remaining() < 5) {
+            logger.log(Level.INFO, String.format("Discarding a malformed PUBLISH from %s.", address));
+            return;
+        }
+
+        int flags = body.get() & 0xFF;
+        int topicId = body.getShort() & 0xFFFF;
+        int messageId = body.getShort() & 0xFFFF;
+        byte[] payload = new byte[body.remaining()];
+        body.get(payload);
+
+        int qos = MqttSnPacket.getQos(flags);
+        PredefinedTopic predefinedTopic = PredefinedTopic.fromTopicId(topicId);
+
+        // QoS -1 messages can be sent without a connection, but the client must be known to expand the topic.
+        if (client == null || (qos >= 0 && !client.isConnected())) {
+            logger.log(Level.INFO, String.format("Discarding a PUBLISH from the unknown client %s.", address));
+            send(address, MqttSnPacket.encode(MqttSnPacket.DISCONNECT, new byte[0]));
+            return;
+        }
+
+        if ((flags & MqttSnPacket.FLAG_TOPIC_ID_TYPE) != MqttSnPacket.TOPIC_ID_TYPE_PREDEFINED || predefinedTopic == null) {
+            logger.log(Level.INFO, String.format("Discarding a PUBLISH from %s: invalid topic ID %d.",
+                                                 client.getClientId(), topicId));
+            if (qos == 1)
+                sendPuback(address, topicId, messageId, MqttSnPacket.RETURN_CODE_INVALID_TOPIC_ID);
+            return;
+        }
+
+        String topic = predefinedTopic.expand(client.getClientId());
+        MqttMessage mqttMessage = new MqttMessage(payload);
+        mqttMessage.setQos(Math.max(qos, 0));
+        mqttMessage.setRetained((flags & MqttSnPacket.FLAG_RETAIN) != 0);
+
+        try {
+            logger.log(Level.INFO, String.format("Forwarding a message of %s to the topic %s.", client.getClientId(), topic));
+            mqttClient.publish(topic, mqttMessage);
+        } catch (MqttException mqttException) {
+            logger.log(Level.INFO, "Failed to forward the message.");
+            logger.log(Level.FINE, ExceptionUtils.getStackTrace(mqttException));
+            return;
+        }
+
+        // The QoS 1 messages are acknowledged once delivered to the broker.
+        if (qos == 1)
+            sendPuback(address, topicId, messageId, MqttSnPacket.RETURN_CODE_ACCEPTED);
+    }
+
+    private void handleSubscribe(InetSocketAddress address, MqttSnClient client, ByteBuffer body) {
+        if (body.remaining() < 5) {
+            logger.log(Level.INFO, String.format("Discarding a malformed SUBSCRIBE from %s.", address));
+            return;
+        }
+
+        int flags = body.get() & 0xFF;
+        int messageId = body.getShort() & 0xFFFF;
+        int topicId = body.getShort() & 0xFFFF;
+        int qos = Math.min(Math.max(MqttSnPacket.getQos(flags), 0), 1);
+        int returnCode = MqttSnPacket.RETURN_CODE_ACCEPTED;
+
+        if (client == null || !client.isConnected()) {
+            send(address, MqttSnPacket.encode(MqttSnPacket.DISCONNECT, new byte[0]));
+            return;
+        }
+
+        // The clients can only subscribe to their own commands, which include the time and the configuration.
+        if ((flags & MqttSnPacket.FLAG_TOPIC_ID_TYPE) != MqttSnPacket.TOPIC_ID_TYPE_PREDEFINED
+                || topicId != PredefinedTopic.COMMANDS.getTopicId()) {
+            returnCode = MqttSnPacket.RETURN_CODE_INVALID_TOPIC_ID;
+        } else {
+            try {
+                mqttClient.subscribe(new String[] { PredefinedTopic.COMMANDS.expand(client.getClientId()),
+                                                    PredefinedTopic.CMD_TIME.expand(client.getClientId()),
+                                                    PredefinedTopic.CMD_CONFIG.expand(client.getClientId()) },
+                                     new int[] { qos, qos, qos });
+                client.setSubscriptionQos(qos);
+                logger.log(Level.INFO, String.format("Subscribed %s to its commands.", client.getClientId()));
+            } catch (MqttException mqttException) {
+                logger.log(Level.FINE, ExceptionUtils.getStackTrace(mqttException));
+                returnCode = MqttSnPacket.RETURN_CODE_NOT_SUPPORTED;
+            }
+        }
+
+        ByteBuffer suback = ByteBuffer.allocate(6);
+        suback.put((byte) MqttSnPacket.setQos(qos));
+        suback.putShort((short) topicId);
+        suback.putShort((short) messageId);
+        suback.put((byte) returnCode);
+        send(address, MqttSnPacket.encode(MqttSnPacket.SUBACK, suback.array()));
+    }
+
+    private void sendPuback(InetSocketAddress address, int topicId, int messageId, int returnCode) {
+        ByteBuffer puback = ByteBuffer.allocate(5);
+        puback.putShort((short) topicId);
+        puback.putShort((short) messageId);
+        puback.put((byte) returnCode);
+        send(address, MqttSnPacket.encode(MqttSnPacket.PUBACK, puback.array()));
+    }
+
+    private void send(InetSocketAddress address, byte[] packet) {
+        try {
+            socket.send(new DatagramPacket(packet, packet.length, address));
+        } catch (IOException exception) {
+            logger.log(Level.INFO, String.format("Failed to send a packet to %s.", address));
+            logger.log(Level.FINE, ExceptionUtils.getStackTrace(exception));
+        }
+    }
+
+    private void unsubscribe(MqttSnClient client) {
+        if (client.getSubscriptionQos() < 0)
+            return;
+
+        try {
+            mqttClient.unsubscribe(new String[] { PredefinedTopic.COMMANDS.expand(client.getClientId()),
+                                                  PredefinedTopic.CMD_TIME.expand(client.getClientId()),
+                                                  PredefinedTopic.CMD_CONFIG.expand(client.getClientId()) });
+        } catch (MqttException mqttException) {
+            logger.log(Level.FINE, ExceptionUtils.getStackTrace(mqttException));
+        }
+    }
+
+    /**
+     * Closes the connection of a client. The client stays known to the gateway,
+     * so that it can keep publishing with QoS -1.
+     * @param client  the client.
+     */
+    private void disconnectClient(MqttSnClient client) {
+        client.setConnected(false);
+        if (client.getCleanSession())
+            unsubscribe(client);
+    }
+
+    /**
+     * Closes the connections of the clients that did not send anything for too long.
+     */
+    private void removeLostClients() {
+        for (MqttSnClient client : clients.values()) {
+            if (!client.isConnected() || !client.isLost())
+                continue;
+
+            logger.log(Level.INFO, String.format("Lost the connection with %s.", client.getClientId()));
+            disconnectClient(client);
+        }
+    }
+
+    @Override
+    public void messageArrived(String topic, MqttMessage mqttMessage) {
+        for (MqttSnClient client : clients.values()) {
+            PredefinedTopic predefinedTopic = PredefinedTopic.fromCommandTopic(topic, client.getClientId());
+            if (predefinedTopic == null || !client.isConnected())
+                continue;
+
+            byte[] payload = mqttMessage.getPayload();
+            ByteBuffer publish = ByteBuffer.allocate(5 + payload.length);
+            publish.put((byte) (MqttSnPacket.setQos(0) | MqttSnPacket.TOPIC_ID_TYPE_PREDEFINED));
+            publish.putShort((short) predefinedTopic.getTopicId());
+            publish.putShort((short) 0);
+            publish.put(payload);
+
+            logger.log(Level.INFO, String.format("Forwarding a message of the topic %s to %s.", topic, client.getClientId()));
+            send(client.getAddress(), MqttSnPacket.encode(MqttSnPacket.PUBLISH, publish.array()));
+        }
+    }
+
+    @Override
+    public void connectionLost(Throwable throwable) {
+        logger.log(Level.INFO, "Lost the connection with the broker.");
+        stop();
+    }
+
+    @Override
+    public void deliveryComplete(IMqttDeliveryToken iMqttDeliveryToken) {
+    }
+
+    /**
+     * Stops the gateway, closing the socket and the connection with the broker.
+     */
+    public void stop() {
+        logger.log(Level.INFO, "Stopping the MQTT-SN gateway.");
+        scheduler.shutdown();
+        if (socket != null)
+            socket.close();
+
+        try {
+            if (mqttClient != null)
+                mqttClient.close(true);
+        } catch (MqttException mqttException) {
+            logger.log(Level.FINE, ExceptionUtils.getStackTrace(mqttException));
+        }
+    }
+
+    /**
+     * Starts the execution of the gateway.
+     * The path of the configuration file of the collector must be specified as argument
+     * when invoking the <code>main()</code> method from the command line.
+     * @throws IOException         if an I/O error occurs while accessing the configuration file.
+     * @throws JsonParseException  if the configuration file contains an invalid JSON syntax.
+     */
+    public static void main(String[] args) throws IOException {
+        CommandLineParser parser = new DefaultParser();
+        HelpFormatter formatter = new HelpFormatter();
+        CommandLine cmd;
+        Options options = new Options();
+
+        Option configurationOption = new Option("c", "configuration", true, "Configuration file path");
+        configurationOption.setRequired(true);
+        options.addOption(configurationOption);
+
+        try {
+            cmd = parser.parse(options, args);
+        } catch (ParseException exception) {
+            System.out.println(exception.getMessage());
+            formatter.printHelp("smartICU MQTT-SN gateway", options);
+            return;
+        }
+
+        // A failure in the loading of the logger properties does not prevent the execution of the gateway.
+        Logger logger = Logger.getLogger(LOGGER_NAME);
+        try {
+            LogManager.getLogManager().readConfiguration(MqttSnGateway.class.getResourceAsStream(LOGGER_PROPERTIES));
+        } catch (IOException exception) {
+            logger.log(Level.INFO, "Failed to load the logger configuration.");
+        }
+
+        Configuration configuration = new Configuration(cmd.getOptionValue("configuration"));
+        MqttSnGateway gateway = new MqttSnGateway(configuration, logger);
+        if (!gateway.start())
+            gateway.stop();
+    }
+}
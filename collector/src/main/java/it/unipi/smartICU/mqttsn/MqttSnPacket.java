@@ -0,0 +1,119 @@
+package it.unipi.smartICU.mqttsn;
+
+import java.nio.ByteBuffer;
+
+
+/**
+ * Encoding and decoding of the MQTT-SN v1.2 packets handled by the gateway.
+ */
+class MqttSnPacket {
+    static final int CONNECT = 0x04;
+    static final int CONNACK = 0x05;
+    static final int PUBLISH = 0x0C;
+    static final int PUBACK = 0x0D;
+    static final int SUBSCRIBE = 0x12;
+    static final int SUBACK = 0x13;
+    static final int PINGREQ = 0x16;
+    static final int PINGRESP = 0x17;
+    static final int DISCONNECT = 0x18;
+
+    static final int FLAG_RETAIN = 0x10;
+    static final int FLAG_CLEAN_SESSION = 0x04;
+    static final int FLAG_TOPIC_ID_TYPE = 0x03;
+    static final int TOPIC_ID_TYPE_PREDEFINED = 0x01;
+
+    static final int RETURN_CODE_ACCEPTED = 0x00;
+    static final int RETURN_CODE_INVALID_TOPIC_ID = 0x02;
+    static final int RETURN_CODE_NOT_SUPPORTED = 0x03;
+
+    private final int type;
+    private final ByteBuffer body;
+
+    private MqttSnPacket(int type, ByteBuffer body) {
+        this.type = type;
+        this.body = body;
+    }
+
+    /**
+     * Parses a packet.
+     * @param data    the received bytes.
+     * @param length  the number of received bytes.
+     * @return        the packet, or null if it is malformed.
+     */
+    static MqttSnPacket parse(byte[] data, int length) {
+        int packetLength;
+        int offset;
+
+        if (length < 2)
+            return null;
+
+        // Packets longer than 255 bytes encode their length in three bytes.
+        if ((data[0] & 0xFF) == 0x01) {
+            if (length < 4)
+                return null;
+            packetLength = ((data[1] & 0xFF) << 8) | (data[2] & 0xFF);
+            offset = 3;
+        } else {
+            packetLength = data[0] & 0xFF;
+            offset = 1;
+        }
+
+        if (packetLength > length || packetLength <= offset)
+            return null;
+
+        return new MqttSnPacket(data[offset] & 0xFF, ByteBuffer.wrap(data, offset + 1, packetLength - offset - 1).slice());
+    }
+
+    /**
+     * Encodes a packet.
+     * @param type  the message type.
+     * @param body  the packet following the header.
+     * @return      the encoded packet.
+     */
+    static byte[] encode(int type, byte[] body) {
+        int headerLength = body.length + 2 <= 0xFF ? 2 : 4;
+        ByteBuffer packet = ByteBuffer.allocate(headerLength + body.length);
+
+        if (headerLength == 2) {
+            packet.put((byte) (body.length + 2));
+        } else {
+            packet.put((byte) 0x01);
+            packet.putShort((short) (body.length + 4));
+        }
+
+        packet.put((byte) type);
+        packet.put(body);
+        return packet.array();
+    }
+
+    /**
+     * Returns the QoS encoded in the flags of a packet.
+     * @param flags  the flags.
+     * @return       the QoS: -1, 0, 1 or 2.
+     */
+    static int getQos(int flags) {
+        int qos = (flags & 0x60) >> 5;
+        return qos == 3 ? -1 : qos;
+    }
+
+    /**
+     * Encodes a QoS in the flags of a packet.
+     * @param qos  the QoS: -1, 0, 1 or 2.
+     * @return     the flags with the QoS set.
+     */
+    static int setQos(int qos) {
+        return (qos < 0 ? 3 : qos) << 5;
+    }
+
+    int getType() {
+        return type;
+    }
+
+    /**
+     * Returns the packet following the header, read from the start.
+     * @return  the body of the packet.
+     */
+    ByteBuffer getBody() {
+        return body.duplicate();
+    }
+}
@@ -0,0 +1,72 @@
+package it.unipi.smartICU.mqttsn;
+
+/**
+ * Predefined MQTT-SN topic IDs, known in advance by the monitors and the gateway
+ * (see <code>mqtt-monitor-constants.h</code>). The gateway expands the topics that
+ * embed the monitor ID with the client ID of the monitor.
+ */
+enum PredefinedTopic {
+    MONITOR_REGISTRATION(1, "cmd/smartICU/collector/monitor-registration"),
+    PATIENT_REGISTRATION(2, "cmd/smartICU/collector/patient-registration"),
+    BATCH(3, "telemetry/smartICU/%s/batch"),
+    ALARM_STATE(4, "telemetry/smartICU/%s/patient-state/alarm-state"),
+    ALARM_HISTORY(5, "telemetry/smartICU/%s/patient-state/alarm-history"),
+    STATE(6, "telemetry/smartICU/%s/state"),
+    DIAGNOSTICS(7, "telemetry/smartICU/%s/diagnostics"),
+    COMMANDS(16, "cmd/smartICU/%s/patient-state/+"),
+    CMD_ALARM_STATE(17, "cmd/smartICU/%s/patient-state/alarm-state"),
+    CMD_ALARM_HISTORY(18, "cmd/smartICU/%s/patient-state/alarm-history"),
+    CMD_TIME(19, "cmd/smartICU/%s/time"),
+    CMD_CONFIG(20, "cmd/smartICU/%s/config");
+
+    private final int topicId;
+    private final String topic;
+
+    PredefinedTopic(int topicId, String topic) {
+        this.topicId = topicId;
+        this.topic = topic;
+    }
+
+    public int getTopicId() {
+        return topicId;
+    }
+
+    /**
+     * Returns the MQTT topic corresponding to the predefined topic for a client.
+     * @param clientId  the client ID of the monitor.
+     * @return          the MQTT topic.
+     */
+    public String expand(String clientId) {
+        return String.format(topic, clientId);
+    }
+
+    /**
+     * Returns the predefined topic with the given ID.
+     * @param topicId  the predefined topic ID.
+     * @return         the predefined topic, or null if the ID is not known.
+     */
+    public static PredefinedTopic fromTopicId(int topicId) {
+        for (PredefinedTopic predefinedTopic : values())
+            if (predefinedTopic.topicId == topicId)
+                return predefinedTopic;
+        return null;
+    }
+
+    /**
+     * Returns the predefined topic of a command sent to a client.
+     * @param topic     the MQTT topic of the command.
+     * @param clientId  the client ID of the monitor.
+     * @return          the predefined topic, or null if the command has no predefined topic.
+     */
+    public static PredefinedTopic fromCommandTopic(String topic, String clientId) {
+        if (topic.equals(CMD_ALARM_STATE.expand(clientId)))
+            return CMD_ALARM_STATE;
+        if (topic.equals(CMD_ALARM_HISTORY.expand(clientId)))
+            return CMD_ALARM_HISTORY;
+        if (topic.equals(CMD_TIME.expand(clientId)))
+            return CMD_TIME;
+        if (topic.equals(CMD_CONFIG.expand(clientId)))
+            return CMD_CONFIG;
+        return null;
+    }
+}
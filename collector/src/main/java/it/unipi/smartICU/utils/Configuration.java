@@ -7,6 +7,12 @@ import com.google.gson.JsonParseException;
 import java.io.BufferedReader;
 import java.io.FileReader;
 import java.io.IOException;
+import java.net.Inet4Address;
+import java.net.Inet6Address;
+import java.net.InetAddress;
+import java.net.UnknownHostException;
+import java.util.Collections;
+import java.util.List;
 
 
 /**
@@ -17,14 +23,19 @@ public class Configuration {
     private final String filePath;
     private String mqttBrokerIpAddress;
     private int mqttBrokerPort;
+    private int mqttSnGatewayPort;
     private String coapCollectorIpAddress;
     private int coapCollectorPort;
+    private String coapAlarmGroupAddress;
     private String telemetryArchiveIpAddress;
     private int telemetryArchivePort;
     private String telemetryArchiveUser;
     private String telemetryArchivePassword;
     private String telemetryArchiveDatabaseName;
     private int patientHealthDeteriorationSchedulingRate;
+    private int telemetryStatisticsReportRate;
+    private int timeSynchronizationRate;
+    private List<MonitorProfile> monitorProfiles;
 
     /**
      * Parses the JSON configuration file.
@@ -37,14 +48,19 @@ public class Configuration {
 
         this.mqttBrokerIpAddress = parsedConfiguration.mqttBrokerIpAddress;
         this.mqttBrokerPort = parsedConfiguration.mqttBrokerPort;
+        this.mqttSnGatewayPort = parsedConfiguration.mqttSnGatewayPort;
         this.coapCollectorIpAddress = parsedConfiguration.coapCollectorIpAddress;
         this.coapCollectorPort = parsedConfiguration.coapCollectorPort;
+        this.coapAlarmGroupAddress = parsedConfiguration.coapAlarmGroupAddress;
         this.telemetryArchiveIpAddress = parsedConfiguration.telemetryArchiveIpAddress;
         this.telemetryArchivePort = parsedConfiguration.telemetryArchivePort;
         this.telemetryArchiveUser = parsedConfiguration.telemetryArchiveUser;
         this.telemetryArchivePassword = parsedConfiguration.telemetryArchivePassword;
         this.telemetryArchiveDatabaseName = parsedConfiguration.telemetryArchiveDatabaseName;
         this.patientHealthDeteriorationSchedulingRate = parsedConfiguration.patientHealthDeteriorationSchedulingRate;
+        this.telemetryStatisticsReportRate = parsedConfiguration.telemetryStatisticsReportRate;
+        this.timeSynchronizationRate = parsedConfiguration.timeSynchronizationRate;
+        this.monitorProfiles = parsedConfiguration.monitorProfiles;
 
         reader.close();
     }
@@ -72,6 +88,27 @@ public class Configuration {
         return mqttBrokerPort;
     }
 
+    public int getMqttSnGatewayPort() {
+        return mqttSnGatewayPort;
+    }
+
+    /**
+     * Generates the URI of the MQTT broker.
+     * @return                       the URI of the broker, or null if the address is neither IPv4 nor IPv6.
+     * @throws UnknownHostException  if the address of the broker cannot be resolved.
+     */
+    public String getMqttBrokerURI() throws UnknownHostException {
+        InetAddress address = InetAddress.getByName(mqttBrokerIpAddress);
+
+        if (address instanceof Inet4Address)
+            return String.format("tcp://%s:%d", mqttBrokerIpAddress, mqttBrokerPort);
+
+        if (address instanceof Inet6Address)
+            return String.format("tcp://[%s]:%d", mqttBrokerIpAddress, mqttBrokerPort);
+
+        return null;
+    }
+
     public String getCoapCollectorIpAddress() {
         return coapCollectorIpAddress;
     }
@@ -80,6 +117,10 @@ public class Configuration {
         return coapCollectorPort;
     }
 
+    public String getCoapAlarmGroupAddress() {
+        return coapAlarmGroupAddress;
+    }
+
     public String getTelemetryArchiveIpAddress() {
         return telemetryArchiveIpAddress;
     }
@@ -104,6 +145,31 @@ public class Configuration {
         return patientHealthDeteriorationSchedulingRate;
     }
 
+    public int getTelemetryStatisticsReportRate() {
+        return telemetryStatisticsReportRate;
+    }
+
+    public int getTimeSynchronizationRate() {
+        return timeSynchronizationRate;
+    }
+
+    public List<MonitorProfile> getMonitorProfiles() {
+        return monitorProfiles == null ? Collections.emptyList() : monitorProfiles;
+    }
+
+    /**
+     * Gets the configuration profile to be pushed to a monitor when it registers.
+     * @param monitorId  the ID of the monitor.
+     * @return           the first profile listing the monitor, or null if there is none.
+     */
+    public MonitorProfile getMonitorProfile(String monitorId) {
+        for (MonitorProfile profile : getMonitorProfiles())
+            if (profile.getMonitors().contains(monitorId))
+                return profile;
+
+        return null;
+    }
+
     @Override
     public String toString() {
         return new GsonBuilder().setPrettyPrinting().create().toJson(this);
@@ -1,5 +1,6 @@
 package it.unipi.smartICU.utils;
 
+import java.util.Collection;
 import java.util.Map;
 
 /**
@@ -28,4 +29,36 @@ public interface DedicatedCollector {
      * @param monitorId  the monitor to which the command must be sent.
      */
     void turnOnAlarm(String monitorId);
+
+    /**
+     * Sends a request to retrieve the alarm events of a monitor that have not
+     * been received yet, i.e. starting from the sequence number saved in
+     * the registered monitor. The response is handled asynchronously.
+     * @param monitorId  the monitor to which the request must be sent.
+     */
+    void requestAlarmHistory(String monitorId);
+
+    /**
+     * Sends a configuration command to a monitor, which applies it in RAM
+     * and, if asked by the command, persists the resulting configuration.
+     * @param monitorId  the monitor to which the command must be sent.
+     * @param command    the configuration command (see <code>MonitorProfile</code>).
+     */
+    void sendConfiguration(String monitorId, String command);
+
+    /**
+     * Pushes a configuration profile to a set of monitors. The monitors
+     * not registered to this collector are skipped.
+     * @param profile     the configuration profile.
+     * @param monitorIds  the monitors to which the profile must be pushed.
+     */
+    default void pushProfile(MonitorProfile profile, Collection<String> monitorIds) {
+        for (String monitorId : monitorIds) {
+            if (!getRegisteredMonitors().containsKey(monitorId))
+                continue;
+
+            for (String command : profile.toCommands())
+                sendConfiguration(monitorId, command);
+        }
+    }
 }
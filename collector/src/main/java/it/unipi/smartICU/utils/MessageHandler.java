@@ -1,7 +1,9 @@
 package it.unipi.smartICU.utils;
 
 import it.unipi.smartICU.analytics.TelemetryArchive;
+import it.unipi.smartICU.analytics.TelemetryStatistics;
 
+import java.util.List;
 import java.util.Map;
 import java.util.logging.Level;
 import java.util.logging.Logger;
@@ -11,6 +13,129 @@ import java.util.logging.Logger;
  * Handlers for the messages received from the smart ICU monitors.
  */
 public class MessageHandler {
+    private static final long SYNCHRONIZED_TIME_THRESHOLD = 946684800000L;   // 2000-01-01T00:00:00Z, in milliseconds since the epoch.
+
+    /**
+     * Checks if a time sent by a monitor is in milliseconds since the epoch, i.e. if the monitor
+     * had synchronized its clock with the collector. Otherwise, the time is in milliseconds since
+     * the boot of the monitor, which is told apart by its magnitude.
+     * @param time  the time sent by the monitor.
+     * @return      true if the time is in milliseconds since the epoch, false otherwise.
+     */
+    private static boolean isSynchronized(long time) {
+        return time >= SYNCHRONIZED_TIME_THRESHOLD;
+    }
+
+    /**
+     * Converts a time sent by a monitor into milliseconds since the epoch. The time sent by a monitor
+     * that had not synchronized its clock yet is converted assuming that the message carrying it took
+     * no time to reach the collector.
+     * @param time         the time sent by the monitor.
+     * @param sentTime     the time at which the monitor generated the message carrying it.
+     * @param arrivalTime  the time of arrival of the message at the collector, in milliseconds since the epoch.
+     * @return             the time in milliseconds since the epoch.
+     */
+    private static long toEpochTime(long time, long sentTime, long arrivalTime) {
+        if (isSynchronized(time))
+            return time;
+
+        return arrivalTime - (sentTime - time);
+    }
+
+    /**
+     * Saves inside the telemetry database the samples of a sample history whose sequence
+     * number lies in the given range. In the history, the samples of each sensor are encoded
+     * as a flat array: the first sample as [sensorSeq, seq, time, value], the following ones
+     * as the deltas of seq, time and value from the previous sample. The time is the one at
+     * which the sample was captured: the message carries the time at which it was generated
+     * ("sent"), used to trace the latency of each sample (see {@link TelemetryStatistics}).
+     * @param monitor     the monitor that sent the sample history.
+     * @param jsonObject  the parsed JSON message carrying the sample history.
+     * @param history     the samples of the history, one array per sensor.
+     * @param since       the sequence number of the first sample to be saved.
+     * @param until       the sequence number following the last sample to be saved.
+     * @return            the number of saved samples.
+     */
+    private static int saveSampleHistory(VitalSignsMonitor monitor, Map<String, Object> jsonObject,
+                                         List<List<Double>> history, long since, long until)
+    {
+        long arrivalTime = System.currentTimeMillis();
+        TelemetryStatistics statistics = monitor.getTelemetryStatistics();
+        boolean traced = jsonObject.containsKey("sent");
+        long sentTime = traced ? ((Double) jsonObject.get("sent")).longValue() : arrivalTime;
+        long networkLatency = traced ? statistics.recordMessage(sentTime, arrivalTime, isSynchronized(sentTime)) : 0;
+        int savedSamples = 0;
+
+        for (int sensorIndex = 0; sensorIndex < history.size() && sensorIndex < SensorType.values().length; sensorIndex++) {
+            SensorType sensor = SensorType.values()[sensorIndex];
+            List<Double> samples = history.get(sensorIndex);
+            long sensorSequence;
+            long sequence = 0;
+            long time = 0;
+            float value = 0;
+
+            if (samples.isEmpty())
+                continue;
+
+            sensorSequence = samples.get(0).longValue() - 1;
+            for (int i = 1; i + 2 < samples.size(); i += 3) {
+                sequence += samples.get(i).longValue();
+                time += samples.get(i + 1).longValue();
+                value += samples.get(i + 2).floatValue();
+                sensorSequence++;
+
+                if (sequence < since || sequence >= until)
+                    continue;
+
+                long timestamp = toEpochTime(time, sentTime, arrivalTime);
+                TelemetryArchive.save(sensor, value, sensor.getUnit(), timestamp, monitor.getMonitorId(), monitor.getPatientId());
+                savedSamples++;
+
+                statistics.recordSample(sensor, sensorSequence);
+                if (traced) {
+                    long monitorLatency = sentTime - time;
+                    long archiveLatency = System.currentTimeMillis() - arrivalTime;
+                    statistics.recordLatency(TelemetryStatistics.Hop.MONITOR, monitorLatency);
+                    statistics.recordLatency(TelemetryStatistics.Hop.NETWORK, networkLatency);
+                    statistics.recordLatency(TelemetryStatistics.Hop.ARCHIVE, archiveLatency);
+                    statistics.recordLatency(TelemetryStatistics.Hop.END_TO_END, monitorLatency + networkLatency + archiveLatency);
+                }
+            }
+        }
+
+        return savedSamples;
+    }
+
+    /**
+     * Adds a monitor to the list of registered ones. If a monitor with the same ID
+     * is already registered, it is replaced. Otherwise, the alarm events already saved
+     * in the telemetry archive (e.g. by a previous run of the collector) are skipped.
+     * @param logger              the logger used to write information about the handling.
+     * @param registeredMonitors  the list of registered monitors.
+     * @param monitorId           the ID of the monitor.
+     */
+    public static void registerMonitor(Logger logger,
+                                       Map<String, VitalSignsMonitor> registeredMonitors,
+                                       String monitorId)
+    {
+        VitalSignsMonitor monitor = new VitalSignsMonitor(monitorId);
+        VitalSignsMonitor oldMonitor = registeredMonitors.put(monitorId, monitor); // If an old object with the same ID is present, it is replaced.
+
+        /*
+         * Keep track of the alarm events already received, so that the monitor can be resynchronized,
+         * of the handle assigned to the monitor, so that a monitor registering again keeps it,
+         * and of the statistics of its samples, which span the reconnections.
+         */
+        if (oldMonitor != null) {
+            monitor.setAlarmHistorySequence(oldMonitor.getAlarmHistorySequence());
+            monitor.setHandle(oldMonitor.getHandle());
+            monitor.setTelemetryStatistics(oldMonitor.getTelemetryStatistics());
+        } else {
+            monitor.setAlarmHistorySequence(TelemetryArchive.getNextAlarmSequence(monitorId));
+        }
+
+        logger.log(Level.INFO, String.format("Registered a new monitor with ID %s.", monitorId));
+    }
 
     /**
      * Handles a monitor registration message, adding or removing the monitor
@@ -36,9 +161,7 @@ public class MessageHandler {
                 return null;
             }
 
-            VitalSignsMonitor monitor = new VitalSignsMonitor(monitorId);
-            registeredMonitors.put(monitorId, monitor); // If an old object with the same ID is present, it is replaced.
-            logger.log(Level.INFO, String.format("Registered a new monitor with ID %s.", monitorId));
+            registerMonitor(logger, registeredMonitors, monitorId);
             return monitorId;
         }
 
@@ -59,17 +182,33 @@ public class MessageHandler {
                                                  Map<String, VitalSignsMonitor> registeredMonitors,
                                                  String monitorId,
                                                  Map<String, Object> jsonObject)
+    {
+        VitalSignsMonitor monitor = registeredMonitors.get(monitorId);
+
+        if (monitor == null) {
+            logger.log(Level.INFO, String.format("Discarding the message: monitor %s is not registered.", monitorId));
+            return;
+        }
+
+        handlePatientRegistration(logger, monitor, jsonObject);
+    }
+
+    /**
+     * Handles a patient registration message sent by a registered monitor,
+     * already resolved by the caller. The patient ID is saved in the monitor.
+     * @param logger      the logger used to write information about the handling.
+     * @param monitor     the registered monitor that sent the message.
+     * @param jsonObject  the parsed JSON message.
+     */
+    public static void handlePatientRegistration(Logger logger,
+                                                 VitalSignsMonitor monitor,
+                                                 Map<String, Object> jsonObject)
     {
         logger.log(Level.INFO, "Handling a patient registration message.");
+        String monitorId = monitor.getMonitorId();
 
         if (jsonObject.containsKey("patientID")) {
             String patientId = (String) jsonObject.get("patientID");
-            VitalSignsMonitor monitor = registeredMonitors.get(monitorId);
-
-            if (monitor == null) {
-                logger.log(Level.INFO, String.format("Discarding the message: monitor %s is not registered.", monitorId));
-                return;
-            }
 
             if (monitor.getPatientId().equals(patientId)) {
                 logger.log(Level.INFO, "Discarding the message: the patient ID did not change.");
@@ -124,17 +263,33 @@ public class MessageHandler {
                                                  Map<String, VitalSignsMonitor> registeredMonitors,
                                                  String monitorId,
                                                  Map<String, Object> jsonObject)
+    {
+        VitalSignsMonitor monitor = registeredMonitors.get(monitorId);
+
+        if (monitor == null) {
+            logger.log(Level.INFO, String.format("Discarding the message: monitor %s is not registered.", monitorId));
+            return;
+        }
+
+        handleTelemetryAlarmState(logger, monitor, jsonObject);
+    }
+
+    /**
+     * Handles a telemetry message reporting the alarm state of a registered
+     * monitor, already resolved by the caller.
+     * @param logger      the logger used to write information about the handling.
+     * @param monitor     the registered monitor that sent the message.
+     * @param jsonObject  the parsed JSON message.
+     */
+    public static void handleTelemetryAlarmState(Logger logger,
+                                                 VitalSignsMonitor monitor,
+                                                 Map<String, Object> jsonObject)
     {
         logger.log(Level.INFO, "Handling a telemetry alarm state message.");
+        String monitorId = monitor.getMonitorId();
 
         if (jsonObject.containsKey("alarm")) {
             Boolean alarm = (Boolean) jsonObject.get("alarm");
-            VitalSignsMonitor monitor = registeredMonitors.get(monitorId);
-
-            if (monitor == null) {
-                logger.log(Level.INFO, String.format("Discarding the message: monitor %s is not registered.", monitorId));
-                return;
-            }
 
             if (monitor.getAlarm() == alarm) {
                 logger.log(Level.INFO, "Discarding the message: the alarm state did not change.");
@@ -149,6 +304,305 @@ public class MessageHandler {
         logger.log(Level.INFO, "Discarding the message: bad format.");
     }
 
+    /**
+     * Handles a retained message carrying the last known state of a monitor, i.e. its
+     * patient ID, the newest sample of each sensor and its alarm state. The samples
+     * are not saved, since they were already received with the batches of the monitor.
+     * A monitor that is not registered (e.g. because the collector has just been started)
+     * is registered with the state carried by the message.
+     * @param logger              the logger used to write information about the handling.
+     * @param registeredMonitors  the list of registered monitors.
+     * @param monitorId           the monitor ID of the monitor that sent the message.
+     * @param jsonObject          the parsed JSON message.
+     * @return                    true if the state of the monitor was restored or updated, false otherwise.
+     */
+    public static boolean handleMonitorState(Logger logger,
+                                             Map<String, VitalSignsMonitor> registeredMonitors,
+                                             String monitorId,
+                                             Map<String, Object> jsonObject)
+    {
+        logger.log(Level.INFO, "Handling a monitor state message.");
+
+        if (!jsonObject.containsKey("patientID") || !jsonObject.containsKey("alarm")) {
+            logger.log(Level.INFO, "Discarding the message: bad format.");
+            return false;
+        }
+
+        if (!registeredMonitors.containsKey(monitorId))
+            registerMonitor(logger, registeredMonitors, monitorId);
+
+        VitalSignsMonitor monitor = registeredMonitors.get(monitorId);
+        monitor.setPatientId((String) jsonObject.get("patientID"));
+        monitor.setAlarm((Boolean) jsonObject.get("alarm"));
+        logger.log(Level.INFO, String.format("Updated monitor %s: patient \"%s\", alarm state \"%s\".",
+                                             monitorId, monitor.getPatientId(), monitor.getAlarm()));
+        return true;
+    }
+
+    /**
+     * Handles a telemetry message carrying the alarm history of a monitor.
+     * The events not received yet are saved inside the telemetry database
+     * and the alarm state of the registered monitor is updated to the last
+     * received transition. If the monitor restarted since the last message,
+     * i.e. its sequence numbers started again from 0, all the events are
+     * considered as new.
+     * @param logger              the logger used to write information about the handling.
+     * @param registeredMonitors  the list of registered monitors.
+     * @param monitorId           the monitor ID of the monitor that sent the message.
+     * @param jsonObject          the parsed JSON message.
+     */
+    public static void handleAlarmHistory(Logger logger,
+                                          Map<String, VitalSignsMonitor> registeredMonitors,
+                                          String monitorId,
+                                          Map<String, Object> jsonObject)
+    {
+        VitalSignsMonitor monitor = registeredMonitors.get(monitorId);
+
+        if (monitor == null) {
+            logger.log(Level.INFO, String.format("Discarding the message: monitor %s is not registered.", monitorId));
+            return;
+        }
+
+        handleAlarmHistory(logger, monitor, jsonObject);
+    }
+
+    /**
+     * Handles a telemetry message carrying the alarm history of a registered
+     * monitor, already resolved by the caller.
+     * @param logger      the logger used to write information about the handling.
+     * @param monitor     the registered monitor that sent the message.
+     * @param jsonObject  the parsed JSON message.
+     */
+    public static void handleAlarmHistory(Logger logger,
+                                          VitalSignsMonitor monitor,
+                                          Map<String, Object> jsonObject)
+    {
+        logger.log(Level.INFO, "Handling an alarm history message.");
+        String monitorId = monitor.getMonitorId();
+
+        if (jsonObject.containsKey("alarmHistory") && jsonObject.containsKey("next")) {
+            List<List<Double>> events = (List<List<Double>>) jsonObject.get("alarmHistory");
+            long next = ((Double) jsonObject.get("next")).longValue();
+            long arrivalTime = System.currentTimeMillis();
+            long sentTime = jsonObject.containsKey("sent") ? ((Double) jsonObject.get("sent")).longValue() : arrivalTime;
+            int receivedEvents = 0;
+
+            if (next < monitor.getAlarmHistorySequence()) {
+                logger.log(Level.INFO, String.format("Monitor %s restarted: resetting its alarm history.", monitorId));
+                monitor.setAlarmHistorySequence(0);
+            }
+
+            // Each event is encoded as [seq, timestamp, sensor, value, alarm].
+            for (List<Double> event : events) {
+                long sequence = event.get(0).longValue();
+                if (event.size() != 5 || sequence < monitor.getAlarmHistorySequence())
+                    continue;
+
+                int sensorIndex = event.get(2).intValue();
+                SensorType sensor = null;
+                if (sensorIndex >= 0 && sensorIndex < SensorType.values().length)
+                    sensor = SensorType.values()[sensorIndex];
+
+                boolean alarm = event.get(4).intValue() == 1;
+                long timestamp = toEpochTime(event.get(1).longValue(), sentTime, arrivalTime);
+                TelemetryArchive.saveAlarmEvent(sequence, sensor, event.get(3).floatValue(), alarm,
+                                                timestamp, monitorId, monitor.getPatientId());
+                monitor.setAlarm(alarm);
+                receivedEvents++;
+            }
+
+            monitor.setAlarmHistorySequence(next);
+            logger.log(Level.INFO, String.format("Updated monitor %s: received %d alarm events, alarm state \"%s\".",
+                                                 monitorId, receivedEvents, monitor.getAlarm()));
+            return;
+        }
+
+        logger.log(Level.INFO, "Discarding the message: bad format.");
+    }
+
+    /**
+     * Handles a telemetry message carrying the state of a patient, i.e. the last
+     * samples of all the sensors of a monitor and its alarm state. The samples
+     * marked as updated are saved inside the telemetry database, while the alarm
+     * state saved in the registered monitor is updated. The sequence number carried
+     * by the message is compared with the one expected by the registered monitor,
+     * in order to detect the samples lost in the previous notifications.
+     * @param logger              the logger used to write information about the handling.
+     * @param registeredMonitors  the list of registered monitors.
+     * @param monitorId           the monitor ID of the monitor that sent the message.
+     * @param jsonObject          the parsed JSON message.
+     * @return                    the number of samples missed since the sequence number expected before
+     *                            the message, i.e. the samples preceding the first one carried by the message.
+     */
+    public static long handlePatientState(Logger logger,
+                                          Map<String, VitalSignsMonitor> registeredMonitors,
+                                          String monitorId,
+                                          Map<String, Object> jsonObject)
+    {
+        logger.log(Level.INFO, "Handling a patient state message.");
+        VitalSignsMonitor monitor = registeredMonitors.get(monitorId);
+        long missedSamples = 0;
+
+        if (monitor == null) {
+            logger.log(Level.INFO, String.format("Discarding the message: monitor %s is not registered.", monitorId));
+            return missedSamples;
+        }
+
+        if (jsonObject.containsKey("updated") && jsonObject.containsKey("alarm") && jsonObject.containsKey("timestamp")) {
+            int updated = ((Double) jsonObject.get("updated")).intValue();
+            // The timestamp is the time at which the message was generated.
+            long sentTime = ((Double) jsonObject.get("timestamp")).longValue();
+            long timestamp = toEpochTime(sentTime, sentTime, System.currentTimeMillis());
+            Boolean alarm = (Boolean) jsonObject.get("alarm");
+
+            // Bit i of "updated" tells if the sensor of index i produced a new sample.
+            for (SensorType sensor : SensorType.values()) {
+                if ((updated & (1 << sensor.ordinal())) == 0 || !jsonObject.containsKey(sensor.getKey()))
+                    continue;
+
+                float sample = Float.parseFloat(jsonObject.get(sensor.getKey()).toString());
+                TelemetryArchive.save(sensor, sample, sensor.getUnit(), timestamp, monitorId, monitor.getPatientId());
+            }
+
+            if (monitor.getAlarm() != alarm) {
+                monitor.setAlarm(alarm);
+                logger.log(Level.INFO, String.format("Updated monitor %s: new alarm state \"%s\".", monitorId, alarm));
+            }
+
+            // "seq" follows the sequence number of the last sample, so the message starts from seq - #updated.
+            if (jsonObject.containsKey("seq")) {
+                long sequence = ((Double) jsonObject.get("seq")).longValue();
+                long firstSequence = sequence - Integer.bitCount(updated);
+                long expectedSequence = monitor.getSampleHistorySequence();
+
+                if (expectedSequence >= 0 && firstSequence > expectedSequence) {
+                    logger.log(Level.INFO, String.format("Monitor %s: missed %d samples since sequence number %d.",
+                                                         monitorId, firstSequence - expectedSequence, expectedSequence));
+                    missedSamples = firstSequence - expectedSequence;
+                }
+                monitor.setSampleHistorySequence(sequence);
+            }
+            return missedSamples;
+        }
+
+        logger.log(Level.INFO, "Discarding the message: bad format.");
+        return missedSamples;
+    }
+
+    /**
+     * Handles a telemetry message carrying the sample history of a monitor, saving
+     * inside the telemetry database the samples whose sequence number lies in the
+     * requested range.
+     * @param logger              the logger used to write information about the handling.
+     * @param registeredMonitors  the list of registered monitors.
+     * @param monitorId           the monitor ID of the monitor that sent the message.
+     * @param jsonObject          the parsed JSON message.
+     * @param since               the sequence number of the first sample to be saved.
+     * @param until               the sequence number following the last sample to be saved.
+     */
+    public static void handleSampleHistory(Logger logger,
+                                           Map<String, VitalSignsMonitor> registeredMonitors,
+                                           String monitorId,
+                                           Map<String, Object> jsonObject,
+                                           long since,
+                                           long until)
+    {
+        logger.log(Level.INFO, "Handling a sample history message.");
+        VitalSignsMonitor monitor = registeredMonitors.get(monitorId);
+
+        if (monitor == null) {
+            logger.log(Level.INFO, String.format("Discarding the message: monitor %s is not registered.", monitorId));
+            return;
+        }
+
+        if (jsonObject.containsKey("sampleHistory")) {
+            List<List<Double>> history = (List<List<Double>>) jsonObject.get("sampleHistory");
+            int receivedSamples = saveSampleHistory(monitor, jsonObject, history, since, until);
+
+            logger.log(Level.INFO, String.format("Updated monitor %s: recovered %d missed samples.", monitorId, receivedSamples));
+            return;
+        }
+
+        logger.log(Level.INFO, "Discarding the message: bad format.");
+    }
+
+    /**
+     * Handles a telemetry message carrying a batch of samples pushed by a monitor, encoded
+     * as a sample history. The samples are saved inside the telemetry database, and the
+     * sequence number of the first sample of the batch is compared with the one expected
+     * by the registered monitor, in order to detect the samples lost in the previous batches.
+     * A batch preceding the expected sequence number is discarded, since its samples have
+     * already been requested to the monitor.
+     * @param logger              the logger used to write information about the handling.
+     * @param registeredMonitors  the list of registered monitors.
+     * @param monitorId           the monitor ID of the monitor that sent the message.
+     * @param jsonObject          the parsed JSON message.
+     * @return                    the number of samples missed since the sequence number expected before
+     *                            the message, i.e. the samples preceding the first one carried by the message.
+     */
+    public static long handleSampleBatch(Logger logger,
+                                         Map<String, VitalSignsMonitor> registeredMonitors,
+                                         String monitorId,
+                                         Map<String, Object> jsonObject)
+    {
+        VitalSignsMonitor monitor = registeredMonitors.get(monitorId);
+
+        if (monitor == null) {
+            logger.log(Level.INFO, String.format("Discarding the message: monitor %s is not registered.", monitorId));
+            return 0;
+        }
+
+        return handleSampleBatch(logger, monitor, jsonObject);
+    }
+
+    /**
+     * Handles a telemetry message carrying a batch of samples sent by a registered
+     * monitor, already resolved by the caller.
+     * @param logger      the logger used to write information about the handling.
+     * @param monitor     the registered monitor that sent the message.
+     * @param jsonObject  the parsed JSON message.
+     * @return            the number of samples missed since the sequence number expected before the message.
+     */
+    public static long handleSampleBatch(Logger logger,
+                                         VitalSignsMonitor monitor,
+                                         Map<String, Object> jsonObject)
+    {
+        logger.log(Level.INFO, "Handling a sample batch message.");
+        String monitorId = monitor.getMonitorId();
+        long missedSamples = 0;
+
+        if (jsonObject.containsKey("sampleHistory") && jsonObject.containsKey("next")) {
+            List<List<Double>> history = (List<List<Double>>) jsonObject.get("sampleHistory");
+            long next = ((Double) jsonObject.get("next")).longValue();
+            long expectedSequence = monitor.getSampleHistorySequence();
+
+            // The second element of the array of each sensor is the absolute sequence number of its first sample.
+            long firstSequence = next;
+            for (List<Double> samples : history)
+                if (samples.size() > 1)
+                    firstSequence = Math.min(firstSequence, samples.get(1).longValue());
+
+            if (expectedSequence >= 0 && next <= expectedSequence) {
+                logger.log(Level.INFO, "Discarding the message: the samples have already been received or requested.");
+                return missedSamples;
+            }
+
+            if (expectedSequence >= 0 && firstSequence > expectedSequence) {
+                logger.log(Level.INFO, String.format("Monitor %s: missed %d samples since sequence number %d.",
+                                                     monitorId, firstSequence - expectedSequence, expectedSequence));
+                missedSamples = firstSequence - expectedSequence;
+            }
+
+            int receivedSamples = saveSampleHistory(monitor, jsonObject, history, Math.max(firstSequence, expectedSequence), next);
+            monitor.setSampleHistorySequence(next);
+            logger.log(Level.INFO, String.format("Updated monitor %s: received %d samples.", monitorId, receivedSamples));
+            return missedSamples;
+        }
+
+        logger.log(Level.INFO, "Discarding the message: bad format.");
+        return missedSamples;
+    }
+
     /**
      * Handles a telemetry message carrying a sample produced by a sensor,
      * saving it inside the telemetry database.
@@ -196,7 +650,8 @@ public class MessageHandler {
 
             if (sensor != null) {
                 String unit = (String) jsonObject.get("unit");
-                float timestamp = Float.parseFloat(jsonObject.get("timestamp").toString());
+                long sampleTime = ((Double) jsonObject.get("timestamp")).longValue();
+                long timestamp = toEpochTime(sampleTime, sampleTime, System.currentTimeMillis());
                 TelemetryArchive.save(sensor, sample, unit, timestamp, monitorId,
                                       registeredMonitors.get(monitorId).getPatientId());
                 return;
@@ -205,4 +660,57 @@ public class MessageHandler {
 
         logger.log(Level.INFO, "Discarding the message: bad format.");
     }
+
+    /**
+     * Handles a telemetry message carrying the diagnostics report of a monitor, i.e. the
+     * time spent by its CPU and radio in each state, the longest length reached by its
+     * output queue, and the messages it dropped or could not publish in the last period.
+     * The report is saved inside the telemetry database.
+     * @param logger              the logger used to write information about the handling.
+     * @param registeredMonitors  the list of registered monitors.
+     * @param monitorId           the monitor ID of the monitor that sent the message.
+     * @param jsonObject          the parsed JSON message.
+     */
+    public static void handleDiagnostics(Logger logger,
+                                         Map<String, VitalSignsMonitor> registeredMonitors,
+                                         String monitorId,
+                                         Map<String, Object> jsonObject)
+    {
+        logger.log(Level.INFO, "Handling a diagnostics message.");
+
+        if (registeredMonitors.get(monitorId) == null) {
+            logger.log(Level.INFO, String.format("Discarding the message: monitor %s is not registered.", monitorId));
+            return;
+        }
+
+        String[] keys = {"period", "cpu", "lpm", "radioTx", "radioRx", "queueHighWaterMark", "dropped", "failures", "timestamp"};
+        for (String key : keys) {
+            if (!jsonObject.containsKey(key)) {
+                logger.log(Level.INFO, "Discarding the message: bad format.");
+                return;
+            }
+        }
+
+        // The failures are indexed by status, as mqtt_status_t: the slot 0 (success) is unused.
+        List<Double> failureList = (List<Double>) jsonObject.get("failures");
+        long[] failures = new long[5];
+        for (int i = 0; i < failures.length && i < failureList.size(); i++)
+            failures[i] = failureList.get(i).longValue();
+
+        long sentTime = ((Double) jsonObject.get("timestamp")).longValue();
+        long timestamp = toEpochTime(sentTime, sentTime, System.currentTimeMillis());
+        long period = ((Double) jsonObject.get("period")).longValue();
+        long cpu = ((Double) jsonObject.get("cpu")).longValue();
+        long lpm = ((Double) jsonObject.get("lpm")).longValue();
+        long radioTx = ((Double) jsonObject.get("radioTx")).longValue();
+        long radioRx = ((Double) jsonObject.get("radioRx")).longValue();
+        long queueHighWaterMark = ((Double) jsonObject.get("queueHighWaterMark")).longValue();
+        long dropped = ((Double) jsonObject.get("dropped")).longValue();
+
+        logger.log(Level.INFO, String.format("Monitor %s in the last %d ms: CPU %d ms, LPM %d ms, radio TX %d ms, radio RX %d ms, " +
+                                             "queue high-water mark %d, %d dropped messages.",
+                                             monitorId, period, cpu, lpm, radioTx, radioRx, queueHighWaterMark, dropped));
+        TelemetryArchive.saveDiagnostics(period, cpu, lpm, radioTx, radioRx, queueHighWaterMark, dropped,
+                                         failures, timestamp, monitorId);
+    }
 }
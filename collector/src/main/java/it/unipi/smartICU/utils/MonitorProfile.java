@@ -0,0 +1,115 @@
+package it.unipi.smartICU.utils;
+
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.Collections;
+import java.util.List;
+import java.util.Map;
+import java.util.StringJoiner;
+
+
+/**
+ * Class representing a configuration profile, i.e. a set of parameters tuned at runtime
+ * on the monitors to which it is pushed: the alarm thresholds and the sampling interval
+ * of each sensor, the interval at which the monitor sends its pending messages and the
+ * log levels of its Contiki modules and of its own modules. The parameters left out keep
+ * their current value.
+ * The profile is translated into the compact configuration commands understood by the
+ * monitors (see <code>monitor-config.h</code>), e.g. <code>min0=45&amp;max0=130&amp;int0=30</code>.
+ */
+public class MonitorProfile {
+    private static final int MAX_COMMAND_LENGTH = 64;   // Fits in a single CoAP block and MQTT-SN packet.
+
+    // Modules of the monitor with their own log level, in the order of their IDs (see monitor-log.h).
+    private static final List<String> MONITOR_MODULES = Arrays.asList(
+            "sensors", "alarmSystem", "monitorCore", "timeSync", "monitorConfig", "transport", "coapResources");
+
+    /**
+     * Class representing the parameters of a sensor in a profile.
+     */
+    public static class SensorParameters {
+        private Integer minThreshold;
+        private Integer maxThreshold;
+        private Integer samplingInterval;
+    }
+
+    private List<String> monitors;
+    private Map<String, SensorParameters> sensors;
+    private Integer sendInterval;
+    private Integer logLevel;
+    private Map<String, Integer> moduleLogLevels;
+    private boolean persistent;
+
+    /**
+     * Gets the monitors to which the profile is pushed when they register to the collector.
+     * @return  the IDs of the monitors.
+     */
+    public List<String> getMonitors() {
+        return monitors == null ? Collections.emptyList() : monitors;
+    }
+
+    /**
+     * Translates the profile into configuration commands. Each command is applied atomically by the
+     * monitors, so the parameters of a sensor are never split, and it is short enough to be carried
+     * by a single message. The commands of a persistent profile all ask the monitor to persist its
+     * configuration, so that it does not depend on the order in which they are delivered.
+     * @return  the configuration commands.
+     */
+    public List<String> toCommands() {
+        List<String> pairs = new ArrayList<>();
+        List<String> commands = new ArrayList<>();
+        String persist = persistent ? "save=1" : null;
+
+        for (SensorType sensor : SensorType.values()) {
+            SensorParameters parameters = sensors == null ? null : sensors.get(sensor.getKey());
+            if (parameters == null)
+                continue;
+
+            StringJoiner sensorPairs = new StringJoiner("&");
+            int index = sensor.ordinal();
+            if (parameters.minThreshold != null)
+                sensorPairs.add(String.format("min%d=%d", index, parameters.minThreshold));
+            if (parameters.maxThreshold != null)
+                sensorPairs.add(String.format("max%d=%d", index, parameters.maxThreshold));
+            if (parameters.samplingInterval != null)
+                sensorPairs.add(String.format("int%d=%d", index, parameters.samplingInterval));
+            if (sensorPairs.length() > 0)
+                pairs.add(sensorPairs.toString());
+        }
+
+        if (sendInterval != null)
+            pairs.add(String.format("send=%d", sendInterval));
+        if (logLevel != null)
+            pairs.add(String.format("log=%d", logLevel));
+        for (int module = 0; module < MONITOR_MODULES.size(); module++) {
+            Integer level = moduleLogLevels == null ? null : moduleLogLevels.get(MONITOR_MODULES.get(module));
+            if (level != null)
+                pairs.add(String.format("lvl%d=%d", module, level));
+        }
+
+        StringJoiner command = new StringJoiner("&");
+        for (String pair : pairs) {
+            int reservedLength = persist == null ? 0 : persist.length() + 1;
+            if (command.length() > 0 && command.length() + pair.length() + 1 + reservedLength > MAX_COMMAND_LENGTH) {
+                if (persist != null)
+                    command.add(persist);
+                commands.add(command.toString());
+                command = new StringJoiner("&");
+            }
+            command.add(pair);
+        }
+
+        if (command.length() > 0) {
+            if (persist != null)
+                command.add(persist);
+            commands.add(command.toString());
+        }
+
+        return commands;
+    }
+
+    @Override
+    public String toString() {
+        return String.join(" ", toCommands());
+    }
+}
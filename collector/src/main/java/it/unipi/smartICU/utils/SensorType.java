@@ -2,11 +2,37 @@ package it.unipi.smartICU.utils;
 
 /**
  * Enumerator representing the sensors supported by a smart ICU monitor.
+ * The order of the sensors matches the one used by the monitors,
+ * so that a sensor can be identified by its index.
  */
 public enum SensorType {
-    HEART_RATE,
-    BLOOD_PRESSURE,
-    TEMPERATURE,
-    RESPIRATION,
-    OXYGEN_SATURATION
+    HEART_RATE("heartRate", "bpm"),
+    BLOOD_PRESSURE("bloodPressure", "mmHg"),
+    TEMPERATURE("temperature", "C"),
+    RESPIRATION("respiration", "bpm"),
+    OXYGEN_SATURATION("oxygenSaturation", "%");
+
+    private final String key;
+    private final String unit;
+
+    SensorType(String key, String unit) {
+        this.key = key;
+        this.unit = unit;
+    }
+
+    /**
+     * Gets the key identifying the samples of the sensor in the JSON messages.
+     * @return  the key of the sensor.
+     */
+    public String getKey() {
+        return key;
+    }
+
+    /**
+     * Gets the measurement unit of the samples of the sensor.
+     * @return  the measurement unit of the sensor.
+     */
+    public String getUnit() {
+        return unit;
+    }
 }
@@ -1,5 +1,7 @@
 package it.unipi.smartICU.utils;
 
+import it.unipi.smartICU.analytics.TelemetryStatistics;
+
 /**
  * Class representing a smart ICU monitor registered to the collector.
  */
@@ -9,6 +11,10 @@ public class VitalSignsMonitor {
     private boolean alarm;
     private String ipAddress;
     private int port;
+    private long alarmHistorySequence;
+    private long sampleHistorySequence;
+    private int handle;
+    private TelemetryStatistics telemetryStatistics;
 
     public VitalSignsMonitor(String monitorId) {
         this.monitorId = monitorId;
@@ -16,6 +22,10 @@ public class VitalSignsMonitor {
         this.patientId = "";
         this.ipAddress = "";
         this.port = -1;
+        this.alarmHistorySequence = 0;
+        this.sampleHistorySequence = -1;
+        this.handle = -1;
+        this.telemetryStatistics = new TelemetryStatistics();
     }
 
     public String getMonitorId() {
@@ -38,6 +48,43 @@ public class VitalSignsMonitor {
         return port;
     }
 
+    /**
+     * Gets the sequence number of the first alarm event of the monitor
+     * that has not been received yet.
+     * @return  the sequence number of the first alarm event not received yet.
+     */
+    public long getAlarmHistorySequence() {
+        return alarmHistorySequence;
+    }
+
+    /**
+     * Gets the sequence number of the first sample of the monitor
+     * that has not been received yet.
+     * @return  the sequence number of the first sample not received yet,
+     *          or -1 if no patient state has been received yet.
+     */
+    public long getSampleHistorySequence() {
+        return sampleHistorySequence;
+    }
+
+    /**
+     * Gets the compact numeric handle assigned to the monitor at registration,
+     * which the monitor uses in place of its ID in the topics of its messages.
+     * @return  the handle of the monitor, or -1 if no handle has been assigned.
+     */
+    public int getHandle() {
+        return handle;
+    }
+
+    /**
+     * Gets the delivery statistics of the samples of the monitor,
+     * i.e. their loss rate and their latency along the telemetry path.
+     * @return  the statistics of the monitor.
+     */
+    public TelemetryStatistics getTelemetryStatistics() {
+        return telemetryStatistics;
+    }
+
     public void setPatientId(String patientId) {
         this.patientId = patientId;
     }
@@ -54,6 +101,22 @@ public class VitalSignsMonitor {
         this.port = port;
     }
 
+    public void setAlarmHistorySequence(long alarmHistorySequence) {
+        this.alarmHistorySequence = alarmHistorySequence;
+    }
+
+    public void setSampleHistorySequence(long sampleHistorySequence) {
+        this.sampleHistorySequence = sampleHistorySequence;
+    }
+
+    public void setHandle(int handle) {
+        this.handle = handle;
+    }
+
+    public void setTelemetryStatistics(TelemetryStatistics telemetryStatistics) {
+        this.telemetryStatistics = telemetryStatistics;
+    }
+
     @Override
     public String toString() {
         return "VitalSignsMonitor{" +
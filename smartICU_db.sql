@@ -17,6 +17,38 @@ USE `smartICU`;
 /*!40101 SET @OLD_SQL_MODE=@@SQL_MODE, SQL_MODE='NO_AUTO_VALUE_ON_ZERO' */;
 /*!40111 SET @OLD_SQL_NOTES=@@SQL_NOTES, SQL_NOTES=0 */;
 
+--
+-- Table structure for table `alarm_event`
+--
+
+DROP TABLE IF EXISTS `alarm_event`;
+/*!40101 SET @saved_cs_client     = @@character_set_client */;
+/*!40101 SET character_set_client = utf8 */;
+CREATE TABLE `alarm_event` (
+  `event_id` int(10) unsigned NOT NULL AUTO_INCREMENT,
+  `sequence` int(10) unsigned NOT NULL,
+  `sensor` varchar(30) COLLATE utf8_unicode_ci DEFAULT NULL,
+  `value` float NOT NULL,
+  `alarm` tinyint(1) NOT NULL,
+  `timestamp` bigint(20) unsigned NOT NULL,
+  `patient_id` varchar(45) COLLATE utf8_unicode_ci NOT NULL,
+  `monitor_id` varchar(45) COLLATE utf8_unicode_ci NOT NULL,
+  PRIMARY KEY (`event_id`),
+  KEY `monitor_id` (`monitor_id`,`sequence`),
+  KEY `patient_id` (`patient_id`,`timestamp`),
+  KEY `timestamp` (`timestamp`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8 COLLATE=utf8_unicode_ci;
+/*!40101 SET character_set_client = @saved_cs_client */;
+
+--
+-- Dumping data for table `alarm_event`
+--
+
+LOCK TABLES `alarm_event` WRITE;
+/*!40000 ALTER TABLE `alarm_event` DISABLE KEYS */;
+/*!40000 ALTER TABLE `alarm_event` ENABLE KEYS */;
+UNLOCK TABLES;
+
 --
 -- Table structure for table `blood_pressure`
 --
@@ -28,10 +60,12 @@ CREATE TABLE `blood_pressure` (
   `sample_id` int(10) unsigned NOT NULL AUTO_INCREMENT,
   `sample` float NOT NULL,
   `unit` varchar(30) COLLATE utf8_unicode_ci NOT NULL,
-  `timestamp` varchar(50) COLLATE utf8_unicode_ci NOT NULL,
+  `timestamp` bigint(20) unsigned NOT NULL,
   `patient_id` varchar(45) COLLATE utf8_unicode_ci NOT NULL,
   `monitor_id` varchar(45) COLLATE utf8_unicode_ci NOT NULL,
-  PRIMARY KEY (`sample_id`)
+  PRIMARY KEY (`sample_id`),
+  KEY `patient_id` (`patient_id`,`timestamp`),
+  KEY `timestamp` (`timestamp`)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8 COLLATE=utf8_unicode_ci;
 /*!40101 SET character_set_client = @saved_cs_client */;
 
@@ -55,10 +89,12 @@ CREATE TABLE `heart_rate` (
   `sample_id` int(10) unsigned NOT NULL AUTO_INCREMENT,
   `sample` float NOT NULL,
   `unit` varchar(30) COLLATE utf8_unicode_ci NOT NULL,
-  `timestamp` varchar(50) COLLATE utf8_unicode_ci NOT NULL,
+  `timestamp` bigint(20) unsigned NOT NULL,
   `patient_id` varchar(45) COLLATE utf8_unicode_ci NOT NULL,
   `monitor_id` varchar(45) COLLATE utf8_unicode_ci NOT NULL,
-  PRIMARY KEY (`sample_id`)
+  PRIMARY KEY (`sample_id`),
+  KEY `patient_id` (`patient_id`,`timestamp`),
+  KEY `timestamp` (`timestamp`)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8 COLLATE=utf8_unicode_ci;
 /*!40101 SET character_set_client = @saved_cs_client */;
 
@@ -71,6 +107,43 @@ LOCK TABLES `heart_rate` WRITE;
 /*!40000 ALTER TABLE `heart_rate` ENABLE KEYS */;
 UNLOCK TABLES;
 
+--
+-- Table structure for table `monitor_diagnostics`
+--
+
+DROP TABLE IF EXISTS `monitor_diagnostics`;
+/*!40101 SET @saved_cs_client     = @@character_set_client */;
+/*!40101 SET character_set_client = utf8 */;
+CREATE TABLE `monitor_diagnostics` (
+  `diagnostics_id` int(10) unsigned NOT NULL AUTO_INCREMENT,
+  `period` int(10) unsigned NOT NULL,
+  `cpu` int(10) unsigned NOT NULL,
+  `lpm` int(10) unsigned NOT NULL,
+  `radio_tx` int(10) unsigned NOT NULL,
+  `radio_rx` int(10) unsigned NOT NULL,
+  `queue_high_water_mark` int(10) unsigned NOT NULL,
+  `dropped` int(10) unsigned NOT NULL,
+  `failures_queue_full` int(10) unsigned NOT NULL,
+  `failures_not_connected` int(10) unsigned NOT NULL,
+  `failures_invalid_args` int(10) unsigned NOT NULL,
+  `failures_other` int(10) unsigned NOT NULL,
+  `timestamp` bigint(20) unsigned NOT NULL,
+  `monitor_id` varchar(45) COLLATE utf8_unicode_ci NOT NULL,
+  PRIMARY KEY (`diagnostics_id`),
+  KEY `monitor_id` (`monitor_id`,`timestamp`),
+  KEY `timestamp` (`timestamp`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8 COLLATE=utf8_unicode_ci;
+/*!40101 SET character_set_client = @saved_cs_client */;
+
+--
+-- Dumping data for table `monitor_diagnostics`
+--
+
+LOCK TABLES `monitor_diagnostics` WRITE;
+/*!40000 ALTER TABLE `monitor_diagnostics` DISABLE KEYS */;
+/*!40000 ALTER TABLE `monitor_diagnostics` ENABLE KEYS */;
+UNLOCK TABLES;
+
 --
 -- Table structure for table `oxygen_saturation`
 --
@@ -82,10 +155,12 @@ CREATE TABLE `oxygen_saturation` (
   `sample_id` int(10) unsigned NOT NULL AUTO_INCREMENT,
   `sample` float NOT NULL,
   `unit` varchar(30) COLLATE utf8_unicode_ci NOT NULL,
-  `timestamp` varchar(50) COLLATE utf8_unicode_ci NOT NULL,
+  `timestamp` bigint(20) unsigned NOT NULL,
   `patient_id` varchar(45) COLLATE utf8_unicode_ci NOT NULL,
   `monitor_id` varchar(45) COLLATE utf8_unicode_ci NOT NULL,
-  PRIMARY KEY (`sample_id`)
+  PRIMARY KEY (`sample_id`),
+  KEY `patient_id` (`patient_id`,`timestamp`),
+  KEY `timestamp` (`timestamp`)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8 COLLATE=utf8_unicode_ci;
 /*!40101 SET character_set_client = @saved_cs_client */;
 
@@ -109,10 +184,12 @@ CREATE TABLE `respiration` (
   `sample_id` int(10) unsigned NOT NULL AUTO_INCREMENT,
   `sample` float NOT NULL,
   `unit` varchar(30) COLLATE utf8_unicode_ci NOT NULL,
-  `timestamp` varchar(50) COLLATE utf8_unicode_ci NOT NULL,
+  `timestamp` bigint(20) unsigned NOT NULL,
   `patient_id` varchar(45) COLLATE utf8_unicode_ci NOT NULL,
   `monitor_id` varchar(45) COLLATE utf8_unicode_ci NOT NULL,
-  PRIMARY KEY (`sample_id`)
+  PRIMARY KEY (`sample_id`),
+  KEY `patient_id` (`patient_id`,`timestamp`),
+  KEY `timestamp` (`timestamp`)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8 COLLATE=utf8_unicode_ci;
 /*!40101 SET character_set_client = @saved_cs_client */;
 
@@ -136,10 +213,12 @@ CREATE TABLE `temperature` (
   `sample_id` int(10) unsigned NOT NULL AUTO_INCREMENT,
   `sample` float NOT NULL,
   `unit` varchar(30) COLLATE utf8_unicode_ci NOT NULL,
-  `timestamp` varchar(50) COLLATE utf8_unicode_ci NOT NULL,
+  `timestamp` bigint(20) unsigned NOT NULL,
   `patient_id` varchar(45) COLLATE utf8_unicode_ci NOT NULL,
   `monitor_id` varchar(45) COLLATE utf8_unicode_ci NOT NULL,
-  PRIMARY KEY (`sample_id`)
+  PRIMARY KEY (`sample_id`),
+  KEY `patient_id` (`patient_id`,`timestamp`),
+  KEY `timestamp` (`timestamp`)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8 COLLATE=utf8_unicode_ci;
 /*!40101 SET character_set_client = @saved_cs_client */;
 
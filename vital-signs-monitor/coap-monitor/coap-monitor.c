@@ -10,7 +10,9 @@
  * @{
  *
  * The coap-monitor module provides a simulation of a vital signs monitor
- * that uses the CoAP protocol to exchange data with a collector.
+ * that uses the CoAP protocol to exchange data with a collector. By default
+ * the collector observes the resources of the monitor; if the monitor is built
+ * in push mode (COAP_MONITOR_PUSH_MODE), the monitor POSTs its data to the collector.
  */
 
 #include <stdbool.h>
@@ -22,20 +24,27 @@
 #include "os/net/ipv6/uip-ds6.h"
 #include "os/net/app-layer/coap/coap-engine.h"
 #include "os/net/app-layer/coap/coap-blocking-api.h"
+#include "os/net/app-layer/coap/coap-callback-api.h"
 #include "os/dev/serial-line.h"
 #include "os/dev/button-hal.h"
 #include "../common/sensors-cmd.h"
 #include "../common/json-message.h"
-#include "../common/alarm.h"
-#include "../common/alarm-constants.h"
+#include "../common/monitor-core.h"
+#include "../common/backoff.h"
+#include "../common/monitor-log.h"
 #include "./utils/coap-monitor-constants.h"
+#include "./utils/coap-lazy-sampling.h"
+#include "./utils/coap-push.h"
+#include "./utils/coap-rd.h"
 #include "./resources/res-registered-patient.h"
-#include "./resources/res-heart-rate.h"
-#include "./resources/res-blood-pressure.h"
-#include "./resources/res-temperature.h"
-#include "./resources/res-respiration.h"
-#include "./resources/res-oxygen-saturation.h"
+#include "./resources/res-sensor.h"
 #include "./resources/res-alarm-state.h"
+#include "./resources/res-alarm-group.h"
+#include "./resources/res-alarm-history.h"
+#include "./resources/res-patient-state.h"
+#include "./resources/res-sample-history.h"
+#include "./resources/res-config.h"
+#include "./resources/res-diagnostics.h"
 
 #define LOG_MODULE "CoAP vital signs monitor"
 #define LOG_LEVEL LOG_LEVEL_COAP_MONITOR
@@ -45,63 +54,102 @@ PROCESS_NAME(coap_vital_signs_monitor);
 /* Structure representing a CoAP vital signs monitor. */
 struct coap_monitor {
   char monitor_id[COAP_MONITOR_ID_LENGTH];
-  struct alarm_system alarm;
+  struct monitor_core core;
+  struct sample_history sample_history;
   uint8_t state;
 
-  /* ID of the patient currently attached to the monitor. */
-  char patient_id[COAP_MONITOR_PATIENT_ID_LENGTH];
-
-  /* Timer to check network connectivity. */
+  /* Timer to check network connectivity, then to schedule the registration attempts and refreshes. */
   clock_time_t network_check_interval;
   struct etimer network_check_timer;
 
-  /* Management of monitor registration messages. */
+  /* Management of the registration to the resource directory of the collector. */
+  struct backoff registration_backoff;
   coap_endpoint_t collector_endpoint;
   coap_message_t registration_request;
-  char output_buffer[COAP_MONITOR_OUTPUT_BUFFER_SIZE];
+  uint32_t registration_block;
+  bool registration_more_blocks;
+  bool request_succeeded;
+
+  /*
+   * Once the monitor is registered, the requests to the resource directory are not blocking, so that
+   * the samples, the button presses and the serial lines are handled while they are retransmitted.
+   * The process is informed of the end of each request by rd_response_event.
+   */
+  coap_callback_request_state_t rd_request_state;
+  bool rd_refreshing;
 };
 
+static process_event_t rd_response_event;
+
 static struct coap_monitor monitor;
 
 /*---------------------------------------------------------------------------*/
 /**
- * \brief                 Check if a sample should trigger an alarm.
- * \param min_threshold   The minimum threshold that should trigger an alarm.
- * \param max_threshold   The maximum threshold that should trigger an alarm.
- * \param sample          The sample to be checked.
- * \return                true if the event should trigger an alarm, false otherwise.
+ * \brief          Send a new sample to the collector.
+ * \param sensor   The sensor that produced the sample.
+ * \param sample   The sample.
  *
- *                        The function checks if a sample should trigger an alarm,
- *                        i.e. if the sample is less than or equal to <code>min_threshold</code>,
- *                        or greater than or equal to <code>max_threshold</code>.
+ *                 The function records the sample in the sample history and updates
+ *                 the resource of the sensor and the patient state resource,
+ *                 triggering notifications to the observers. In push mode, the
+ *                 sample is also pushed to the collector with the next batch.
  */
-static bool
-alarming_sample(int min_threshold, int max_threshold, int sample)
+static void
+publish_sample(sensor_type sensor, int sample)
 {
-  if(sample <= min_threshold || sample >= max_threshold) {
-    return true;
-  }
-  return false;
+  sample_history_record(&monitor.sample_history, sensor, sample);
+  res_patient_state_update_sample(sensor, sample);
+  res_sensor_update(sensor, sample);
+#ifdef COAP_MONITOR_PUSH_MODE
+  coap_push_sample_recorded();
+#endif
 }
 /*---------------------------------------------------------------------------*/
 /**
- * \brief    Check if the monitor is correctly connected to the network.
- * \return   true if the monitor is correctly connected to the network,
- *           false otherwise.
- *
- *           The function checks if the monitor is correctly connected
- *           to the network, namely if it has a global address
- *           and a default route.
+ * \brief         Inform the collector about a change of the alarm state.
+ * \param state   The new alarm state.
  */
-static bool
-network_ready(void)
+static void
+publish_alarm_state(alarm_state state)
 {
-  if(uip_ds6_get_global(ADDR_PREFERRED) == NULL || uip_ds6_defrt_choose() == NULL) {
-    return false;
-  }
-  return true;
+  res_alarm_state_update(state);
+  res_patient_state_alarm_changed();
+#ifdef COAP_MONITOR_PUSH_MODE
+  coap_push_alarm_state(state);
+#endif
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief              Inform the collector about the patient attached to the monitor.
+ * \param patient_id   The patient ID (empty if reset).
+ */
+static void
+publish_patient_id(char *patient_id)
+{
+  res_registered_patient_update(patient_id);
+#ifdef COAP_MONITOR_PUSH_MODE
+  coap_push_patient_id(patient_id);
+#endif
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief          Inform the collector about the diagnostics report of the last period.
+ * \param report   A pointer to the report.
+ */
+static void
+publish_diagnostics(const struct monitor_diagnostics *report)
+{
+  res_diagnostics_update(report);
 }
 /*---------------------------------------------------------------------------*/
+/* Transport used by the monitor core: the collector is informed through observable resources, or pushed messages. */
+static const struct monitor_transport coap_transport = {
+  publish_sample,
+  publish_alarm_state,
+  publish_patient_id,
+  publish_diagnostics,
+};
+/*---------------------------------------------------------------------------*/
 /**
  * \brief   Handle the COAP_MONITOR_STATE_STARTED state.
  *
@@ -114,16 +162,9 @@ network_ready(void)
 static void
 handle_state_started(void)
 {
-  if(network_ready()) {
-    LOG_INFO("Connected to the network. ");
-    LOG_INFO_("Global address: ");
-    LOG_INFO_6ADDR(&(uip_ds6_get_global(ADDR_PREFERRED)->ipaddr));
-    LOG_INFO_(". Link local address: ");
-    LOG_INFO_6ADDR(&(uip_ds6_get_link_local(ADDR_PREFERRED)->ipaddr));
-    LOG_INFO_("\n");
+  if(monitor_core_network_ready()) {
     monitor.state = COAP_MONITOR_STATE_NETWORK_READY;
   } else {
-    LOG_INFO("Connecting to the network.\n");
     etimer_reset(&monitor.network_check_timer);
   }
 }
@@ -132,10 +173,11 @@ handle_state_started(void)
  * \brief    Handle the COAP_MONITOR_STATE_NETWORK_READY state.
  *
  *           The function handles the COAP_MONITOR_STATE_NETWORK_READY state,
- *           initializing the monitor ID and preparing the monitor registration
- *           message to send to the collector. The latter is placed in
- *           <code>monitor.output_buffer</code>, ready to be sent via
- *           <code>COAP_BLOCKING_REQUEST()</code>.
+ *           initializing the monitor ID and the registration to the resource
+ *           directory of the collector, which lists the resources activated by
+ *           the monitor. The registration is scheduled after a random delay,
+ *           changing the monitor state to COAP_MONITOR_STATE_REGISTRATION_PENDING,
+ *           so that the monitors booting together do not register at the same time.
  */
 static void
 handle_state_network_ready()
@@ -145,199 +187,149 @@ handle_state_network_ready()
                         COAP_MONITOR_ID_LENGTH,
                         &(uip_ds6_get_global(ADDR_PREFERRED)->ipaddr));
 
-  /* Prepare the registration request to send to the collector. */
-  coap_init_message(&monitor.registration_request, COAP_TYPE_CON, COAP_POST, 0);
-  coap_set_header_uri_path(&monitor.registration_request, COAP_MONITOR_COLLECTOR_REGISTERED_MONITORS_RESOURCE);
-
-  json_message_monitor_registration(monitor.output_buffer, COAP_MONITOR_OUTPUT_BUFFER_SIZE, monitor.monitor_id);
-  coap_set_payload(&monitor.registration_request, monitor.output_buffer, sizeof(monitor.output_buffer) - 1);
+  coap_rd_init(monitor.monitor_id);
 
-  LOG_INFO("Sending a POST with payload %s to the endpoint %s/%s.\n",
-           monitor.output_buffer,
-           COAP_MONITOR_COLLECTOR_REGISTERED_MONITORS_RESOURCE,
-           COAP_MONITOR_COLLECTOR_ENDPOINT);
+  monitor.state = COAP_MONITOR_STATE_REGISTRATION_PENDING;
+  etimer_set(&monitor.network_check_timer, backoff_initial_delay(&monitor.registration_backoff));
 }
 /*---------------------------------------------------------------------------*/
 /**
- * \brief   Handle the reception of a new patient ID on the serial line.
+ * \brief             Schedule the next request to the resource directory.
+ * \param succeeded   true if the last registration or refresh succeeded.
  *
- *          The function handles the reception of a new patient ID
- *          on the serial line, updating the relative resource
- *          and restarting the sampling activity
- *          of the sensor processes. It changes the
- *          monitor state to COAP_MONITOR_STATE_OPERATIONAL.
+ *                    After a successful registration or refresh, the next refresh is
+ *                    scheduled within the lifetime of the registration. After a failure,
+ *                    the request is retried after the delay given by the registration backoff.
  */
 static void
-handle_new_patient_ID(char *patient_id)
+schedule_registration(bool succeeded)
 {
-  memcpy(monitor.patient_id, patient_id, COAP_MONITOR_PATIENT_ID_LENGTH);
-  monitor.patient_id[COAP_MONITOR_PATIENT_ID_LENGTH - 1] = '\0';
-  LOG_INFO("New patient ID: %s.\n", monitor.patient_id);
+  clock_time_t delay;
 
-  /* Update the patient ID resource. */
-  res_registered_patient_update(monitor.patient_id);
-
-  /* Start the sampling activity of the sensors. */
-  sensors_cmd_start_sampling(&coap_vital_signs_monitor);
+  if(succeeded) {
+    backoff_success(&monitor.registration_backoff);
+    delay = COAP_MONITOR_RD_REFRESH_INTERVAL*CLOCK_SECOND;
+  } else {
+    delay = backoff_failure(&monitor.registration_backoff);
+    LOG_INFO("Retrying the request to the resource directory in %lu s.\n", (unsigned long)(delay / CLOCK_SECOND));
+  }
 
-  monitor.state = COAP_MONITOR_STATE_OPERATIONAL;
+  etimer_set(&monitor.network_check_timer, delay);
 }
 /*---------------------------------------------------------------------------*/
 /**
- * \brief   Handle the CoAP message sent by the collector in response to
- *          the monitor registration message.
+ * \brief                Change the monitor state according to the
+ *                       presence of a patient ID.
+ * \param has_patient   true if a patient ID has been configured.
  *
- *          The function handles the CoAP message sent by the collector
- *          in response to the monitor registration message. More in details:<br>
- *          1) if the request fails due to a timeout or the response carries a
- *             response code different from 2.01, the function changes the monitor
- *             state to COAP_MONITOR_STATE_REGISTRATION_FAILED;<br>
- *          2) if the request succeeds with a response code 2.01, the function changes
- *             the monitor state to COAP_MONITOR_STATE_WAITING_PATIENT_ID and starts
- *             the sampling activity of the sensors.
+ *                       The function changes the monitor state to COAP_MONITOR_STATE_OPERATIONAL
+ *                       if a patient ID has been configured, to COAP_MONITOR_STATE_WAITING_PATIENT_ID
+ *                       otherwise. The sensors are sampled only in the former state, and only while
+ *                       somebody is interested in their samples (always in push mode, since
+ *                       the collector receives all of them).
  */
-void
-handle_registration_response(coap_message_t *response)
+static void
+update_patient_state(bool has_patient)
 {
-  if(response == NULL) {
-    LOG_ERR("Registration failed: request timed out.\n");
-    monitor.state = COAP_MONITOR_STATE_REGISTRATION_FAILED;
-    return;
-  }
+  monitor.state = has_patient ? COAP_MONITOR_STATE_OPERATIONAL : COAP_MONITOR_STATE_WAITING_PATIENT_ID;
 
-  if(response->code != CREATED_2_01) {
-    LOG_ERR("Registration failed. Response code: %u.%u\n", (response->code) >> 5, (response->code) & 31);
-    monitor.state = COAP_MONITOR_STATE_REGISTRATION_FAILED;
-    return;
+#ifndef COAP_MONITOR_PUSH_MODE
+  if(has_patient) {
+    coap_lazy_sampling_enable();
+  } else {
+    coap_lazy_sampling_disable();
   }
-
-  LOG_INFO("Registration succeeded.\n");
-
-  /* Start the sensor processes (without starting the sampling activity). */
-  sensors_cmd_start_processes();
-
-  monitor.state = COAP_MONITOR_STATE_WAITING_PATIENT_ID;
-  LOG_INFO("Waiting for a new patient ID on the serial line.\n");
-
-#ifdef AUTOMATIC_PATIENT_ID_CONFIGURATION
-  LOG_INFO("Automatic configuration of the new patient ID.\n");
-  char random_patient_ID[COAP_MONITOR_PATIENT_ID_LENGTH];
-  snprintf(random_patient_ID, COAP_MONITOR_PATIENT_ID_LENGTH, "auto_%d", rand());
-  handle_new_patient_ID(random_patient_ID);
 #endif
 }
 /*---------------------------------------------------------------------------*/
 /**
- * \brief   Handle the button press event.
+ * \brief                  Handle the responses to the requests sent by <code>send_rd_request()</code>.
+ * \param callback_state   The state of the request.
  *
- *          The function handles the button press event, turning off
- *          the alarm system and resetting the patient ID if the press
- *          duration exceeds a configured number of seconds.
- *          If the patient ID is reset, it changes the
- *          monitor state to COAP_MONITOR_STATE_WAITING_PATIENT_ID.
+ *                         The function is called by the CoAP engine, outside of the monitor
+ *                         process: it only records the outcome, then posts rd_response_event.
  */
 static void
-handle_button_press(button_hal_button_t *button)
+handle_rd_response(coap_callback_request_state_t *callback_state)
 {
-  LOG_INFO("Button press event: %d s.\n", button->press_duration_seconds);
-
-  if(button->press_duration_seconds == COAP_MONITOR_RESET_ALARM_DURATION
-     || button->press_duration_seconds == COAP_MONITOR_RESET_PATIENT_ID_DURATION) {
-    bool alarm_state_changed;
-
-    /* The alarm is stopped and the relative resource is updated, if the alarm was turned on. */
-    LOG_INFO("Resetting the alarm.\n");
-    alarm_state_changed = alarm_stop(&monitor.alarm);
+  coap_message_t *response = callback_state->state.response;
 
-    if(alarm_state_changed) {
-      res_alarm_state_update(ALARM_OFF);
-    }
+  switch(callback_state->state.status) {
+  case COAP_REQUEST_STATUS_RESPONSE:
+    monitor.request_succeeded = monitor.rd_refreshing
+                                ? coap_rd_handle_refresh_response(response)
+                                : coap_rd_handle_registration_response(response, monitor.registration_block);
+    return;
+  case COAP_REQUEST_STATUS_FINISHED:
+    break;
+  case COAP_REQUEST_STATUS_MORE:
+    return;
+  default:
+    /* The request timed out: the handlers log the failure. */
+    monitor.request_succeeded = monitor.rd_refreshing
+                                ? coap_rd_handle_refresh_response(NULL)
+                                : coap_rd_handle_registration_response(NULL, monitor.registration_block);
+    break;
   }
 
-  if(button->press_duration_seconds == COAP_MONITOR_RESET_PATIENT_ID_DURATION) {
-    LOG_INFO("Resetting the patient ID.\n");
-    memset(monitor.patient_id, 0, COAP_MONITOR_PATIENT_ID_LENGTH);
-
-    /* Update the patient ID resource. */
-    res_registered_patient_update(monitor.patient_id);
-
-    /* Stop the sampling activity of the sensors. */
-    sensors_cmd_stop_sampling();
-
-    monitor.state = COAP_MONITOR_STATE_WAITING_PATIENT_ID;
-    LOG_INFO("Waiting for a new patient ID on the serial line.\n");
+  process_post(&coap_vital_signs_monitor, rd_response_event, NULL);
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief   Send a request to the resource directory, without blocking the process.
+ *
+ *          The function refreshes the registration or, if the directory forgot it,
+ *          sends the current block of a new registration (see <code>handle_rd_request_end()</code>).
+ */
+static void
+send_rd_request(void)
+{
+  monitor.rd_refreshing = coap_rd_registered();
+  if(monitor.rd_refreshing) {
+    LOG_DBG("Refreshing the registration to the resource directory.\n");
+    coap_rd_prepare_refresh(&monitor.registration_request);
+  } else {
+    monitor.registration_more_blocks = coap_rd_prepare_registration(&monitor.registration_request,
+                                                                    monitor.registration_block);
+    LOG_INFO("Sending the block %lu of the registration to the endpoint %s/%s.\n",
+             (unsigned long)monitor.registration_block,
+             COAP_MONITOR_COLLECTOR_ENDPOINT,
+             COAP_MONITOR_COLLECTOR_RD_RESOURCE);
+  }
 
-#ifdef AUTOMATIC_PATIENT_ID_CONFIGURATION
-    LOG_INFO("Automatic configuration of the new patient ID.\n");
-    char random_patient_ID[COAP_MONITOR_PATIENT_ID_LENGTH];
-    snprintf(random_patient_ID, COAP_MONITOR_PATIENT_ID_LENGTH, "auto_%d", rand());
-    handle_new_patient_ID(random_patient_ID);
-#endif
+  monitor.request_succeeded = false;
+  if(!coap_send_request(&monitor.rd_request_state,
+                        &monitor.collector_endpoint,
+                        &monitor.registration_request,
+                        handle_rd_response)) {
+    LOG_ERR("Impossible to send the request to the resource directory.\n");
+    schedule_registration(false);
   }
 }
 /*---------------------------------------------------------------------------*/
 /**
- * \brief   Handle the reception of a sample from a sensor process.
+ * \brief   Handle the end of a request sent by <code>send_rd_request()</code>.
  *
- *          The function handles the reception of a sample from a
- *          sensor process, updating the corresponding resource.
- *          If the sample is an alarming one, it turns
- *          on the alarm system and updates the relative resource.
+ *          The blocks of a registration are sent one after the other, then the
+ *          next request is scheduled as after a blocking one.
  */
 static void
-handle_sensor_sample(process_event_t event, int sample)
+handle_rd_request_end(void)
 {
-  char *sensor;
-  int min_threshold;
-  int max_threshold;
-
-  if(sensors_cmd_heart_rate_sample_event(event)) {
-    sensor = "heart rate";
-    min_threshold = ALARM_HEART_RATE_MIN_THRESHOLD;
-    max_threshold = ALARM_HEART_RATE_MAX_THRESHOLD;
-    res_heart_rate_update(sample);
-
-  } else if(sensors_cmd_blood_pressure_sample_event(event)) {
-    sensor = "blood pressure";
-    min_threshold = ALARM_BLOOD_PRESSURE_MIN_THRESHOLD;
-    max_threshold = ALARM_BLOOD_PRESSURE_MAX_THRESHOLD;
-    res_blood_pressure_update(sample);
-
-  } else if(sensors_cmd_oxygen_saturation_sample_event(event)) {
-    sensor = "oxygen saturation";
-    min_threshold = ALARM_OXYGEN_SATURATION_MIN_THRESHOLD;
-    max_threshold = ALARM_OXYGEN_SATURATION_MAX_THRESHOLD;
-    res_oxygen_saturation_update(sample);
-
-  } else if(sensors_cmd_respiration_sample_event(event)) {
-    sensor = "respiration";
-    min_threshold = ALARM_RESPIRATION_MIN_THRESHOLD;
-    max_threshold = ALARM_RESPIRATION_MAX_THRESHOLD;
-    res_respiration_update(sample);
-
-  } else if(sensors_cmd_temperature_sample_event(event)) {
-    sensor = "temperature";
-    min_threshold = ALARM_TEMPERATURE_MIN_THRESHOLD;
-    max_threshold = ALARM_TEMPERATURE_MAX_THRESHOLD;
-    res_temperature_update(sample);
-
-  } else {
-    LOG_ERR("Dropping a sample from an unhandled sensor process.\n");
+  if(!monitor.rd_refreshing && monitor.request_succeeded && monitor.registration_more_blocks) {
+    monitor.registration_block++;
+    send_rd_request();
     return;
   }
 
-  if(alarming_sample(min_threshold, max_threshold, sample)) {
-    bool alarm_state_changed;
-
-    LOG_INFO("Alarming %s sample detected: %d. Min threshold: %d, max threshold: %d\n",
-             sensor, sample, min_threshold, max_threshold);
-    LOG_INFO("Starting the alarm.\n");
-
-    alarm_state_changed = alarm_start(&monitor.alarm);
-    if(alarm_state_changed) {
-      res_alarm_state_update(ALARM_ON);
-    }
-  }
+  schedule_registration(monitor.request_succeeded);
+}
+/*---------------------------------------------------------------------------*/
+/* Callback function used by COAP_BLOCKING_REQUEST() for the blocks of the registration. */
+static void
+handle_registration_response(coap_message_t *response)
+{
+  monitor.request_succeeded = coap_rd_handle_registration_response(response, monitor.registration_block);
 }
 /*---------------------------------------------------------------------------*/
 /**
@@ -347,23 +339,35 @@ static void
 init_monitor()
 {
   monitor.state = COAP_MONITOR_STATE_STARTED;
-
-  /* Initialize the alarm system. */
-  alarm_init(&monitor.alarm);
-
-  /* Initialize the collector endpoint. */
+  rd_response_event = process_alloc_event();
+
+  /* Initialize the alarm system, its history and the patient ID. */
+  monitor_core_init(&monitor.core, &coap_transport, &coap_vital_signs_monitor);
+  sample_history_init(&monitor.sample_history);
+  coap_lazy_sampling_init(&coap_vital_signs_monitor);
+
+  /* Initialize the collector endpoint and the backoff of the registration attempts. */
+  backoff_init(&monitor.registration_backoff,
+               MONITOR_CORE_BACKOFF_INITIAL_WINDOW*CLOCK_SECOND,
+               MONITOR_CORE_BACKOFF_BASE_DELAY*CLOCK_SECOND,
+               MONITOR_CORE_BACKOFF_MAX_DELAY*CLOCK_SECOND);
   coap_endpoint_parse(COAP_MONITOR_COLLECTOR_ENDPOINT,
                       strlen(COAP_MONITOR_COLLECTOR_ENDPOINT),
                       &monitor.collector_endpoint);
+  coap_push_init(&monitor.collector_endpoint, &monitor.sample_history);
 
   /* Activate the resources. */
   res_registered_patient_activate();
-  res_alarm_state_activate(&monitor.alarm);
-  res_heart_rate_activate();
-  res_blood_pressure_activate();
-  res_temperature_activate();
-  res_respiration_activate();
-  res_oxygen_saturation_activate();
+  res_alarm_state_activate(&monitor.core);
+#ifdef SMART_ICU_MULTICAST
+  res_alarm_group_activate();
+#endif
+  res_alarm_history_activate(&monitor.core.alarm_history);
+  res_patient_state_activate(&monitor.core.alarm, &monitor.sample_history);
+  res_sample_history_activate(&monitor.sample_history);
+  res_sensor_activate();
+  res_config_activate();
+  res_diagnostics_activate();
 
   /* Initialize the periodic timer to check the network connectivity. */
   monitor.network_check_interval = COAP_MONITOR_NETWORK_CHECK_INTERVAL*CLOCK_SECOND;
@@ -377,9 +381,8 @@ init_monitor()
 static void
 finish_monitor()
 {
-  sensors_cmd_stop_sampling();
-  sensors_cmd_stop_processes();
-  alarm_stop(&monitor.alarm);
+  coap_lazy_sampling_disable();
+  monitor_core_finish(&monitor.core);
 }
 /*---------------------------------------------------------------------------*/
 /*
@@ -394,6 +397,7 @@ finish_monitor()
  * re-inserted pressing the button of the monitor for at least 10 seconds.
  * If the alarm system is triggered, the alarm state can be turned off by
  * pressing the same button for at least 5 seconds.
+ * The events recorded in the binary log are printed by sending "log" on the serial line.
  */
 PROCESS(coap_vital_signs_monitor, "CoAP vital signs monitor");
 AUTOSTART_PROCESSES(&coap_vital_signs_monitor);
@@ -408,39 +412,79 @@ PROCESS_THREAD(coap_vital_signs_monitor, ev, data)
   while(true) {
     PROCESS_WAIT_EVENT();
 
-    if(ev == PROCESS_EVENT_TIMER) {
+    if(ev == PROCESS_EVENT_TIMER && data == &monitor.network_check_timer) {
+      /* The registration is scheduled by handle_state_network_ready(), and sent when its timer expires. */
       if(monitor.state == COAP_MONITOR_STATE_STARTED) {
         handle_state_started();
+        if(monitor.state == COAP_MONITOR_STATE_NETWORK_READY) {
+          handle_state_network_ready();
+        }
+        continue;
       }
 
-      if(monitor.state == COAP_MONITOR_STATE_NETWORK_READY) {
-        handle_state_network_ready();
-
-        /*
-         * The registration message is placed in the output buffer by handle_state_network_ready().
-         * This is done because COAP_BLOCKING_REQUEST() must be in the main process body to work correctly.
-         */
-        COAP_BLOCKING_REQUEST(&monitor.collector_endpoint,&monitor.registration_request, handle_registration_response);
+      /*
+       * Once registered, the monitor refreshes its registration, or registers again if the
+       * directory forgot it, without blocking the process (see send_rd_request()).
+       */
+      if(monitor.state != COAP_MONITOR_STATE_REGISTRATION_PENDING) {
+        monitor.registration_block = 0;
+        send_rd_request();
+        continue;
       }
 
-      /* COAP_MONITOR_STATE_REGISTRATION_FAILED is set by handle_registration_response(). */
-      if(monitor.state == COAP_MONITOR_STATE_REGISTRATION_FAILED) {
-        break;
+      /*
+       * The first registration blocks the process, which has nothing else to handle before it.
+       * The requests are sent from here because COAP_BLOCKING_REQUEST() must be in the main
+       * process body to work correctly.
+       */
+      monitor.registration_block = 0;
+      do {
+        monitor.registration_more_blocks = coap_rd_prepare_registration(&monitor.registration_request,
+                                                                        monitor.registration_block);
+        LOG_INFO("Sending the block %lu of the registration to the endpoint %s/%s.\n",
+                 (unsigned long)monitor.registration_block,
+                 COAP_MONITOR_COLLECTOR_ENDPOINT,
+                 COAP_MONITOR_COLLECTOR_RD_RESOURCE);
+
+        /* The flag is set by handle_registration_response(), which is not called if the request cannot be sent. */
+        monitor.request_succeeded = false;
+        COAP_BLOCKING_REQUEST(&monitor.collector_endpoint, &monitor.registration_request, handle_registration_response);
+        monitor.registration_block++;
+      } while(monitor.request_succeeded && monitor.registration_more_blocks);
+      schedule_registration(monitor.request_succeeded);
+
+      /* After the first registration, start the sensor processes and wait for a patient ID. */
+      if(monitor.request_succeeded) {
+        update_patient_state(monitor_core_start(&monitor.core));
       }
+      continue;
+    }
+
+    if(ev == rd_response_event) {
+      handle_rd_request_end();
+      continue;
+    }
+
+    /* The event log can be dumped in any state, so the command is never taken for a patient ID. */
+    if(ev == serial_line_event_message && monitor_log_handle_serial_line((char *)data)) {
+      continue;
     }
 
     if(ev == serial_line_event_message && monitor.state == COAP_MONITOR_STATE_WAITING_PATIENT_ID) {
-      handle_new_patient_ID((char*)data);
+      monitor_core_set_patient_id(&monitor.core, (char*)data);
+      update_patient_state(true);
       continue;
     }
 
     if(ev == button_hal_periodic_event && monitor.state == COAP_MONITOR_STATE_OPERATIONAL) {
-      handle_button_press((button_hal_button_t *)data);
+      if(monitor_core_handle_button_press(&monitor.core, (button_hal_button_t *)data)) {
+        update_patient_state(monitor_core_wait_patient_id(&monitor.core));
+      }
       continue;
     }
 
     if(sensors_cmd_sample_event(ev) && monitor.state == COAP_MONITOR_STATE_OPERATIONAL) {
-      handle_sensor_sample(ev, *((int *)data));
+      monitor_core_handle_sample(&monitor.core, ev, *((int *)data));
       continue;
     }
   }
@@ -1,23 +1,37 @@
 #ifndef __PROJECT_CONF_H
 #define __PROJECT_CONF_H
 
-/* Log levels. */
-#define LOG_LEVEL_HEART_RATE_SENSOR          LOG_LEVEL_INFO
-#define LOG_LEVEL_BLOOD_PRESSURE_SENSOR      LOG_LEVEL_INFO
-#define LOG_LEVEL_TEMPERATURE_SENSOR         LOG_LEVEL_INFO
-#define LOG_LEVEL_RESPIRATION_SENSOR         LOG_LEVEL_INFO
-#define LOG_LEVEL_OXYGEN_SATURATION_SENSOR   LOG_LEVEL_INFO
-#define LOG_LEVEL_ALARM_SYSTEM               LOG_LEVEL_INFO
-#define LOG_LEVEL_COAP_MONITOR               LOG_LEVEL_DBG
-#define LOG_LEVEL_COAP_RESOURCES             LOG_LEVEL_DBG
+/*
+ * Log levels: the highest level compiled in for each module, lowered at runtime to the
+ * level set by the collector, LOG_LEVEL_INFO by default (see common/monitor-log.h).
+ */
+#include "../common/monitor-log.h"
+#define LOG_LEVEL_HEART_RATE_SENSOR          MONITOR_LOG_LEVEL(MONITOR_LOG_SENSORS, LOG_LEVEL_DBG)
+#define LOG_LEVEL_BLOOD_PRESSURE_SENSOR      MONITOR_LOG_LEVEL(MONITOR_LOG_SENSORS, LOG_LEVEL_DBG)
+#define LOG_LEVEL_TEMPERATURE_SENSOR         MONITOR_LOG_LEVEL(MONITOR_LOG_SENSORS, LOG_LEVEL_DBG)
+#define LOG_LEVEL_RESPIRATION_SENSOR         MONITOR_LOG_LEVEL(MONITOR_LOG_SENSORS, LOG_LEVEL_DBG)
+#define LOG_LEVEL_OXYGEN_SATURATION_SENSOR   MONITOR_LOG_LEVEL(MONITOR_LOG_SENSORS, LOG_LEVEL_DBG)
+#define LOG_LEVEL_ALARM_SYSTEM               MONITOR_LOG_LEVEL(MONITOR_LOG_ALARM_SYSTEM, LOG_LEVEL_INFO)
+#define LOG_LEVEL_MONITOR_CORE               MONITOR_LOG_LEVEL(MONITOR_LOG_MONITOR_CORE, LOG_LEVEL_INFO)
+#define LOG_LEVEL_TIME_SYNC                  MONITOR_LOG_LEVEL(MONITOR_LOG_TIME_SYNC, LOG_LEVEL_INFO)
+#define LOG_LEVEL_MONITOR_CONFIG             MONITOR_LOG_LEVEL(MONITOR_LOG_MONITOR_CONFIG, LOG_LEVEL_INFO)
+#define LOG_LEVEL_COAP_MONITOR               MONITOR_LOG_LEVEL(MONITOR_LOG_TRANSPORT, LOG_LEVEL_DBG)
+#define LOG_LEVEL_COAP_RESOURCES             MONITOR_LOG_LEVEL(MONITOR_LOG_COAP_RESOURCES, LOG_LEVEL_DBG)
 
 /* PAN ID configuration. */
 #undef IEEE802154_CONF_PANID
 #define IEEE802154_CONF_PANID 0x0041
 
-/* Set the max CoAP response payload before enabling fragmentation. */
+/* Energest accounts for the CPU and radio times reported to the collector (see monitor-diagnostics). */
+#define ENERGEST_CONF_ON 1
+
+/*
+ * Set the max CoAP payload before enabling fragmentation. It must be a power of two between
+ * 16 and 1024, the block size of the blockwise transfers: a sample with its absolute
+ * timestamp in milliseconds takes up to about 70 bytes, so 64 is not enough.
+ */
 #undef REST_MAX_CHUNK_SIZE
-#define REST_MAX_CHUNK_SIZE 64
+#define REST_MAX_CHUNK_SIZE 128
 
 /* Set the maximum number of CoAP concurrent transactions. */
 #undef COAP_MAX_OPEN_TRANSACTIONS
@@ -27,6 +41,16 @@
 #undef COAP_MAX_OBSERVERS
 #define COAP_MAX_OBSERVERS 7
 
+/* Store the whole path of the observed resources, so that the observers are matched exactly. */
+#undef COAP_OBSERVER_URL_LEN
+#define COAP_OBSERVER_URL_LEN 32
+
+/* Multicast forwarding of the group commands of the collector (enabled with "make MULTICAST=1"). */
+#ifdef SMART_ICU_MULTICAST
+#include "net/ipv6/multicast/uip-mcast6-engines.h"
+#define UIP_MCAST6_CONF_ENGINE UIP_MCAST6_ENGINE_ESMRF
+#endif
+
 /* IPv6 parameters to reduce OS size. */
 #undef NBR_TABLE_CONF_MAX_NEIGHBORS
 #define NBR_TABLE_CONF_MAX_NEIGHBORS 10
@@ -0,0 +1,74 @@
+/**
+ * \file
+ *         Implementation of the alarm group resource
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \addtogroup res-alarm-group
+ * @{
+ */
+
+#include "contiki.h"
+#include "os/sys/log.h"
+#include "os/net/ipv6/uiplib.h"
+#include "os/net/ipv6/uip-ds6.h"
+#include "os/net/app-layer/coap/coap-engine.h"
+#include "../utils/coap-monitor-constants.h"
+#include "./res-alarm-group.h"
+#include "./res-alarm-state.h"
+
+#define LOG_MODULE "Resource " COAP_MONITOR_ALARM_GROUP_RESOURCE
+#define LOG_LEVEL LOG_LEVEL_COAP_RESOURCES
+
+static void put_handler(coap_message_t *request, coap_message_t *response, uint8_t *buffer,
+                        uint16_t preferred_size, int32_t *offset);
+
+RESOURCE(res_alarm_group,
+         "title =\"Alarm group\"",
+         NULL,
+         NULL,
+         put_handler,
+         NULL);
+
+/*---------------------------------------------------------------------------*/
+static void
+put_handler(coap_message_t *request, coap_message_t *response, uint8_t *buffer,
+            uint16_t preferred_size, int32_t *offset)
+{
+  coap_status_t status;
+
+  LOG_DBG("Handling a PUT request.\n");
+  status = res_alarm_state_handle_command(request);
+
+  /*
+   * The commands sent to the multicast group are NON and are not answered, otherwise
+   * the responses of all the monitors would reach the collector at the same time.
+   * The outcome is anyway notified to the collector through the alarm state.
+   */
+  if(request->type == COAP_TYPE_NON) {
+    coap_status_code = MANUAL_RESPONSE;
+    return;
+  }
+
+  coap_set_status_code(response, status);
+}
+/*---------------------------------------------------------------------------*/
+void
+res_alarm_group_activate(void)
+{
+  uip_ipaddr_t group_address;
+
+  LOG_DBG("Activating the resource.\n");
+  uiplib_ip6addrconv(COAP_MONITOR_ALARM_GROUP_ADDRESS, &group_address);
+  if(uip_ds6_maddr_add(&group_address) == NULL) {
+    LOG_ERR("Failed to join the multicast group %s.\n", COAP_MONITOR_ALARM_GROUP_ADDRESS);
+    return;
+  }
+
+  LOG_INFO("Joined the multicast group %s.\n", COAP_MONITOR_ALARM_GROUP_ADDRESS);
+  coap_activate_resource(&res_alarm_group, COAP_MONITOR_ALARM_GROUP_RESOURCE);
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
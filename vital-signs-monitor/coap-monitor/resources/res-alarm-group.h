@@ -0,0 +1,30 @@
+/**
+ * \file
+ *         Header file for the alarm group resource
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \defgroup res-alarm-group Alarm group resource
+ * @{
+ *
+ * The res-alarm-group module provides the implementation of a CoAP resource
+ * receiving the alarm commands that the collector sends at once to all the
+ * monitors, through the site-local multicast group joined by the monitor.
+ */
+
+#ifndef SMART_ICU_RES_ALARM_GROUP_H
+#define SMART_ICU_RES_ALARM_GROUP_H
+
+/**
+ * \brief   Activate the alarm group resource.
+ *
+ *          This function activates the alarm group resource and joins
+ *          the multicast group to which the alarm commands are sent.
+ *          The alarm state resource must be already activated.
+ */
+void res_alarm_group_activate(void);
+
+#endif /* SMART_ICU_RES_ALARM_GROUP_H */
+/** @} */
@@ -0,0 +1,86 @@
+/**
+ * \file
+ *         Implementation of the alarm history resource
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \addtogroup res-alarm-history
+ * @{
+ */
+
+#include "contiki.h"
+#include "os/sys/log.h"
+#include "os/net/app-layer/coap/coap-engine.h"
+#include "../../common/json-message.h"
+#include "../utils/coap-monitor-constants.h"
+#include "../utils/coap-query.h"
+#include "./res-alarm-history.h"
+
+#define LOG_MODULE "Resource " COAP_MONITOR_ALARM_HISTORY_RESOURCE
+#define LOG_LEVEL LOG_LEVEL_COAP_RESOURCES
+
+static void get_handler(coap_message_t *request, coap_message_t *response, uint8_t *buffer,
+                        uint16_t preferred_size, int32_t *offset);
+
+/* Resource value. */
+static struct alarm_history *alarm_history;
+
+/*
+ * Buffer holding the whole representation of the resource. The representation is
+ * generated again for each block, so that no state is kept between two block requests.
+ */
+static char representation[COAP_MONITOR_ALARM_HISTORY_BUFFER_SIZE];
+
+RESOURCE(res_alarm_history,
+         "title =\"Alarm history\"",
+         get_handler,
+         NULL,
+         NULL,
+         NULL);
+
+/*---------------------------------------------------------------------------*/
+static void
+get_handler(coap_message_t *request, coap_message_t *response, uint8_t *buffer,
+            uint16_t preferred_size, int32_t *offset)
+{
+  int length;
+  int chunk_length;
+
+  /* Prepare the message. */
+  LOG_DBG("Handling a GET request. Offset: %ld.\n", (long)*offset);
+  length = json_message_alarm_history(representation,
+                                      COAP_MONITOR_ALARM_HISTORY_BUFFER_SIZE,
+                                      alarm_history,
+                                      coap_query_get_uint(request, "since", 0));
+
+  if(*offset >= length) {
+    LOG_DBG("Block out of scope.\n");
+    coap_set_status_code(response, BAD_OPTION_4_02);
+    return;
+  }
+
+  /* Send the requested block of the representation. */
+  chunk_length = MIN(length - *offset, preferred_size);
+  memcpy(buffer, representation + *offset, chunk_length);
+  coap_set_header_content_format(response, APPLICATION_JSON);
+  coap_set_payload(response, buffer, chunk_length);
+  coap_set_status_code(response, CONTENT_2_05);
+
+  /* Signal the chunk awareness to the CoAP engine, and the end of the representation. */
+  *offset += chunk_length;
+  if(*offset >= length) {
+    *offset = -1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+res_alarm_history_activate(struct alarm_history *history)
+{
+  LOG_DBG("Activating the resource.\n");
+  alarm_history = history;
+  coap_activate_resource(&res_alarm_history, COAP_MONITOR_ALARM_HISTORY_RESOURCE);
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
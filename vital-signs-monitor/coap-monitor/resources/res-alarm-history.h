@@ -0,0 +1,32 @@
+/**
+ * \file
+ *         Header file for the alarm history resource
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \defgroup res-alarm-history Alarm history resource
+ * @{
+ *
+ * The res-alarm-history module provides the implementation of a CoAP resource
+ * representing the last transitions of the alarm system of the vital signs monitor.
+ * A GET request can carry the query variable <code>since=&lt;seq&gt;</code> to retrieve only
+ * the events whose sequence number is greater than or equal to <code>seq</code>.
+ * The representation is larger than a CoAP block, so it is transferred using
+ * block-wise transfers.
+ */
+
+#ifndef SMART_ICU_RES_ALARM_HISTORY_H
+#define SMART_ICU_RES_ALARM_HISTORY_H
+
+#include "../../common/alarm-history.h"
+
+/**
+ * \brief           Activate the alarm history resource.
+ * \param history   A pointer to the alarm history of the monitor.
+ */
+void res_alarm_history_activate(struct alarm_history *history);
+
+#endif /* SMART_ICU_RES_ALARM_HISTORY_H */
+/** @} */
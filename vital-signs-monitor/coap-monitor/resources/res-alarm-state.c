@@ -15,7 +15,11 @@
 #include "os/net/app-layer/coap/coap-engine.h"
 #include "../../common/json-message.h"
 #include "../utils/coap-monitor-constants.h"
+#include "../utils/coap-notification.h"
+#include "../utils/coap-etag.h"
+#include "../utils/coap-lazy-sampling.h"
 #include "./res-alarm-state.h"
+#include "./res-patient-state.h"
 
 #define LOG_MODULE "Resource " COAP_MONITOR_ALARM_STATE_RESOURCE
 #define LOG_LEVEL LOG_LEVEL_COAP_RESOURCES
@@ -28,7 +32,11 @@ static void put_handler(coap_message_t *request, coap_message_t *response, uint8
 
 /* Resource value. */
 static alarm_state current_alarm_state;
-static struct alarm_system *alarm_system;
+static uint32_t version;
+static struct monitor_core *monitor_core;
+
+/* Policy choosing the type of the notifications. */
+static struct coap_notification_policy notification_policy;
 
 EVENT_RESOURCE(res_alarm_state,
                "title =\"Alarm state\";obs",
@@ -46,9 +54,18 @@ get_handler(coap_message_t *request, coap_message_t *response, uint8_t *buffer,
   char message[COAP_MONITOR_RESOURCE_OUTPUT_BUFFER_SIZE];
   int length;
 
-  /* Prepare the message. */
+  /* The alarm state depends on the samples of all the sensors, which are resumed if paused. */
   LOG_DBG("Handling a GET request.\n");
+  if(offset != NULL) {
+    coap_lazy_sampling_request(SENSOR_NONE);
+  }
+
+  /* A client already holding the current representation does not get it again. */
+  if(coap_etag_validate(request, response, version)) {
+    return;
+  }
 
+  /* Prepare the message. */
   if(current_alarm_state == ALARM_ON) {
     json_message_alarm_started(message, COAP_MONITOR_RESOURCE_OUTPUT_BUFFER_SIZE);
   } else {
@@ -60,56 +77,77 @@ get_handler(coap_message_t *request, coap_message_t *response, uint8_t *buffer,
   /* Send the response. */
   memcpy(buffer, message, length);
   coap_set_header_content_format(response, APPLICATION_JSON);
-  coap_set_header_etag(response, (uint8_t *)&length, 1);
   coap_set_payload(response, buffer, length);
   coap_set_status_code(response, CONTENT_2_05);
+
+  /* Notifications of the alarm state are always CON. */
+  if(offset == NULL) {
+    coap_notification_set_type(response, &notification_policy, true);
+  }
 }
 /*---------------------------------------------------------------------------*/
 static void
 put_handler(coap_message_t *request, coap_message_t *response, uint8_t *buffer,
             uint16_t preferred_size, int32_t *offset)
+{
+  LOG_DBG("Handling a PUT request.\n");
+  coap_set_status_code(response, res_alarm_state_handle_command(request));
+}
+/*---------------------------------------------------------------------------*/
+static void
+event_handler(void)
+{
+  LOG_DBG("Notifying the observers.\n");
+  coap_notify_observers(&res_alarm_state);
+}
+/*---------------------------------------------------------------------------*/
+void
+res_alarm_state_activate(struct monitor_core *core)
+{
+  LOG_DBG("Activating the resource.\n");
+  coap_notification_policy_init(&notification_policy);
+  coap_etag_init(&version);
+  monitor_core = core;
+  current_alarm_state = monitor_core->alarm.state;
+  coap_activate_resource(&res_alarm_state, COAP_MONITOR_ALARM_STATE_RESOURCE);
+}
+/*---------------------------------------------------------------------------*/
+coap_status_t
+res_alarm_state_handle_command(coap_message_t *request)
 {
   const uint8_t *request_payload = NULL;
   char turn_on_alarm_msg[COAP_MONITOR_INPUT_BUFFER_SIZE];
   char turn_off_alarm_msg[COAP_MONITOR_INPUT_BUFFER_SIZE];
 
-  LOG_DBG("Handling a PUT request.\n");
   json_message_alarm_started(turn_on_alarm_msg, COAP_MONITOR_INPUT_BUFFER_SIZE);
-  json_message_alarm_started(turn_off_alarm_msg, COAP_MONITOR_INPUT_BUFFER_SIZE);
+  json_message_alarm_stopped(turn_off_alarm_msg, COAP_MONITOR_INPUT_BUFFER_SIZE);
   coap_get_payload(request, &request_payload);
 
   if(strcmp(turn_on_alarm_msg, (const char*)request_payload) == 0) {
-    LOG_DBG("PUT request for turning on the alarm.\n");
-    alarm_start(alarm_system);
-    current_alarm_state = ALARM_ON;
-    coap_set_status_code(response, CREATED_2_01);
-    return;
+    LOG_DBG("Command for turning on the alarm.\n");
+    if(monitor_core_start_alarm(monitor_core)) {
+      res_patient_state_alarm_changed();
+    }
+    if(current_alarm_state != ALARM_ON) {
+      current_alarm_state = ALARM_ON;
+      coap_etag_update(&version);
+    }
+    return CREATED_2_01;
   }
 
   if(strcmp(turn_off_alarm_msg, (const char*)request_payload) == 0) {
-    LOG_DBG("Turning off the alarm via PUT requests is currently not supported.\n");
-    coap_set_status_code(response, NOT_IMPLEMENTED_5_01);
-    return;
+    LOG_DBG("Turning off the alarm via commands is currently not supported.\n");
+    return NOT_IMPLEMENTED_5_01;
   }
 
-  LOG_DBG("Unrecognized format of the PUT request.\n");
-  coap_set_status_code(response, BAD_REQUEST_4_00);
+  LOG_DBG("Unrecognized format of the command.\n");
+  return BAD_REQUEST_4_00;
 }
 /*---------------------------------------------------------------------------*/
-static void
-event_handler(void)
+bool
+res_alarm_state_observed(void)
 {
-  LOG_DBG("Notifying the observers.\n");
-  coap_notify_observers(&res_alarm_state);
-}
-/*---------------------------------------------------------------------------*/
-void
-res_alarm_state_activate(struct alarm_system *alarm)
-{
-  LOG_DBG("Activating the resource.\n");
-  alarm_system = alarm;
-  current_alarm_state = alarm_system->state;
-  coap_activate_resource(&res_alarm_state, COAP_MONITOR_ALARM_STATE_RESOURCE);
+  return coap_notification_observed(COAP_MONITOR_ALARM_STATE_RESOURCE);
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -118,6 +156,7 @@ res_alarm_state_update
 {
   LOG_DBG("Updating the resource value.\n");
   current_alarm_state = alarm_state;
+  coap_etag_update(&version);
   res_alarm_state.trigger();
 }
 /*---------------------------------------------------------------------------*/
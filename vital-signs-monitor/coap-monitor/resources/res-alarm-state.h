@@ -15,20 +15,22 @@
 
 #include <stdbool.h>
 #include "../../common/alarm.h"
+#include "../../common/monitor-core.h"
+#include "os/net/app-layer/coap/coap.h"
 
 #ifndef SMART_ICU_RES_ALARM_STATE_H
 #define SMART_ICU_RES_ALARM_STATE_H
 
 /**
- * \brief         Activate the alarm state resource.
- * \param alarm   A pointer to the alarm system.
+ * \brief        Activate the alarm state resource.
+ * \param core   A pointer to the monitor core.
  *
- *                This function activates the alarm state resource.
- *                The pointer to the alarm system is needed
- *                to ensure that a PUT targeting this resource
- *                turns on the alarm.
+ *               This function activates the alarm state resource.
+ *               The pointer to the monitor core is needed
+ *               to ensure that a PUT targeting this resource
+ *               turns on the alarm and records the transition.
  */
-void res_alarm_state_activate(struct alarm_system *alarm);
+void res_alarm_state_activate(struct monitor_core *core);
 
 /**
  * \brief               Update the alarm state resource.
@@ -39,5 +41,22 @@ void res_alarm_state_activate(struct alarm_system *alarm);
  */
 void res_alarm_state_update(alarm_state alarm_state);
 
+/**
+ * \brief           Handle a command targeting the alarm system.
+ * \param request   The PUT request carrying the command.
+ * \return          The response code of the command.
+ *
+ *                  This function turns on the alarm if the payload of the request
+ *                  asks for it, updating the alarm state resource. It serves both
+ *                  the alarm state resource and the alarm group resource.
+ */
+coap_status_t res_alarm_state_handle_command(coap_message_t *request);
+
+/**
+ * \brief    Check if the alarm state resource has observers.
+ * \return   true if the resource has at least an observer, false otherwise.
+ */
+bool res_alarm_state_observed(void);
+
 #endif /* SMART_ICU_RES_ALARM_STATE_H */
 /** @} */
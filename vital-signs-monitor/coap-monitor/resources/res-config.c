@@ -0,0 +1,99 @@
+/**
+ * \file
+ *         Implementation of the configuration resource
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \addtogroup res-config
+ * @{
+ */
+
+#include "contiki.h"
+#include "os/sys/log.h"
+#include "os/net/app-layer/coap/coap-engine.h"
+#include "../../common/monitor-config.h"
+#include "../utils/coap-monitor-constants.h"
+#include "./res-config.h"
+
+#define LOG_MODULE "Resource " COAP_MONITOR_CONFIG_RESOURCE
+#define LOG_LEVEL LOG_LEVEL_COAP_RESOURCES
+
+static void get_handler(coap_message_t *request, coap_message_t *response, uint8_t *buffer,
+                        uint16_t preferred_size, int32_t *offset);
+static void post_put_handler(coap_message_t *request, coap_message_t *response, uint8_t *buffer,
+                             uint16_t preferred_size, int32_t *offset);
+
+/*
+ * Buffer holding the whole representation of the resource, which does not fit in a single block.
+ * The representation is generated with the first block and the following blocks are taken from it.
+ */
+static char representation[MONITOR_CONFIG_MAX_LENGTH];
+static int representation_length;
+
+RESOURCE(res_config,
+         "title =\"Configuration\"",
+         get_handler,
+         post_put_handler,
+         post_put_handler,
+         NULL);
+
+/*---------------------------------------------------------------------------*/
+static void
+get_handler(coap_message_t *request, coap_message_t *response, uint8_t *buffer,
+            uint16_t preferred_size, int32_t *offset)
+{
+  int chunk_length;
+
+  LOG_DBG("Handling a GET request. Offset: %ld.\n", (long)*offset);
+  if(*offset == 0) {
+    representation_length = MIN(monitor_config_snprint(representation, MONITOR_CONFIG_MAX_LENGTH),
+                                MONITOR_CONFIG_MAX_LENGTH - 1);
+  }
+
+  if(*offset >= representation_length) {
+    LOG_DBG("Block out of scope.\n");
+    coap_set_status_code(response, BAD_OPTION_4_02);
+    return;
+  }
+
+  /* Send the requested block of the representation. */
+  chunk_length = MIN(representation_length - *offset, preferred_size);
+  memcpy(buffer, representation + *offset, chunk_length);
+  coap_set_header_content_format(response, TEXT_PLAIN);
+  coap_set_payload(response, buffer, chunk_length);
+  coap_set_status_code(response, CONTENT_2_05);
+
+  /* Signal the chunk awareness to the CoAP engine, and the end of the representation. */
+  *offset += chunk_length;
+  if(*offset >= representation_length) {
+    *offset = -1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+post_put_handler(coap_message_t *request, coap_message_t *response, uint8_t *buffer,
+                 uint16_t preferred_size, int32_t *offset)
+{
+  const uint8_t *payload = NULL;
+  int length;
+
+  LOG_DBG("Handling a configuration command.\n");
+  length = coap_get_payload(request, &payload);
+  if(length == 0 || !monitor_config_apply((const char *)payload, length)) {
+    coap_set_status_code(response, BAD_REQUEST_4_00);
+    return;
+  }
+  coap_set_status_code(response, CHANGED_2_04);
+}
+/*---------------------------------------------------------------------------*/
+void
+res_config_activate(void)
+{
+  LOG_DBG("Activating the resource.\n");
+  representation_length = 0;
+  coap_activate_resource(&res_config, COAP_MONITOR_CONFIG_RESOURCE);
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
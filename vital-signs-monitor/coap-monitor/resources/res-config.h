@@ -0,0 +1,27 @@
+/**
+ * \file
+ *         Header file for the configuration resource
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \defgroup res-config Configuration resource
+ * @{
+ *
+ * The res-config module provides the implementation of a CoAP resource
+ * representing the runtime configuration of the monitor (see monitor-config).
+ * A GET returns the current configuration, in the format of the configuration
+ * commands, while a POST or a PUT applies the command carried in its payload.
+ */
+
+#ifndef SMART_ICU_RES_CONFIG_H
+#define SMART_ICU_RES_CONFIG_H
+
+/**
+ * \brief   Activate the configuration resource.
+ */
+void res_config_activate(void);
+
+#endif /* SMART_ICU_RES_CONFIG_H */
+/** @} */
@@ -0,0 +1,121 @@
+/**
+ * \file
+ *         Implementation of the diagnostics resource
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \addtogroup res-diagnostics
+ * @{
+ */
+
+#include <string.h>
+#include "contiki.h"
+#include "os/sys/log.h"
+#include "os/net/app-layer/coap/coap-engine.h"
+#include "../../common/json-message.h"
+#include "../utils/coap-monitor-constants.h"
+#include "../utils/coap-etag.h"
+#include "./res-diagnostics.h"
+
+#define LOG_MODULE "Resource " COAP_MONITOR_DIAGNOSTICS_RESOURCE
+#define LOG_LEVEL LOG_LEVEL_COAP_RESOURCES
+
+static void event_handler(void);
+static void get_handler(coap_message_t *request, coap_message_t *response, uint8_t *buffer,
+                        uint16_t preferred_size, int32_t *offset);
+
+/*
+ * Buffer holding the whole representation of the resource, i.e. the last report. It is
+ * generated when a new report is available, so that all the blocks of a notification
+ * belong to the same report, and carry its ETag.
+ */
+static char representation[COAP_MONITOR_DIAGNOSTICS_BUFFER_SIZE];
+static int representation_length;
+static uint32_t version;
+
+EVENT_RESOURCE(res_diagnostics,
+               "title =\"Diagnostics\";obs",
+               get_handler,
+               NULL,
+               NULL,
+               NULL,
+               event_handler);
+
+/*---------------------------------------------------------------------------*/
+static void
+get_handler(coap_message_t *request, coap_message_t *response, uint8_t *buffer,
+            uint16_t preferred_size, int32_t *offset)
+{
+  int32_t block_offset;
+  int chunk_length;
+
+  /* The offset is NULL for notifications, which are generated by res_diagnostics_update(). */
+  LOG_DBG("Handling a GET request.\n");
+  block_offset = (offset == NULL) ? 0 : *offset;
+  if(offset != NULL && *offset == 0) {
+    if(coap_etag_validate(request, response, version)) {
+      return;
+    }
+  } else {
+    coap_etag_set(response, version);
+  }
+
+  if(block_offset >= representation_length) {
+    LOG_DBG("Block out of scope.\n");
+    coap_set_status_code(response, BAD_OPTION_4_02);
+    return;
+  }
+
+  /* Send the requested block of the representation. */
+  chunk_length = MIN(representation_length - block_offset, preferred_size);
+  memcpy(buffer, representation + block_offset, chunk_length);
+  coap_set_header_content_format(response, APPLICATION_JSON);
+  coap_set_payload(response, buffer, chunk_length);
+  coap_set_status_code(response, CONTENT_2_05);
+
+  if(offset == NULL) {
+    /* The engine does not handle the blocks of notifications: the observers fetch the others with GETs. */
+    if(chunk_length < representation_length) {
+      coap_set_header_block2(response, 0, 1, preferred_size);
+    }
+    return;
+  }
+
+  /* Signal the chunk awareness to the CoAP engine, and the end of the representation. */
+  *offset += chunk_length;
+  if(*offset >= representation_length) {
+    *offset = -1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+event_handler(void)
+{
+  LOG_DBG("Notifying the observers.\n");
+  coap_notify_observers(&res_diagnostics);
+}
+/*---------------------------------------------------------------------------*/
+void
+res_diagnostics_activate(void)
+{
+  struct monitor_diagnostics empty_report;
+
+  LOG_DBG("Activating the resource.\n");
+  memset(&empty_report, 0, sizeof(empty_report));
+  representation_length = json_message_diagnostics(representation, COAP_MONITOR_DIAGNOSTICS_BUFFER_SIZE, &empty_report);
+  coap_etag_init(&version);
+  coap_activate_resource(&res_diagnostics, COAP_MONITOR_DIAGNOSTICS_RESOURCE);
+}
+/*---------------------------------------------------------------------------*/
+void
+res_diagnostics_update(const struct monitor_diagnostics *report)
+{
+  LOG_DBG("Updating the resource value.\n");
+  representation_length = json_message_diagnostics(representation, COAP_MONITOR_DIAGNOSTICS_BUFFER_SIZE, report);
+  coap_etag_update(&version);
+  res_diagnostics.trigger();
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -0,0 +1,37 @@
+/**
+ * \file
+ *         Header file for the diagnostics resource
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \defgroup res-diagnostics Diagnostics resource
+ * @{
+ *
+ * The res-diagnostics module provides the implementation of a CoAP resource
+ * representing the last diagnostics report of the monitor (see monitor-diagnostics),
+ * i.e. the time spent by the CPU and the radio in each state, the longest backlog of
+ * the pushed samples, the dropped messages and the refused publications of the last period.
+ * The observers are notified of each new report. The representation is larger than
+ * a CoAP block, so it is transferred using block-wise transfers.
+ */
+
+#ifndef SMART_ICU_RES_DIAGNOSTICS_H
+#define SMART_ICU_RES_DIAGNOSTICS_H
+
+#include "../../common/monitor-diagnostics.h"
+
+/**
+ * \brief   Activate the diagnostics resource.
+ */
+void res_diagnostics_activate(void);
+
+/**
+ * \brief          Update the resource with a new report, notifying the observers.
+ * \param report   A pointer to the report.
+ */
+void res_diagnostics_update(const struct monitor_diagnostics *report);
+
+#endif /* SMART_ICU_RES_DIAGNOSTICS_H */
+/** @} */
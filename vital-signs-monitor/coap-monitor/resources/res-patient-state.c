@@ -0,0 +1,204 @@
+/**
+ * \file
+ *         Implementation of the patient state resource
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \addtogroup res-patient-state
+ * @{
+ */
+
+#include "contiki.h"
+#include "os/sys/log.h"
+#include "os/sys/ctimer.h"
+#include "os/net/app-layer/coap/coap-engine.h"
+#include "../../common/json-message.h"
+#include "../utils/coap-monitor-constants.h"
+#include "../utils/coap-notification.h"
+#include "../utils/coap-etag.h"
+#include "../utils/coap-lazy-sampling.h"
+#include "./res-patient-state.h"
+
+#define LOG_MODULE "Resource " COAP_MONITOR_PATIENT_STATE_RESOURCE
+#define LOG_LEVEL LOG_LEVEL_COAP_RESOURCES
+
+static void event_handler(void);
+static void get_handler(coap_message_t *request, coap_message_t *response, uint8_t *buffer,
+                        uint16_t preferred_size, int32_t *offset);
+
+/* Resource value. */
+static int samples[SENSORS_NUMBER];
+static uint8_t updated_samples;
+static struct alarm_system *alarm_system;
+static struct sample_history *sample_history;
+static uint32_t version;
+
+/* Timer used to coalesce the samples of the same tick in a single notification. */
+static struct ctimer notification_timer;
+
+/* Policy choosing the type of the notifications, which are CON if they carry an alarm state change. */
+static struct coap_notification_policy notification_policy;
+static bool alarm_changed;
+
+/*
+ * Buffer holding the whole representation of the resource. The representation is
+ * generated when the observers are notified, so that the blocks following the
+ * first one (requested by the observers) belong to the same notification.
+ * All the blocks carry the ETag of the representation, so that a change
+ * between two blocks can be detected.
+ */
+static char representation[COAP_MONITOR_PATIENT_STATE_BUFFER_SIZE];
+static int representation_length;
+static uint32_t representation_version;
+
+EVENT_RESOURCE(res_patient_state,
+               "title =\"Patient state\";obs",
+               get_handler,
+               NULL,
+               NULL,
+               NULL,
+               event_handler);
+
+/*---------------------------------------------------------------------------*/
+static void
+update_representation(void)
+{
+  representation_length = json_message_patient_state(representation,
+                                                     COAP_MONITOR_PATIENT_STATE_BUFFER_SIZE,
+                                                     samples,
+                                                     updated_samples,
+                                                     alarm_system->state,
+                                                     sample_history->next_seq);
+  representation_version = version;
+}
+/*---------------------------------------------------------------------------*/
+static void
+get_handler(coap_message_t *request, coap_message_t *response, uint8_t *buffer,
+            uint16_t preferred_size, int32_t *offset)
+{
+  int32_t block_offset;
+  int chunk_length;
+
+  /*
+   * The offset is NULL for notifications, which are generated by notify_observers().
+   * A request without a Block2 option gets a fresh representation, unless the
+   * client already holds the current one.
+   */
+  LOG_DBG("Handling a GET request.\n");
+  block_offset = (offset == NULL) ? 0 : *offset;
+  if(offset != NULL && *offset == 0) {
+    coap_lazy_sampling_request(SENSOR_NONE);
+    if(representation_version != version) {
+      update_representation();
+    }
+    if(coap_etag_validate(request, response, representation_version)) {
+      return;
+    }
+  } else {
+    coap_etag_set(response, representation_version);
+  }
+
+  if(block_offset >= representation_length) {
+    LOG_DBG("Block out of scope.\n");
+    coap_set_status_code(response, BAD_OPTION_4_02);
+    return;
+  }
+
+  /* Send the requested block of the representation. */
+  chunk_length = MIN(representation_length - block_offset, preferred_size);
+  memcpy(buffer, representation + block_offset, chunk_length);
+  coap_set_header_content_format(response, APPLICATION_JSON);
+  coap_set_payload(response, buffer, chunk_length);
+  coap_set_status_code(response, CONTENT_2_05);
+
+  if(offset == NULL) {
+    coap_notification_set_type(response, &notification_policy, alarm_changed);
+
+    /* The engine does not handle the blocks of notifications: the observers fetch the others with GETs. */
+    if(chunk_length < representation_length) {
+      coap_set_header_block2(response, 0, 1, preferred_size);
+    }
+    return;
+  }
+
+  /* Signal the chunk awareness to the CoAP engine, and the end of the representation. */
+  *offset += chunk_length;
+  if(*offset >= representation_length) {
+    *offset = -1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+event_handler(void)
+{
+  LOG_DBG("Notifying the observers.\n");
+  coap_notify_observers(&res_patient_state);
+}
+/*---------------------------------------------------------------------------*/
+/* Callback function used by the ctimer. */
+static void
+notify_observers(void *data)
+{
+  ctimer_stop(&notification_timer);
+  update_representation();
+  updated_samples = 0;
+  res_patient_state.trigger();
+}
+/*---------------------------------------------------------------------------*/
+void
+res_patient_state_activate(struct alarm_system *alarm, struct sample_history *history)
+{
+  int sensor;
+
+  LOG_DBG("Activating the resource.\n");
+  for(sensor = 0; sensor < SENSORS_NUMBER; sensor++) {
+    samples[sensor] = -1;
+  }
+  updated_samples = 0;
+  alarm_system = alarm;
+  sample_history = history;
+  alarm_changed = false;
+  coap_notification_policy_init(&notification_policy);
+  coap_etag_init(&version);
+  update_representation();
+  coap_activate_resource(&res_patient_state, COAP_MONITOR_PATIENT_STATE_RESOURCE);
+}
+/*---------------------------------------------------------------------------*/
+bool
+res_patient_state_observed(void)
+{
+  return coap_notification_observed(COAP_MONITOR_PATIENT_STATE_RESOURCE);
+}
+/*---------------------------------------------------------------------------*/
+void
+res_patient_state_update_sample(sensor_type sensor, int sample)
+{
+  LOG_DBG("Updating the resource value.\n");
+  samples[sensor] = sample;
+  updated_samples |= 1 << sensor;
+  coap_etag_update(&version);
+
+  /* The first sample of a tick schedules the notification. */
+  if(ctimer_expired(&notification_timer)) {
+    ctimer_set(&notification_timer,
+               COAP_MONITOR_PATIENT_STATE_NOTIFICATION_DELAY*CLOCK_SECOND,
+               notify_observers,
+               NULL);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+res_patient_state_alarm_changed(void)
+{
+  LOG_DBG("Updating the resource value.\n");
+
+  /* The samples collected so far are sent together with the new alarm state. */
+  alarm_changed = true;
+  coap_etag_update(&version);
+  notify_observers(NULL);
+  alarm_changed = false;
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -0,0 +1,67 @@
+/**
+ * \file
+ *         Header file for the patient state resource
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \defgroup res-patient-state Patient state resource
+ * @{
+ *
+ * The res-patient-state module provides the implementation of a CoAP resource
+ * representing the last samples of all the sensors of the vital signs monitor,
+ * together with the alarm state. A collector can observe this resource instead of
+ * the resources of the single sensors, using a single observe relation per monitor.
+ * The samples produced in the same sampling tick are coalesced into a single
+ * notification, while a change of the alarm state is notified immediately.
+ * The representation is larger than a CoAP block, so it is transferred using
+ * block-wise transfers. Each notification carries the sequence number following
+ * the one of the newest sample, so that a collector can detect the samples it missed
+ * and retrieve them from the sample history resource.
+ */
+
+#ifndef SMART_ICU_RES_PATIENT_STATE_H
+#define SMART_ICU_RES_PATIENT_STATE_H
+
+#include <stdbool.h>
+#include "../../common/alarm.h"
+#include "../../common/sensors-cmd.h"
+#include "../../common/sample-history.h"
+
+/**
+ * \brief           Activate the patient state resource.
+ * \param alarm     A pointer to the alarm system, whose state
+ *                  is part of the representation of the resource.
+ * \param history   A pointer to the sample history, whose next sequence
+ *                  number is part of the representation of the resource.
+ */
+void res_patient_state_activate(struct alarm_system *alarm, struct sample_history *history);
+
+/**
+ * \brief          Update a sample of the patient state resource.
+ * \param sensor   The sensor that produced the sample.
+ * \param sample   The new sample.
+ *
+ *                 This function updates the patient state resource. The observers
+ *                 are notified after COAP_MONITOR_PATIENT_STATE_NOTIFICATION_DELAY seconds,
+ *                 so that the samples of the other sensors of the same tick are sent together.
+ */
+void res_patient_state_update_sample(sensor_type sensor, int sample);
+
+/**
+ * \brief   Inform the patient state resource that the alarm state changed.
+ *
+ *          This function notifies the observers of the patient
+ *          state resource immediately.
+ */
+void res_patient_state_alarm_changed(void);
+
+/**
+ * \brief    Check if the patient state resource has observers.
+ * \return   true if the resource has at least an observer, false otherwise.
+ */
+bool res_patient_state_observed(void);
+
+#endif /* SMART_ICU_RES_PATIENT_STATE_H */
+/** @} */
@@ -14,7 +14,10 @@
 #include "os/sys/log.h"
 #include "os/net/app-layer/coap/coap-engine.h"
 #include "../../common/json-message.h"
+#include "../../common/monitor-core-constants.h"
 #include "../utils/coap-monitor-constants.h"
+#include "../utils/coap-notification.h"
+#include "../utils/coap-etag.h"
 #include "./res-registered-patient.h"
 
 #define LOG_MODULE "Resource " COAP_MONITOR_REGISTERED_PATIENT_RESOURCE
@@ -25,7 +28,11 @@ static void get_handler(coap_message_t *request, coap_message_t *response, uint8
                         uint16_t preferred_size, int32_t *offset);
 
 /* Resource value. */
-static char registeredPatient[COAP_MONITOR_PATIENT_ID_LENGTH];
+static char registeredPatient[MONITOR_CORE_PATIENT_ID_LENGTH];
+static uint32_t version;
+
+/* Policy choosing the type of the notifications. */
+static struct coap_notification_policy notification_policy;
 
 EVENT_RESOURCE(res_registered_patient,
                "title =\"Registered patient\";obs",
@@ -43,17 +50,26 @@ get_handler(coap_message_t *request, coap_message_t *response, uint8_t *buffer,
   char message[COAP_MONITOR_RESOURCE_OUTPUT_BUFFER_SIZE];
   int length;
 
-  /* Prepare the message. */
+  /* A client already holding the current representation does not get it again. */
   LOG_DBG("Handling a GET request.\n");
+  if(coap_etag_validate(request, response, version)) {
+    return;
+  }
+
+  /* Prepare the message. */
   json_message_patient_registration(message, COAP_MONITOR_RESOURCE_OUTPUT_BUFFER_SIZE, NULL, registeredPatient);
   length = sizeof(message) - 1;
 
   /* Send the response. */
   memcpy(buffer, message, length);
   coap_set_header_content_format(response, APPLICATION_JSON);
-  coap_set_header_etag(response, (uint8_t *)&length, 1);
   coap_set_payload(response, buffer, length);
   coap_set_status_code(response, CONTENT_2_05);
+
+  /* Notifications of a new patient are rare and always CON. */
+  if(offset == NULL) {
+    coap_notification_set_type(response, &notification_policy, true);
+  }
 }
 /*---------------------------------------------------------------------------*/
 static void
@@ -67,6 +83,8 @@ void
 res_registered_patient_activate(void)
 {
   LOG_DBG("Activating the resource.\n");
+  coap_notification_policy_init(&notification_policy);
+  coap_etag_init(&version);
   coap_activate_resource(&res_registered_patient, COAP_MONITOR_REGISTERED_PATIENT_RESOURCE);
 }
 /*---------------------------------------------------------------------------*/
@@ -75,9 +93,10 @@ res_registered_patient_update
 (char *patient_id)
 {
   LOG_DBG("Updating the resource value.\n");
-  memset(registeredPatient, 0, COAP_MONITOR_PATIENT_ID_LENGTH);
-  memcpy(registeredPatient, patient_id, COAP_MONITOR_PATIENT_ID_LENGTH);
-  registeredPatient[COAP_MONITOR_PATIENT_ID_LENGTH - 1] = '\0';
+  memset(registeredPatient, 0, MONITOR_CORE_PATIENT_ID_LENGTH);
+  memcpy(registeredPatient, patient_id, MONITOR_CORE_PATIENT_ID_LENGTH);
+  registeredPatient[MONITOR_CORE_PATIENT_ID_LENGTH - 1] = '\0';
+  coap_etag_update(&version);
   res_registered_patient.trigger();
 }
 /*---------------------------------------------------------------------------*/
@@ -0,0 +1,95 @@
+/**
+ * \file
+ *         Implementation of the sample history resource
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \addtogroup res-sample-history
+ * @{
+ */
+
+#include "contiki.h"
+#include "os/sys/log.h"
+#include "os/net/app-layer/coap/coap-engine.h"
+#include "../../common/json-message.h"
+#include "../utils/coap-monitor-constants.h"
+#include "../utils/coap-query.h"
+#include "./res-sample-history.h"
+
+#define LOG_MODULE "Resource " COAP_MONITOR_SAMPLE_HISTORY_RESOURCE
+#define LOG_LEVEL LOG_LEVEL_COAP_RESOURCES
+
+static void get_handler(coap_message_t *request, coap_message_t *response, uint8_t *buffer,
+                        uint16_t preferred_size, int32_t *offset);
+
+/* Resource value. */
+static struct sample_history *sample_history;
+
+/*
+ * Buffer holding the whole representation of the resource. Since new samples can be
+ * recorded between two block requests, the representation is generated with the first
+ * block and the following blocks are taken from it, unless the query changes.
+ */
+static char representation[COAP_MONITOR_SAMPLE_HISTORY_BUFFER_SIZE];
+static int representation_length;
+static uint32_t representation_since;
+
+RESOURCE(res_sample_history,
+         "title =\"Sample history\"",
+         get_handler,
+         NULL,
+         NULL,
+         NULL);
+
+/*---------------------------------------------------------------------------*/
+static void
+get_handler(coap_message_t *request, coap_message_t *response, uint8_t *buffer,
+            uint16_t preferred_size, int32_t *offset)
+{
+  uint32_t since;
+  int chunk_length;
+
+  LOG_DBG("Handling a GET request. Offset: %ld.\n", (long)*offset);
+  since = coap_query_get_uint(request, "since", 0);
+  if(*offset == 0 || since != representation_since) {
+    representation_length = json_message_sample_history(representation,
+                                                        COAP_MONITOR_SAMPLE_HISTORY_BUFFER_SIZE,
+                                                        sample_history,
+                                                        since,
+                                                        NULL);
+    representation_since = since;
+  }
+
+  if(*offset >= representation_length) {
+    LOG_DBG("Block out of scope.\n");
+    coap_set_status_code(response, BAD_OPTION_4_02);
+    return;
+  }
+
+  /* Send the requested block of the representation. */
+  chunk_length = MIN(representation_length - *offset, preferred_size);
+  memcpy(buffer, representation + *offset, chunk_length);
+  coap_set_header_content_format(response, APPLICATION_JSON);
+  coap_set_payload(response, buffer, chunk_length);
+  coap_set_status_code(response, CONTENT_2_05);
+
+  /* Signal the chunk awareness to the CoAP engine, and the end of the representation. */
+  *offset += chunk_length;
+  if(*offset >= representation_length) {
+    *offset = -1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+res_sample_history_activate(struct sample_history *history)
+{
+  LOG_DBG("Activating the resource.\n");
+  sample_history = history;
+  representation_length = 0;
+  representation_since = 0;
+  coap_activate_resource(&res_sample_history, COAP_MONITOR_SAMPLE_HISTORY_RESOURCE);
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
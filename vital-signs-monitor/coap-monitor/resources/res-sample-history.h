@@ -0,0 +1,32 @@
+/**
+ * \file
+ *         Header file for the sample history resource
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \defgroup res-sample-history Sample history resource
+ * @{
+ *
+ * The res-sample-history module provides the implementation of a CoAP resource
+ * representing the last samples of all the sensors of the vital signs monitor.
+ * A collector that detects a gap in the sequence numbers carried by the patient
+ * state notifications can retrieve the missed samples with a GET request carrying
+ * the query variable <code>since=&lt;seq&gt;</code>. The samples are delta-encoded,
+ * and the representation is transferred using block-wise transfers.
+ */
+
+#ifndef SMART_ICU_RES_SAMPLE_HISTORY_H
+#define SMART_ICU_RES_SAMPLE_HISTORY_H
+
+#include "../../common/sample-history.h"
+
+/**
+ * \brief           Activate the sample history resource.
+ * \param history   A pointer to the sample history of the monitor.
+ */
+void res_sample_history_activate(struct sample_history *history);
+
+#endif /* SMART_ICU_RES_SAMPLE_HISTORY_H */
+/** @} */
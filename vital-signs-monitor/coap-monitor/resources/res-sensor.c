@@ -0,0 +1,156 @@
+/**
+ * \file
+ *         Implementation of the sensor resources
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \addtogroup res-sensor
+ * @{
+ */
+
+#include <string.h>
+#include "contiki.h"
+#include "os/sys/log.h"
+#include "os/net/app-layer/coap/coap-engine.h"
+#include "../../common/json-message.h"
+#include "../../common/monitor-config.h"
+#include "../utils/coap-monitor-constants.h"
+#include "../utils/coap-notification.h"
+#include "../utils/coap-etag.h"
+#include "../utils/coap-lazy-sampling.h"
+#include "./res-sensor.h"
+
+#define LOG_MODULE "Sensor resources"
+#define LOG_LEVEL LOG_LEVEL_COAP_RESOURCES
+
+static void get_handler(coap_message_t *request, coap_message_t *response, uint8_t *buffer,
+                        uint16_t preferred_size, int32_t *offset);
+
+/*
+ * The resources share the GET handler, which finds the requested sensor from the URI path.
+ * The observers are notified by the pacers of the notifications, so no event handler is needed.
+ */
+EVENT_RESOURCE(res_heart_rate, "title =\"Heart rate\";obs", get_handler, NULL, NULL, NULL, NULL);
+EVENT_RESOURCE(res_blood_pressure, "title =\"Blood pressure\";obs", get_handler, NULL, NULL, NULL, NULL);
+EVENT_RESOURCE(res_temperature, "title =\"Temperature\";obs", get_handler, NULL, NULL, NULL, NULL);
+EVENT_RESOURCE(res_respiration, "title =\"Respiration\";obs", get_handler, NULL, NULL, NULL, NULL);
+EVENT_RESOURCE(res_oxygen_saturation, "title =\"Oxygen saturation\";obs", get_handler, NULL, NULL, NULL, NULL);
+
+/* Structure describing the resource of a sensor. */
+struct res_sensor_descriptor {
+  coap_resource_t *resource;
+  const char *path;
+};
+
+/* Descriptors of the resources, indexed by sensor_type. */
+static const struct res_sensor_descriptor descriptors[SENSORS_NUMBER] = {
+  { &res_heart_rate, COAP_MONITOR_HEART_RATE_RESOURCE },
+  { &res_blood_pressure, COAP_MONITOR_BLOOD_PRESSURE_RESOURCE },
+  { &res_temperature, COAP_MONITOR_TEMPERATURE_RESOURCE },
+  { &res_respiration, COAP_MONITOR_RESPIRATION_RESOURCE },
+  { &res_oxygen_saturation, COAP_MONITOR_OXYGEN_SATURATION_RESOURCE },
+};
+
+/* Resource values, their versions, the notification policies and pacers, indexed by sensor_type. */
+static int samples[SENSORS_NUMBER];
+static clock_time_t ticks[SENSORS_NUMBER];
+static uint32_t versions[SENSORS_NUMBER];
+static struct coap_notification_policy notification_policies[SENSORS_NUMBER];
+static struct coap_notification_pacer notification_pacers[SENSORS_NUMBER];
+
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief           Find the sensor whose resource is the target of a request.
+ * \param request   The request (a fake one built by the engine, for notifications).
+ * \return          The sensor, or SENSOR_NONE if the URI path matches no sensor resource.
+ */
+static sensor_type
+find_sensor(coap_message_t *request)
+{
+  const char *path = NULL;
+  int length;
+  int sensor;
+
+  length = coap_get_header_uri_path(request, &path);
+  for(sensor = 0; sensor < SENSORS_NUMBER; sensor++) {
+    if(length == strlen(descriptors[sensor].path) && strncmp(path, descriptors[sensor].path, length) == 0) {
+      return sensor;
+    }
+  }
+  return SENSOR_NONE;
+}
+/*---------------------------------------------------------------------------*/
+static void
+get_handler(coap_message_t *request, coap_message_t *response, uint8_t *buffer,
+            uint16_t preferred_size, int32_t *offset)
+{
+  sensor_type sensor = find_sensor(request);
+  int length;
+
+  LOG_DBG("Handling a GET request.\n");
+  if(sensor == SENSOR_NONE) {
+    coap_set_status_code(response, NOT_FOUND_4_04);
+    return;
+  }
+
+  /* A request (but not a notification) resumes the sampling of the sensor, if paused. */
+  if(offset != NULL) {
+    coap_lazy_sampling_request(sensor);
+  }
+
+  /* A client already holding the current sample gets only its freshness refreshed. */
+  coap_set_option(response, COAP_OPTION_MAX_AGE);
+  coap_set_header_max_age(response, monitor_config_sampling_interval(sensor));
+  if(coap_etag_validate(request, response, versions[sensor])) {
+    return;
+  }
+
+  /* The message fits in a block, so it is encoded directly in the buffer of the engine. */
+  length = json_message_sensor_sample((char *)buffer, preferred_size, sensor, samples[sensor], ticks[sensor]);
+
+  /* Send the response. */
+  coap_set_header_content_format(response, APPLICATION_JSON);
+  coap_set_payload(response, buffer, length);
+  coap_set_status_code(response, CONTENT_2_05);
+
+  /* Notifications are NON, except for a periodic CON one checking that the observers are still there. */
+  if(offset == NULL) {
+    coap_notification_set_type(response, &notification_policies[sensor], false);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+res_sensor_activate(void)
+{
+  int sensor;
+
+  LOG_DBG("Activating the resources.\n");
+  for(sensor = 0; sensor < SENSORS_NUMBER; sensor++) {
+    samples[sensor] = -1;
+    ticks[sensor] = clock_time();
+    coap_etag_init(&versions[sensor]);
+    coap_notification_policy_init(&notification_policies[sensor]);
+    coap_notification_pacer_init(&notification_pacers[sensor], descriptors[sensor].resource);
+    coap_activate_resource(descriptors[sensor].resource, descriptors[sensor].path);
+  }
+}
+/*---------------------------------------------------------------------------*/
+bool
+res_sensor_observed(sensor_type sensor)
+{
+  return coap_notification_observed(descriptors[sensor].path);
+}
+/*---------------------------------------------------------------------------*/
+void
+res_sensor_update(sensor_type sensor, int sample)
+{
+  LOG_DBG("Updating the resource %s.\n", descriptors[sensor].path);
+  samples[sensor] = sample;
+  ticks[sensor] = clock_time();
+  coap_etag_update(&versions[sensor]);
+  coap_notification_pacer_notify(&notification_pacers[sensor]);
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -0,0 +1,48 @@
+/**
+ * \file
+ *         Header file for the sensor resources
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \defgroup res-sensor Sensor resources
+ * @{
+ *
+ * The res-sensor module provides the implementation of the CoAP resources
+ * representing the last value sampled by each sensor of the vital signs monitor.
+ * All the sensor resources share the same handlers, and differ only in the
+ * entry of a constant descriptor table (resource and path). The max age of a
+ * sample is the sampling interval of its sensor, as configured at runtime.
+ */
+
+#ifndef SMART_ICU_RES_SENSOR_H
+#define SMART_ICU_RES_SENSOR_H
+
+#include <stdbool.h>
+#include "../../common/sensors-cmd.h"
+
+/**
+ * \brief   Activate the resources of all the sensors.
+ */
+void res_sensor_activate(void);
+
+/**
+ * \brief          Update the resource of a sensor.
+ * \param sensor   The sensor that produced the sample.
+ * \param sample   The new sample.
+ *
+ *                 This function updates the resource of the sensor,
+ *                 triggering notifications to the observers.
+ */
+void res_sensor_update(sensor_type sensor, int sample);
+
+/**
+ * \brief          Check if the resource of a sensor has observers.
+ * \param sensor   The sensor.
+ * \return         true if the resource has at least an observer, false otherwise.
+ */
+bool res_sensor_observed(sensor_type sensor);
+
+#endif /* SMART_ICU_RES_SENSOR_H */
+/** @} */
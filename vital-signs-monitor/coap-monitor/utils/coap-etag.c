@@ -0,0 +1,83 @@
+/**
+ * \file
+ *         Implementation of the ETags of CoAP resources
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \addtogroup coap-etag
+ * @{
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "contiki.h"
+#include "os/sys/log.h"
+#include "./coap-etag.h"
+
+#define LOG_MODULE "CoAP ETags"
+#define LOG_LEVEL LOG_LEVEL_COAP_RESOURCES
+
+/* Length in bytes of the ETags, i.e. of the version counters. */
+#define COAP_ETAG_LENGTH   sizeof(uint32_t)
+
+/*---------------------------------------------------------------------------*/
+void
+coap_etag_init(uint32_t *version)
+{
+  *version = (uint32_t)rand();
+}
+/*---------------------------------------------------------------------------*/
+void
+coap_etag_update(uint32_t *version)
+{
+  *version = *version + 1;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief           Encode a version counter as an ETag.
+ * \param etag      A pointer to the buffer that will store the ETag.
+ * \param version   The version counter.
+ *
+ *                  The ETag is the version counter in network byte order.
+ */
+static void
+encode_etag(uint8_t *etag, uint32_t version)
+{
+  etag[0] = (version >> 24) & 0xFF;
+  etag[1] = (version >> 16) & 0xFF;
+  etag[2] = (version >> 8) & 0xFF;
+  etag[3] = version & 0xFF;
+}
+/*---------------------------------------------------------------------------*/
+void
+coap_etag_set(coap_message_t *response, uint32_t version)
+{
+  uint8_t etag[COAP_ETAG_LENGTH];
+
+  encode_etag(etag, version);
+  coap_set_header_etag(response, etag, COAP_ETAG_LENGTH);
+}
+/*---------------------------------------------------------------------------*/
+bool
+coap_etag_validate(coap_message_t *request, coap_message_t *response, uint32_t version)
+{
+  const uint8_t *request_etag = NULL;
+  uint8_t etag[COAP_ETAG_LENGTH];
+  int length;
+
+  encode_etag(etag, version);
+  coap_set_header_etag(response, etag, COAP_ETAG_LENGTH);
+
+  length = coap_get_header_etag(request, &request_etag);
+  if(length != COAP_ETAG_LENGTH || memcmp(request_etag, etag, COAP_ETAG_LENGTH) != 0) {
+    return false;
+  }
+
+  LOG_DBG("Representation still valid.\n");
+  coap_set_status_code(response, VALID_2_03);
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -0,0 +1,63 @@
+/**
+ * \file
+ *         Header file for the ETags of CoAP resources
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \defgroup coap-etag ETags of CoAP resources
+ * @{
+ *
+ * The coap-etag module derives the ETag of a resource from a version counter,
+ * which is incremented each time the value of the resource changes. A client
+ * that already holds a representation can send its ETag in a GET request: if
+ * the representation did not change, the resource replies with 2.03 Valid and
+ * no payload, so that the representation is revalidated instead of downloaded.
+ * The counter starts from a random value, so that the ETags issued before a
+ * reboot of the monitor are not validated by mistake.
+ */
+
+#ifndef SMART_ICU_COAP_ETAG_H
+#define SMART_ICU_COAP_ETAG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "contiki.h"
+#include "os/net/app-layer/coap/coap.h"
+
+/**
+ * \brief           Initialize the version counter of a resource.
+ * \param version   A pointer to the version counter.
+ */
+void coap_etag_init(uint32_t *version);
+
+/**
+ * \brief           Signal that the value of a resource changed.
+ * \param version   A pointer to the version counter of the resource.
+ */
+void coap_etag_update(uint32_t *version);
+
+/**
+ * \brief            Set the ETag of a response.
+ * \param response   The response.
+ * \param version    The version counter of the resource.
+ */
+void coap_etag_set(coap_message_t *response, uint32_t version);
+
+/**
+ * \brief            Set the ETag of a response and validate the one of the request.
+ * \param request    The request.
+ * \param response   The response.
+ * \param version    The version counter of the resource.
+ * \return           true if the request carries the current ETag, false otherwise.
+ *
+ *                   The function sets the ETag of the response according to the
+ *                   version counter. If the request carries the same ETag, the
+ *                   function also sets the status code of the response to 2.03 Valid,
+ *                   and the GET handler must not set any payload.
+ */
+bool coap_etag_validate(coap_message_t *request, coap_message_t *response, uint32_t version);
+
+#endif /* SMART_ICU_COAP_ETAG_H */
+/** @} */
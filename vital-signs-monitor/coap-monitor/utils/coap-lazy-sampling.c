@@ -0,0 +1,136 @@
+/**
+ * \file
+ *         Implementation of the observer-aware sampling of the CoAP monitor
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \addtogroup coap-lazy-sampling
+ * @{
+ */
+
+#include <stdbool.h>
+#include "contiki.h"
+#include "os/sys/log.h"
+#include "os/sys/ctimer.h"
+#include "../resources/res-sensor.h"
+#include "../resources/res-patient-state.h"
+#include "../resources/res-alarm-state.h"
+#include "./coap-monitor-constants.h"
+#include "./coap-lazy-sampling.h"
+
+#define LOG_MODULE "Lazy sampling"
+#define LOG_LEVEL LOG_LEVEL_COAP_RESOURCES
+
+/* State of the observer-aware sampling. */
+static struct process *subscriber_process;
+static bool enabled;
+static bool sampling[SENSORS_NUMBER];
+static clock_time_t last_request_time[SENSORS_NUMBER];
+
+/* Timer used to check periodically the observers. */
+static struct ctimer check_timer;
+
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief          Check if somebody is interested in the samples of a sensor.
+ * \param sensor   The sensor.
+ * \return         true if the samples of the sensor are needed, false otherwise.
+ */
+static bool
+sensor_needed(sensor_type sensor)
+{
+  if(res_sensor_observed(sensor) || res_patient_state_observed() || res_alarm_state_observed()) {
+    return true;
+  }
+  return clock_time() - last_request_time[sensor] < COAP_MONITOR_LAZY_SAMPLING_GET_TIMEOUT*CLOCK_SECOND;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief          Start or stop the sampling of a sensor.
+ * \param sensor   The sensor.
+ * \param needed   true if the samples of the sensor are needed.
+ */
+static void
+update_sensor(sensor_type sensor, bool needed)
+{
+  if(needed && !sampling[sensor]) {
+    LOG_INFO("Resuming the sampling of sensor %d.\n", sensor);
+    sensors_cmd_start_sensor_sampling(sensor, subscriber_process);
+    sampling[sensor] = true;
+  } else if(!needed && sampling[sensor]) {
+    LOG_INFO("Pausing the sampling of sensor %d: no observers.\n", sensor);
+    sensors_cmd_stop_sensor_sampling(sensor);
+    sampling[sensor] = false;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief   Start or stop the sampling of all the sensors, according to their observers.
+ */
+static void
+update_sensors(void)
+{
+  int sensor;
+
+  for(sensor = 0; sensor < SENSORS_NUMBER; sensor++) {
+    update_sensor(sensor, sensor_needed(sensor));
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Callback function used by the ctimer. */
+static void
+check_observers(void *data)
+{
+  update_sensors();
+  ctimer_reset(&check_timer);
+}
+/*---------------------------------------------------------------------------*/
+void
+coap_lazy_sampling_init(struct process *subscriber)
+{
+  subscriber_process = subscriber;
+  enabled = false;
+}
+/*---------------------------------------------------------------------------*/
+void
+coap_lazy_sampling_enable(void)
+{
+  int sensor;
+
+  LOG_DBG("Enabling the observer-aware sampling.\n");
+  enabled = true;
+  for(sensor = 0; sensor < SENSORS_NUMBER; sensor++) {
+    sampling[sensor] = true;
+  }
+
+  /* The first check happens immediately, then periodically. */
+  update_sensors();
+  ctimer_set(&check_timer, COAP_MONITOR_LAZY_SAMPLING_CHECK_INTERVAL*CLOCK_SECOND, check_observers, NULL);
+}
+/*---------------------------------------------------------------------------*/
+void
+coap_lazy_sampling_disable(void)
+{
+  LOG_DBG("Disabling the observer-aware sampling.\n");
+  enabled = false;
+  ctimer_stop(&check_timer);
+}
+/*---------------------------------------------------------------------------*/
+void
+coap_lazy_sampling_request(sensor_type sensor)
+{
+  int index;
+
+  for(index = 0; index < SENSORS_NUMBER; index++) {
+    if(sensor == SENSOR_NONE || sensor == index) {
+      last_request_time[index] = clock_time();
+      if(enabled) {
+        update_sensor(index, true);
+      }
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
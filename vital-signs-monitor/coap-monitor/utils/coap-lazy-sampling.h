@@ -0,0 +1,60 @@
+/**
+ * \file
+ *         Header file for the observer-aware sampling of the CoAP monitor
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \defgroup coap-lazy-sampling Observer-aware sampling
+ * @{
+ *
+ * The coap-lazy-sampling module pauses the sampling of a sensor while nobody
+ * is interested in its samples, i.e. while the resource of the sensor, the
+ * patient state resource and the alarm state resource have no observers and
+ * no GET request reached them in the last COAP_MONITOR_LAZY_SAMPLING_GET_TIMEOUT
+ * seconds. The observers are checked every COAP_MONITOR_LAZY_SAMPLING_CHECK_INTERVAL
+ * seconds, while a GET request (including the one registering an observer)
+ * resumes the sampling immediately.
+ * Since a paused sensor cannot trigger the alarm system, the alarm state resource
+ * counts as a consumer of the samples of all the sensors.
+ */
+
+#ifndef SMART_ICU_COAP_LAZY_SAMPLING_H
+#define SMART_ICU_COAP_LAZY_SAMPLING_H
+
+#include "contiki.h"
+#include "../../common/sensors-cmd.h"
+
+/**
+ * \brief                Initialize the observer-aware sampling.
+ * \param subscriber     The process that receives the samples of the sensors.
+ */
+void coap_lazy_sampling_init(struct process *subscriber);
+
+/**
+ * \brief   Enable the observer-aware sampling.
+ *
+ *          The function must be called once the sampling of all the sensors has
+ *          been started, and pauses immediately the sensors nobody is interested in.
+ */
+void coap_lazy_sampling_enable(void);
+
+/**
+ * \brief   Disable the observer-aware sampling.
+ *
+ *          The function must be called when the sampling of all the sensors
+ *          is stopped, e.g. when the patient ID is reset.
+ */
+void coap_lazy_sampling_disable(void);
+
+/**
+ * \brief          Signal that a GET request asked for the samples of a sensor.
+ * \param sensor   The sensor, or SENSOR_NONE if the request is interested in all the sensors.
+ *
+ *                 The function resumes the sampling of the sensor, if it was paused.
+ */
+void coap_lazy_sampling_request(sensor_type sensor);
+
+#endif /* SMART_ICU_COAP_LAZY_SAMPLING_H */
+/** @} */
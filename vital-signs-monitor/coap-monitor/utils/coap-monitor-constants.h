@@ -23,30 +23,65 @@
 /* Collector constants. */
 #define COAP_MONITOR_COLLECTOR_IP_ADDRESS                     "fd00::1"
 #define COAP_MONITOR_COLLECTOR_PORT                           5683
-#define COAP_MONITOR_COLLECTOR_REGISTERED_MONITORS_RESOURCE   "/registeredMonitors"
+#define COAP_MONITOR_COLLECTOR_RD_RESOURCE                    "rd"                  /* Resource directory receiving the registrations of the monitors. */
+#define COAP_MONITOR_COLLECTOR_MONITOR_DATA_RESOURCE          "monitorData"         /* Resource receiving the data pushed by the monitors. */
+#define COAP_MONITOR_COLLECTOR_PUSH_MODE_QUERY                "mode=push"           /* Query of the registration of a monitor in push mode. */
 #define COAP_MONITOR_COLLECTOR_ENDPOINT                       "coap://[" COAP_MONITOR_COLLECTOR_IP_ADDRESS "]:" STR(COAP_MONITOR_COLLECTOR_PORT)
 
 /* CoAP monitor constants. */
 #define COAP_MONITOR_ID_LENGTH                                46 /* The maximum length of a monitor ID (an IPv6 address). */
 #define COAP_MONITOR_NETWORK_CHECK_INTERVAL                   1  /* Interval in seconds used by the periodic timer to check
                                                                    if the network connectivity has been established. */
-#define COAP_MONITOR_OUTPUT_BUFFER_SIZE                       256 /* Size of the CoAP output buffer. */
 #define COAP_MONITOR_INPUT_BUFFER_SIZE                        32  /* Size of the CoaAP input buffer. */
-#define COAP_MONITOR_PATIENT_ID_LENGTH                        10 /* The maximum length of a patient ID. */
-#define COAP_MONITOR_RESET_PATIENT_ID_DURATION                10 /* Time in seconds for which the button must be kept pressed to reset the patient ID. */
-#define COAP_MONITOR_RESET_ALARM_DURATION                     5  /* Time in seconds for which the button must be kept pressed to reset the alarm state. */
+#define COAP_MONITOR_ALARM_GROUP_ADDRESS                      "ff05::1:a1a" /* Site-local multicast group receiving the alarm commands
+                                                                               addressed to all the monitors (see SMART_ICU_MULTICAST). */
+
+/* CoAP notifications constants. */
+#define COAP_MONITOR_NOTIFICATION_CON_EVERY                   10  /* A notification out of this number is sent as confirmable. */
+#define COAP_MONITOR_NOTIFICATION_CON_INTERVAL                300 /* Maximum interval in seconds between two confirmable notifications of a resource. */
+#define COAP_MONITOR_NOTIFICATION_MIN_INTERVAL                5   /* Minimum interval in seconds between two notifications of a paced resource:
+                                                                   the updates in between are coalesced in the next notification. */
+
+/* Resource directory constants. */
+#define COAP_MONITOR_RD_LIFETIME                              300 /* Lifetime in seconds of the registration to the resource directory. */
+#define COAP_MONITOR_RD_REFRESH_INTERVAL                      240 /* Interval in seconds between two refreshes of the registration. */
+#define COAP_MONITOR_RD_QUERY_LENGTH                          80  /* Maximum length of the query of the registration. */
+#define COAP_MONITOR_RD_LINKS_BUFFER_SIZE                     384 /* Size of the buffer storing the links of the resources. */
+#define COAP_MONITOR_RD_LOCATION_LENGTH                       24  /* Maximum length of the location of the registration. */
+
+/* Push mode constants. */
+#define COAP_MONITOR_PUSH_BATCH_SIZE                          5   /* Number of pending samples that triggers the sending of a batch. */
+#define COAP_MONITOR_PUSH_MAX_DELAY                           10  /* Maximum time in seconds a sample waits before being pushed. */
+#define COAP_MONITOR_PUSH_BUFFER_SIZE                         (REST_MAX_CHUNK_SIZE + 1) /* Size of the buffer storing a pushed message. */
+
+/* Observer-aware sampling constants. */
+#define COAP_MONITOR_LAZY_SAMPLING_CHECK_INTERVAL             30  /* Interval in seconds between two checks of the observers of the resources. */
+#define COAP_MONITOR_LAZY_SAMPLING_GET_TIMEOUT                300 /* Time in seconds after a GET during which the requested samples are considered needed. */
 
 /* CoAP monitor internal states. */
 #define COAP_MONITOR_STATE_STARTED                            0 /* Initial state. */
 #define COAP_MONITOR_STATE_NETWORK_READY                      1 /* Network is initialized. */
 #define COAP_MONITOR_STATE_WAITING_PATIENT_ID                 2 /* Waiting for a patient ID as input. */
 #define COAP_MONITOR_STATE_OPERATIONAL                        3 /* Ready for working. */
-#define COAP_MONITOR_STATE_REGISTRATION_FAILED                4 /* Failed to register to the collector. */
+#define COAP_MONITOR_STATE_REGISTRATION_PENDING               4 /* Waiting for the delay before a registration attempt. */
 
 /* CoAP monitor resources. */
 #define COAP_MONITOR_RESOURCE_OUTPUT_BUFFER_SIZE              256                             /* Size of the output buffer storing the value of a resource. */
+#define COAP_MONITOR_ALARM_HISTORY_BUFFER_SIZE                256                             /* Size of the buffer storing the representation of the alarm history. */
+#define COAP_MONITOR_SAMPLE_HISTORY_BUFFER_SIZE               512                             /* Size of the buffer storing the representation of the sample history. */
+#define COAP_MONITOR_QUERY_VARIABLE_MAX_LENGTH                12                              /* Maximum length of the value of a query variable. */
+#define COAP_MONITOR_PATIENT_STATE_BUFFER_SIZE                192                             /* Size of the buffer storing the representation of the patient state. */
+#define COAP_MONITOR_DIAGNOSTICS_BUFFER_SIZE                  192                             /* Size of the buffer storing the representation of the diagnostics. */
+#define COAP_MONITOR_PATIENT_STATE_NOTIFICATION_DELAY         1                               /* Time in seconds during which the samples are collected
+                                                                                                 before notifying the observers of the patient state. */
 #define COAP_MONITOR_REGISTERED_PATIENT_RESOURCE              "registeredPatient"             /* Resource holding the ID of the patient attached to the monitor. */
+#define COAP_MONITOR_PATIENT_STATE_RESOURCE                   "patientState"                  /* Resource holding the last samples of all the sensors and the alarm state. */
 #define COAP_MONITOR_ALARM_STATE_RESOURCE                     "patientState/alarmState"       /* Resource holding the state of the alarm system. */
+#define COAP_MONITOR_ALARM_GROUP_RESOURCE                     "alarmGroup"                    /* Resource receiving the alarm commands sent to the multicast group. */
+#define COAP_MONITOR_CONFIG_RESOURCE                          "config"                        /* Resource holding the runtime configuration of the monitor. */
+#define COAP_MONITOR_DIAGNOSTICS_RESOURCE                     "diagnostics"                   /* Resource holding the last diagnostics report of the monitor. */
+#define COAP_MONITOR_ALARM_HISTORY_RESOURCE                   "patientState/alarmHistory"     /* Resource holding the last transitions of the alarm system. */
+#define COAP_MONITOR_SAMPLE_HISTORY_RESOURCE                  "patientState/history"          /* Resource holding the last samples of all the sensors. */
 #define COAP_MONITOR_HEART_RATE_RESOURCE                      "patientState/heartRate"        /* Resource holding the last sampled value of the heart rate. */
 #define COAP_MONITOR_BLOOD_PRESSURE_RESOURCE                  "patientState/bloodPressure"    /* Resource holding the last sampled value of the blood pressure. */
 #define COAP_MONITOR_TEMPERATURE_RESOURCE                     "patientState/temperature"      /* Resource holding the last sampled value of the temperature. */
@@ -0,0 +1,131 @@
+/**
+ * \file
+ *         Implementation of the policy choosing the type and the pace of CoAP notifications
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \addtogroup coap-notification
+ * @{
+ */
+
+#include <string.h>
+#include "contiki.h"
+#include "os/sys/log.h"
+#include "os/net/app-layer/coap/coap-observe.h"
+#include "../../common/monitor-log.h"
+#include "./coap-monitor-constants.h"
+#include "./coap-notification.h"
+
+#define LOG_MODULE "CoAP notifications"
+#define LOG_LEVEL LOG_LEVEL_COAP_RESOURCES
+
+/* Number of notifications sent by the monitor, for each type, and of coalesced updates. */
+static struct coap_notification_stats notification_stats;
+
+/*---------------------------------------------------------------------------*/
+void
+coap_notification_policy_init(struct coap_notification_policy *policy)
+{
+  policy->non_confirmable_count = 0;
+  policy->last_confirmable_time = clock_time();
+}
+/*---------------------------------------------------------------------------*/
+void
+coap_notification_set_type(coap_message_t *notification, struct coap_notification_policy *policy, bool critical)
+{
+  clock_time_t now = clock_time();
+
+  if(critical
+     || policy->non_confirmable_count + 1 >= COAP_MONITOR_NOTIFICATION_CON_EVERY
+     || now - policy->last_confirmable_time >= COAP_MONITOR_NOTIFICATION_CON_INTERVAL*CLOCK_SECOND) {
+    notification->type = COAP_TYPE_CON;
+    policy->non_confirmable_count = 0;
+    policy->last_confirmable_time = now;
+    notification_stats.confirmable++;
+  } else {
+    notification->type = COAP_TYPE_NON;
+    policy->non_confirmable_count++;
+    notification_stats.non_confirmable++;
+  }
+
+  monitor_log_event(MONITOR_LOG_EVENT_NOTIFICATION, notification->type, 0);
+  LOG_DBG("Sending a %s notification. Sent notifications: %lu CON, %lu NON. Coalesced updates: %lu.\n",
+          notification->type == COAP_TYPE_CON ? "CON" : "NON",
+          notification_stats.confirmable,
+          notification_stats.non_confirmable,
+          notification_stats.coalesced);
+}
+/*---------------------------------------------------------------------------*/
+/* Callback function used by the ctimer of the pacers. */
+static void
+send_deferred_notification(void *data)
+{
+  struct coap_notification_pacer *pacer = (struct coap_notification_pacer *)data;
+
+  pacer->pending = false;
+  pacer->last_notification_time = clock_time();
+  coap_notify_observers(pacer->resource);
+}
+/*---------------------------------------------------------------------------*/
+void
+coap_notification_pacer_init(struct coap_notification_pacer *pacer, coap_resource_t *resource)
+{
+  pacer->resource = resource;
+  pacer->pending = false;
+
+  /* The first update is notified immediately. */
+  pacer->last_notification_time = clock_time() - COAP_MONITOR_NOTIFICATION_MIN_INTERVAL*CLOCK_SECOND;
+}
+/*---------------------------------------------------------------------------*/
+void
+coap_notification_pacer_notify(struct coap_notification_pacer *pacer)
+{
+  clock_time_t elapsed = clock_time() - pacer->last_notification_time;
+
+  /* The deferred notification will carry the latest value of the resource. */
+  if(pacer->pending) {
+    notification_stats.coalesced++;
+    monitor_log_event(MONITOR_LOG_EVENT_COALESCED, 0, 0);
+    LOG_DBG("Coalescing an update of %s. Coalesced updates: %lu.\n", pacer->resource->url, notification_stats.coalesced);
+    return;
+  }
+
+  if(elapsed >= COAP_MONITOR_NOTIFICATION_MIN_INTERVAL*CLOCK_SECOND) {
+    pacer->last_notification_time = clock_time();
+    coap_notify_observers(pacer->resource);
+    return;
+  }
+
+  LOG_DBG("Deferring the notification of %s.\n", pacer->resource->url);
+  pacer->pending = true;
+  ctimer_set(&pacer->timer,
+             COAP_MONITOR_NOTIFICATION_MIN_INTERVAL*CLOCK_SECOND - elapsed,
+             send_deferred_notification,
+             pacer);
+}
+/*---------------------------------------------------------------------------*/
+bool
+coap_notification_observed(const char *path)
+{
+  coap_observer_t *observer;
+
+  /* The observers store the path truncated to COAP_OBSERVER_URL_LEN - 1 characters. */
+  for(observer = (coap_observer_t *)list_head(coap_get_observers());
+      observer != NULL;
+      observer = observer->next) {
+    if(strncmp(observer->url, path, sizeof(observer->url)) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+/*---------------------------------------------------------------------------*/
+void
+coap_notification_get_stats(struct coap_notification_stats *stats)
+{
+  *stats = notification_stats;
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
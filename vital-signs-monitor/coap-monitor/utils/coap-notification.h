@@ -0,0 +1,113 @@
+/**
+ * \file
+ *         Header file for the policy choosing the type and the pace of CoAP notifications
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \defgroup coap-notification Type and pace of CoAP notifications
+ * @{
+ *
+ * The coap-notification module chooses the message type of the notifications sent
+ * to the observers of a resource. Routine notifications are sent as non-confirmable
+ * messages, so that they do not trigger ACK exchanges and retransmissions on the lossy
+ * network. A confirmable notification is sent every COAP_MONITOR_NOTIFICATION_CON_EVERY
+ * notifications, or if COAP_MONITOR_NOTIFICATION_CON_INTERVAL seconds elapsed since the
+ * last one, so that observers that are not there anymore get removed. Critical
+ * notifications (e.g. alarm state changes) are always confirmable.
+ * The policy is kept per resource, since the monitor is observed by a single collector.
+ *
+ * The resources updated at every sample are paced: two notifications of the same
+ * resource are at least COAP_MONITOR_NOTIFICATION_MIN_INTERVAL seconds apart, so that
+ * short sampling intervals do not exhaust the CoAP transactions. The updates received
+ * in between are coalesced in a single deferred notification, which carries the
+ * latest value of the resource.
+ */
+
+#ifndef SMART_ICU_COAP_NOTIFICATION_H
+#define SMART_ICU_COAP_NOTIFICATION_H
+
+#include <stdbool.h>
+#include "contiki.h"
+#include "os/sys/ctimer.h"
+#include "os/net/app-layer/coap/coap-engine.h"
+
+/* Structure representing the state of the notification policy of a resource. */
+struct coap_notification_policy {
+  uint16_t non_confirmable_count;           /* Notifications sent as NON since the last CON one. */
+  clock_time_t last_confirmable_time;       /* Time of the last CON notification. */
+};
+
+/* Structure representing the pacing of the notifications of a resource. */
+struct coap_notification_pacer {
+  coap_resource_t *resource;                /* Resource whose observers are notified. */
+  struct ctimer timer;                      /* Timer sending the deferred notification. */
+  clock_time_t last_notification_time;      /* Time of the last notification. */
+  bool pending;                             /* true if a notification is deferred. */
+};
+
+/* Structure holding the counters of the notifications of the monitor. */
+struct coap_notification_stats {
+  unsigned long confirmable;                /* Notifications sent as CON. */
+  unsigned long non_confirmable;            /* Notifications sent as NON. */
+  unsigned long coalesced;                  /* Updates carried by the notification of a later one. */
+};
+
+/**
+ * \brief          Initialize the notification policy of a resource.
+ * \param policy   A pointer to the notification policy.
+ */
+void coap_notification_policy_init(struct coap_notification_policy *policy);
+
+/**
+ * \brief                Set the type of a notification.
+ * \param notification   The notification, i.e. the response passed to the GET handler
+ *                       of an observable resource with a NULL offset.
+ * \param policy         A pointer to the notification policy of the resource.
+ * \param critical       true if the notification must be confirmable.
+ *
+ *                       The function sets the type of the notification to CON if it is critical
+ *                       or if a periodic CON notification is due, to NON otherwise. It also
+ *                       updates the counters of the sent notifications, which are logged to
+ *                       evaluate the ACK traffic saved.
+ */
+void coap_notification_set_type(coap_message_t *notification, struct coap_notification_policy *policy, bool critical);
+
+/**
+ * \brief            Initialize the pacing of the notifications of a resource.
+ * \param pacer      A pointer to the pacer.
+ * \param resource   A pointer to the resource whose observers are notified.
+ */
+void coap_notification_pacer_init(struct coap_notification_pacer *pacer, coap_resource_t *resource);
+
+/**
+ * \brief         Notify the observers of a paced resource about an update.
+ * \param pacer   A pointer to the pacer of the resource.
+ *
+ *                The function notifies the observers immediately if the last notification
+ *                is old enough, otherwise it defers the notification until the minimum
+ *                interval elapses. An update received while a notification is deferred
+ *                is coalesced in it.
+ */
+void coap_notification_pacer_notify(struct coap_notification_pacer *pacer);
+
+/**
+ * \brief        Check if a resource is observed.
+ * \param path   The path of the resource.
+ * \return       true if the resource has at least one observer, false otherwise.
+ *
+ *               Unlike <code>coap_has_observers()</code>, which matches the paths by prefix,
+ *               the function does not count the observers of the subresources, e.g. those of
+ *               patientState/heartRate for patientState.
+ */
+bool coap_notification_observed(const char *path);
+
+/**
+ * \brief         Get the counters of the notifications of the monitor.
+ * \param stats   A pointer to the structure filled with the counters.
+ */
+void coap_notification_get_stats(struct coap_notification_stats *stats);
+
+#endif /* SMART_ICU_COAP_NOTIFICATION_H */
+/** @} */
@@ -0,0 +1,166 @@
+/**
+ * \file
+ *         Implementation of the push mode of the CoAP monitor
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \addtogroup coap-push
+ * @{
+ */
+
+#include <stdbool.h>
+#include <string.h>
+#include "contiki.h"
+#include "os/sys/log.h"
+#include "os/sys/ctimer.h"
+#include "os/net/app-layer/coap/coap-transactions.h"
+#include "../../common/json-message.h"
+#include "../../common/monitor-config.h"
+#include "../../common/monitor-log.h"
+#include "../../common/monitor-diagnostics.h"
+#include "./coap-monitor-constants.h"
+#include "./coap-push.h"
+
+#define LOG_MODULE "CoAP push"
+#define LOG_LEVEL LOG_LEVEL_COAP_MONITOR
+
+/* State of the push mode. */
+static coap_endpoint_t *collector_endpoint;
+static struct sample_history *sample_history;
+static uint32_t pushed_seq;                     /* Sequence number of the first sample not pushed yet. */
+static char payload[COAP_MONITOR_PUSH_BUFFER_SIZE];
+
+/* Timer bounding the time spent by a sample waiting for its batch to be sent. */
+static struct ctimer push_timer;
+
+/* Number of samples and messages pushed by the monitor, and bytes of their payloads. */
+static unsigned long pushed_samples;
+static unsigned long pushed_messages;
+static unsigned long pushed_bytes;
+
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief           Send a POST to the monitor data resource of the collector.
+ * \param type      The type of the message (COAP_TYPE_CON or COAP_TYPE_NON).
+ * \param length    The length of the payload, stored in <code>payload</code>.
+ * \return          true if the message has been sent, false otherwise.
+ *
+ *                  The message is sent through a CoAP transaction, so that a confirmable
+ *                  message is retransmitted until it is acknowledged by the collector.
+ */
+static bool
+send_payload(coap_message_type_t type, int length)
+{
+  coap_message_t message;
+  coap_transaction_t *transaction;
+
+  coap_init_message(&message, type, COAP_POST, coap_get_mid());
+  coap_set_header_uri_path(&message, COAP_MONITOR_COLLECTOR_MONITOR_DATA_RESOURCE);
+  coap_set_header_content_format(&message, APPLICATION_JSON);
+  coap_set_payload(&message, payload, length);
+
+  transaction = coap_new_transaction(message.mid, collector_endpoint);
+  if(transaction == NULL) {
+    LOG_ERR("Impossible to push the message: no free CoAP transactions.\n");
+    monitor_diagnostics_record_failure(MONITOR_DIAGNOSTICS_STATUS_QUEUE_FULL);
+    return false;
+  }
+
+  transaction->message_len = coap_serialize_message(&message, transaction->message);
+  coap_send_transaction(transaction);
+
+  pushed_messages++;
+  pushed_bytes += length;
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief   Send all the pending samples to the collector, in as many batches as needed.
+ */
+static void
+push_samples(void)
+{
+  uint32_t next;
+  int length;
+
+  ctimer_stop(&push_timer);
+
+  while(pushed_seq < sample_history->next_seq) {
+    length = json_message_sample_history(payload, sizeof(payload), sample_history, pushed_seq, &next);
+    if(next == pushed_seq || !send_payload(COAP_TYPE_NON, length)) {
+      break;
+    }
+
+    monitor_log_event(MONITOR_LOG_EVENT_PUSH, next - pushed_seq, length);
+    LOG_DBG("Pushed the samples from %lu to %lu: %s\n", (unsigned long)pushed_seq, (unsigned long)next, payload);
+    pushed_samples += next - pushed_seq;
+    pushed_seq = next;
+  }
+
+  LOG_DBG("Pushed %lu samples in %lu messages (%lu bytes of payload).\n",
+          pushed_samples,
+          pushed_messages,
+          pushed_bytes);
+}
+/*---------------------------------------------------------------------------*/
+/* Callback function used by the ctimer. */
+static void
+push_timer_expired(void *data)
+{
+  push_samples();
+}
+/*---------------------------------------------------------------------------*/
+void
+coap_push_init(coap_endpoint_t *endpoint, struct sample_history *history)
+{
+  collector_endpoint = endpoint;
+  sample_history = history;
+  pushed_seq = history->next_seq;
+  pushed_samples = 0;
+  pushed_messages = 0;
+  pushed_bytes = 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+coap_push_sample_recorded(void)
+{
+  /* The samples waiting to be pushed are the output queue of the push mode. */
+  monitor_diagnostics_record_queue_length(sample_history->next_seq - pushed_seq);
+
+  if(sample_history->next_seq - pushed_seq >= COAP_MONITOR_PUSH_BATCH_SIZE) {
+    push_samples();
+    return;
+  }
+
+  /* The first pending sample schedules the sending of the batch, within the delay configured by the collector. */
+  if(ctimer_expired(&push_timer)) {
+    ctimer_set(&push_timer, monitor_config_send_interval(COAP_MONITOR_PUSH_MAX_DELAY)*CLOCK_SECOND, push_timer_expired, NULL);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+coap_push_alarm_state(alarm_state state)
+{
+  /* The collector receives the samples that triggered the alarm before the alarm itself. */
+  push_samples();
+
+  if(state == ALARM_ON) {
+    json_message_alarm_started(payload, sizeof(payload));
+  } else {
+    json_message_alarm_stopped(payload, sizeof(payload));
+  }
+  send_payload(COAP_TYPE_CON, strlen(payload));
+}
+/*---------------------------------------------------------------------------*/
+void
+coap_push_patient_id(char *patient_id)
+{
+  push_samples();
+
+  json_message_patient_registration(payload, sizeof(payload), NULL, patient_id);
+  send_payload(COAP_TYPE_CON, strlen(payload));
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -0,0 +1,63 @@
+/**
+ * \file
+ *         Header file for the push mode of the CoAP monitor
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \defgroup coap-push Push mode of the CoAP monitor
+ * @{
+ *
+ * The coap-push module lets the monitor POST its data to the collector, instead of
+ * being observed by it. The samples are taken from the sample history and sent in
+ * batches as non-confirmable messages, encoded as sample history messages: a batch is
+ * sent when COAP_MONITOR_PUSH_BATCH_SIZE samples are pending, or COAP_MONITOR_PUSH_MAX_DELAY
+ * seconds (or the send interval configured by the collector) after the first pending sample.
+ * The collector detects a lost batch from the sequence numbers and retrieves the missed
+ * samples from the sample history resource.
+ * Alarm state changes and patient IDs are sent as confirmable messages, after flushing
+ * the pending samples.
+ * The push mode is enabled building the monitor with <code>make PUSH_MODE=1</code>.
+ */
+
+#ifndef SMART_ICU_COAP_PUSH_H
+#define SMART_ICU_COAP_PUSH_H
+
+#include "contiki.h"
+#include "os/net/app-layer/coap/coap.h"
+#include "../../common/alarm.h"
+#include "../../common/sample-history.h"
+
+/**
+ * \brief            Initialize the push mode.
+ * \param endpoint   A pointer to the endpoint of the collector.
+ * \param history    A pointer to the sample history holding the samples to push.
+ *
+ *                   The samples recorded in the history before the initialization are not pushed.
+ */
+void coap_push_init(coap_endpoint_t *endpoint, struct sample_history *history);
+
+/**
+ * \brief   Signal that a new sample has been recorded in the sample history.
+ *
+ *          The function sends the pending samples if they fill a batch, otherwise
+ *          it schedules their sending within the send interval configured by the collector,
+ *          COAP_MONITOR_PUSH_MAX_DELAY seconds by default.
+ */
+void coap_push_sample_recorded(void);
+
+/**
+ * \brief         Push a change of the alarm state to the collector.
+ * \param state   The new alarm state.
+ */
+void coap_push_alarm_state(alarm_state state);
+
+/**
+ * \brief              Push the patient attached to the monitor to the collector.
+ * \param patient_id   The patient ID (empty if reset).
+ */
+void coap_push_patient_id(char *patient_id);
+
+#endif /* SMART_ICU_COAP_PUSH_H */
+/** @} */
@@ -0,0 +1,39 @@
+/**
+ * \file
+ *         Implementation of the parsing of CoAP query variables
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \addtogroup coap-query
+ * @{
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "contiki.h"
+#include "os/net/app-layer/coap/coap.h"
+#include "./coap-monitor-constants.h"
+#include "./coap-query.h"
+
+/*---------------------------------------------------------------------------*/
+uint32_t
+coap_query_get_uint(coap_message_t *request, const char *name, uint32_t default_value)
+{
+  const char *query = NULL;
+  char value[COAP_MONITOR_QUERY_VARIABLE_MAX_LENGTH];
+  int length;
+
+  length = coap_get_query_variable(request, name, &query);
+  if(length <= 0 || length >= COAP_MONITOR_QUERY_VARIABLE_MAX_LENGTH) {
+    return default_value;
+  }
+
+  /* The query variable is not null terminated. */
+  memcpy(value, query, length);
+  value[length] = '\0';
+  return strtoul(value, NULL, 10);
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -0,0 +1,33 @@
+/**
+ * \file
+ *         Header file for the parsing of CoAP query variables
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \defgroup coap-query Parsing of CoAP query variables
+ * @{
+ *
+ * The coap-query module provides helpers to parse the query variables
+ * of the requests received by the resources of the monitor.
+ */
+
+#ifndef SMART_ICU_COAP_QUERY_H
+#define SMART_ICU_COAP_QUERY_H
+
+#include <stdint.h>
+#include "contiki.h"
+#include "os/net/app-layer/coap/coap.h"
+
+/**
+ * \brief                 Parse an unsigned integer query variable of a request.
+ * \param request         The request.
+ * \param name            The name of the query variable.
+ * \param default_value   The value returned if the query variable is missing or too long.
+ * \return                The value of the query variable, or <code>default_value</code>.
+ */
+uint32_t coap_query_get_uint(coap_message_t *request, const char *name, uint32_t default_value);
+
+#endif /* SMART_ICU_COAP_QUERY_H */
+/** @} */
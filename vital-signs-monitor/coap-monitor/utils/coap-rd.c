@@ -0,0 +1,197 @@
+/**
+ * \file
+ *         Implementation of the registration to the CoRE Resource Directory of the collector
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \addtogroup coap-rd
+ * @{
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "contiki.h"
+#include "os/sys/log.h"
+#include "os/net/app-layer/coap/coap-engine.h"
+#include "../../common/time-sync.h"
+#include "./coap-monitor-constants.h"
+#include "./coap-rd.h"
+
+#define LOG_MODULE "Resource directory"
+#define LOG_LEVEL LOG_LEVEL_COAP_MONITOR
+
+/* Query of the registration, carrying the endpoint name and the lifetime. */
+static char query[COAP_MONITOR_RD_QUERY_LENGTH];
+
+/* Resources of the monitor, in link format. */
+static char links[COAP_MONITOR_RD_LINKS_BUFFER_SIZE];
+static int links_length;
+
+/* Location of the registration, assigned by the resource directory. */
+static char location[COAP_MONITOR_RD_LOCATION_LENGTH];
+
+/* Clock tick at which the last request was prepared, to compensate the time of the collector. */
+static clock_time_t request_tick;
+
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief   Generate the link format representation of the activated resources.
+ *
+ *          Only the path and the observability of the resources are listed, in order
+ *          to keep the registration small. The link of .well-known/core is left out.
+ */
+static void
+generate_links(void)
+{
+  coap_resource_t *resource;
+  int length;
+
+  links_length = 0;
+  for(resource = coap_get_first_resource(); resource != NULL; resource = coap_get_next_resource(resource)) {
+    if(strncmp(resource->url, ".well-known", strlen(".well-known")) == 0) {
+      continue;
+    }
+
+    length = snprintf(links + links_length,
+                      COAP_MONITOR_RD_LINKS_BUFFER_SIZE - links_length,
+                      "%s</%s>%s",
+                      links_length == 0 ? "" : ",",
+                      resource->url,
+                      strstr(resource->attributes, ";obs") != NULL ? ";obs" : "");
+    if(links_length + length >= COAP_MONITOR_RD_LINKS_BUFFER_SIZE) {
+      LOG_ERR("The links of the resources do not fit in the buffer: %s is left out.\n", resource->url);
+      links[links_length] = '\0';
+      break;
+    }
+    links_length += length;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief            Synchronize with the time carried by a response of the resource directory.
+ * \param response   The response.
+ *
+ *                   The time is optional, so a response without payload is not an error.
+ */
+static void
+handle_time(coap_message_t *response)
+{
+  const uint8_t *payload;
+  int length = coap_get_payload(response, &payload);
+
+  if(length > 0) {
+    time_sync_handle_message((const char *)payload, length, request_tick);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+coap_rd_init(const char *endpoint_name)
+{
+  snprintf(query,
+           COAP_MONITOR_RD_QUERY_LENGTH,
+           "ep=%s&lt=%u%s",
+           endpoint_name,
+           COAP_MONITOR_RD_LIFETIME,
+#ifdef COAP_MONITOR_PUSH_MODE
+           "&" COAP_MONITOR_COLLECTOR_PUSH_MODE_QUERY
+#else
+           ""
+#endif
+           );
+  location[0] = '\0';
+  generate_links();
+  LOG_DBG("Links of the resources: %s\n", links);
+}
+/*---------------------------------------------------------------------------*/
+bool
+coap_rd_prepare_registration(coap_message_t *request, uint32_t num)
+{
+  int offset = num * REST_MAX_CHUNK_SIZE;
+  bool more = offset + REST_MAX_CHUNK_SIZE < links_length;
+
+  request_tick = clock_time();
+  coap_init_message(request, COAP_TYPE_CON, COAP_POST, 0);
+  coap_set_header_uri_path(request, COAP_MONITOR_COLLECTOR_RD_RESOURCE);
+  coap_set_header_uri_query(request, query);
+  coap_set_header_content_format(request, APPLICATION_LINK_FORMAT);
+  coap_set_header_block1(request, num, more, REST_MAX_CHUNK_SIZE);
+  coap_set_payload(request, links + offset, MIN(links_length - offset, REST_MAX_CHUNK_SIZE));
+
+  return more;
+}
+/*---------------------------------------------------------------------------*/
+bool
+coap_rd_handle_registration_response(coap_message_t *response, uint32_t num)
+{
+  const char *path;
+  int length;
+
+  if(response == NULL) {
+    LOG_ERR("Registration failed: block %lu timed out.\n", (unsigned long)num);
+    return false;
+  }
+
+  if(response->code == CONTINUE_2_31) {
+    return true;
+  }
+
+  if(response->code != CREATED_2_01) {
+    LOG_ERR("Registration failed. Response code: %u.%u\n", (response->code) >> 5, (response->code) & 31);
+    return false;
+  }
+
+  length = coap_get_header_location_path(response, &path);
+  if(length <= 0 || length >= COAP_MONITOR_RD_LOCATION_LENGTH) {
+    LOG_ERR("Registration failed: invalid location.\n");
+    return false;
+  }
+
+  /* The location is not null terminated. */
+  memcpy(location, path, length);
+  location[length] = '\0';
+  LOG_INFO("Registered to the resource directory. Location: /%s.\n", location);
+  handle_time(response);
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+void
+coap_rd_prepare_refresh(coap_message_t *request)
+{
+  request_tick = clock_time();
+  coap_init_message(request, COAP_TYPE_CON, COAP_POST, 0);
+  coap_set_header_uri_path(request, location);
+}
+/*---------------------------------------------------------------------------*/
+bool
+coap_rd_handle_refresh_response(coap_message_t *response)
+{
+  if(response == NULL) {
+    LOG_ERR("Refresh of the registration failed: request timed out.\n");
+    return false;
+  }
+
+  if(response->code == NOT_FOUND_4_04) {
+    LOG_ERR("Refresh of the registration failed: registration not found.\n");
+    location[0] = '\0';
+    return false;
+  }
+
+  if(response->code != CHANGED_2_04) {
+    LOG_ERR("Refresh of the registration failed. Response code: %u.%u\n", (response->code) >> 5, (response->code) & 31);
+    return false;
+  }
+
+  LOG_DBG("Refreshed the registration.\n");
+  handle_time(response);
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+bool
+coap_rd_registered(void)
+{
+  return location[0] != '\0';
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
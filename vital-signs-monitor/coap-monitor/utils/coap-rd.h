@@ -0,0 +1,87 @@
+/**
+ * \file
+ *         Header file for the registration to the CoRE Resource Directory of the collector
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \defgroup coap-rd Registration to the CoRE Resource Directory
+ * @{
+ *
+ * The coap-rd module registers the monitor to the CoRE Resource Directory hosted
+ * by the collector. The registration is a POST to the directory, carrying the endpoint
+ * name and the lifetime of the registration as query variables, and the resources of
+ * the monitor in link format as payload. Since the payload is larger than a CoAP block,
+ * it is sent block-wise (Block1), one request per block. The directory replies with the
+ * location of the registration, to which an empty POST is sent to refresh the lifetime.
+ * If the refresh fails because the directory forgot the registration (4.04), the
+ * location is dropped, so that the monitor registers again. The responses to the
+ * registration and to the refreshes carry the time of the collector, with which
+ * the clock of the monitor is synchronized (see time-sync).
+ * The functions preparing the requests do not send them: the first registration is sent
+ * with <code>COAP_BLOCKING_REQUEST()</code>, from the body of the monitor process, the following
+ * requests with <code>coap_send_request()</code>, so that they do not block the monitor.
+ */
+
+#ifndef SMART_ICU_COAP_RD_H
+#define SMART_ICU_COAP_RD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "contiki.h"
+#include "os/net/app-layer/coap/coap.h"
+
+/**
+ * \brief                 Initialize the registration to the resource directory.
+ * \param endpoint_name   The endpoint name of the monitor, i.e. its monitor ID.
+ *
+ *                        The function generates the link format representation of
+ *                        the resources activated so far, which is sent at each registration.
+ */
+void coap_rd_init(const char *endpoint_name);
+
+/**
+ * \brief           Prepare a block of the registration request.
+ * \param request   The request to prepare.
+ * \param num       The number of the block, starting from 0.
+ * \return          true if other blocks follow, false if the block is the last one.
+ */
+bool coap_rd_prepare_registration(coap_message_t *request, uint32_t num);
+
+/**
+ * \brief            Handle the response to a block of the registration request.
+ * \param response   The response, or NULL if the request timed out.
+ * \param num        The number of the block.
+ * \return           true if the block has been accepted, false otherwise.
+ *
+ *                   An intermediate block is accepted with 2.31 Continue, while the
+ *                   last one completes the registration with 2.01 Created: the location
+ *                   of the registration is then saved for the following refreshes.
+ */
+bool coap_rd_handle_registration_response(coap_message_t *response, uint32_t num);
+
+/**
+ * \brief           Prepare the request refreshing the lifetime of the registration.
+ * \param request   The request to prepare.
+ */
+void coap_rd_prepare_refresh(coap_message_t *request);
+
+/**
+ * \brief            Handle the response to the refresh of the registration.
+ * \param response   The response, or NULL if the request timed out.
+ * \return           true if the lifetime has been refreshed, false otherwise.
+ *
+ *                   If the directory does not know the registration anymore,
+ *                   its location is dropped.
+ */
+bool coap_rd_handle_refresh_response(coap_message_t *response);
+
+/**
+ * \brief    Check if the monitor holds a registration to the resource directory.
+ * \return   true if the location of a registration is known, false otherwise.
+ */
+bool coap_rd_registered(void);
+
+#endif /* SMART_ICU_COAP_RD_H */
+/** @} */
@@ -9,14 +9,15 @@
  * \defgroup alarm-constants Alarm system constants
  * @{
  *
- * Constants used by the alarm system of a monitor to control the duration of acoustic signals
- * and to detect anomalous samples.
+ * Constants used by the alarm system of a monitor to control the duration of acoustic signals,
+ * to size the history of alarm events and to detect anomalous samples.
  */
 
 #ifndef SMART_ICU_ALARM_CONSTANTS_H
 #define SMART_ICU_ALARM_CONSTANTS_H
 
 #define ALARM_SOUND_DURATION                    30 /* Duration in seconds of the alarm sound. */
+#define ALARM_HISTORY_SIZE                      8  /* Number of alarm events kept in the alarm history. */
 
 #define ALARM_HEART_RATE_MIN_THRESHOLD          50
 #define ALARM_HEART_RATE_MAX_THRESHOLD          120
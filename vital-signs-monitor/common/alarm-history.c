@@ -0,0 +1,57 @@
+/**
+ * \file
+ *         Implementation of the alarm event history
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \addtogroup alarm-history
+ * @{
+ */
+
+#include "contiki.h"
+#include "os/sys/clock.h"
+#include "./alarm-history.h"
+
+/*---------------------------------------------------------------------------*/
+void
+alarm_history_init(struct alarm_history *history)
+{
+  history->next_seq = 0;
+  history->length = 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+alarm_history_record(struct alarm_history *history, sensor_type sensor, int value, alarm_state transition)
+{
+  struct alarm_event *event = &history->events[history->next_seq % ALARM_HISTORY_SIZE];
+
+  event->seq = history->next_seq;
+  event->tick = clock_time();
+  event->sensor = sensor;
+  event->value = (sensor == SENSOR_NONE) ? 0 : value;
+  event->transition = transition;
+
+  history->next_seq = history->next_seq + 1;
+  if(history->length < ALARM_HISTORY_SIZE) {
+    history->length = history->length + 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+alarm_history_oldest_seq(struct alarm_history *history)
+{
+  return history->next_seq - history->length;
+}
+/*---------------------------------------------------------------------------*/
+const struct alarm_event *
+alarm_history_get(struct alarm_history *history, uint32_t seq)
+{
+  if(seq < alarm_history_oldest_seq(history) || seq >= history->next_seq) {
+    return NULL;
+  }
+  return &history->events[seq % ALARM_HISTORY_SIZE];
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -0,0 +1,87 @@
+/**
+ * \file
+ *         Header file for the alarm event history
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \defgroup alarm-history Alarm event history
+ * @{
+ *
+ * The alarm-history module provides a fixed-size ring buffer storing the last
+ * transitions of the alarm system of a monitor. Each event is identified by a
+ * monotonic sequence number, so that a collector that lost the connection with
+ * the monitor can retrieve all the transitions it missed with a single request,
+ * starting from the first sequence number it did not receive.
+ * When the ring is full, the oldest event is overwritten.
+ */
+
+#ifndef SMART_ICU_ALARM_HISTORY_H
+#define SMART_ICU_ALARM_HISTORY_H
+
+#include <stdint.h>
+#include "contiki.h"
+#include "./alarm.h"
+#include "./alarm-constants.h"
+#include "./sensors-cmd.h"
+
+/* Structure representing a transition of the alarm system. */
+struct alarm_event {
+  uint32_t seq;
+  clock_time_t tick;            /* Clock tick at which the transition happened. */
+  int value;
+  sensor_type sensor;
+  alarm_state transition;
+};
+
+/* Structure representing the history of the alarm events, organized as a circular buffer. */
+struct alarm_history {
+  struct alarm_event events[ALARM_HISTORY_SIZE];
+  uint32_t next_seq;
+  uint8_t length;
+};
+
+/**
+ * \brief           Initialize the alarm history.
+ * \param history   A pointer to the alarm history.
+ *
+ *                  The function empties the alarm history and restarts
+ *                  the sequence numbers from 0.
+ */
+void alarm_history_init(struct alarm_history *history);
+
+/**
+ * \brief              Record a transition of the alarm system.
+ * \param history      A pointer to the alarm history.
+ * \param sensor       The sensor whose sample caused the transition,
+ *                     or SENSOR_NONE if the transition was not caused by a sample.
+ * \param value        The sample that caused the transition (ignored if <code>sensor</code>
+ *                     is SENSOR_NONE).
+ * \param transition   The new state of the alarm system.
+ *
+ *                     The function records a new event, timestamped with the current clock tick,
+ *                     assigning to it the next sequence number. If the history is full,
+ *                     the oldest event is overwritten.
+ */
+void alarm_history_record(struct alarm_history *history, sensor_type sensor, int value, alarm_state transition);
+
+/**
+ * \brief           Get the sequence number of the oldest event stored in the alarm history.
+ * \param history   A pointer to the alarm history.
+ * \return          The sequence number of the oldest stored event. If the history is empty,
+ *                  the returned value is equal to <code>next_seq</code>.
+ */
+uint32_t alarm_history_oldest_seq(struct alarm_history *history);
+
+/**
+ * \brief           Get an event stored in the alarm history.
+ * \param history   A pointer to the alarm history.
+ * \param seq       The sequence number of the event.
+ * \return          A pointer to the event, or NULL if the event has already been
+ *                  overwritten or has not been recorded yet.
+ */
+const struct alarm_event *alarm_history_get(struct alarm_history *history, uint32_t seq);
+
+#endif /* SMART_ICU_ALARM_HISTORY_H */
+/** @} */
@@ -0,0 +1,71 @@
+/**
+ * \file
+ *         Implementation of the randomized exponential backoff
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \addtogroup backoff
+ * @{
+ */
+
+#include "contiki.h"
+#include "os/lib/random.h"
+#include "./backoff.h"
+
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief              Extract a random delay in an interval.
+ * \param min_delay    The lower bound (inclusive) of the interval.
+ * \param max_delay    The upper bound (inclusive) of the interval.
+ * \return             A random delay in the interval [<code>min_delay</code>, <code>max_delay</code>].
+ *
+ *                     The function uses <code>random_rand()</code>, which is seeded differently
+ *                     on each node, unlike <code>rand()</code>.
+ */
+static clock_time_t
+random_delay(clock_time_t min_delay, clock_time_t max_delay)
+{
+  return min_delay + (clock_time_t)(((unsigned long)random_rand() * (max_delay - min_delay + 1)) / (RANDOM_RAND_MAX + 1UL));
+}
+/*---------------------------------------------------------------------------*/
+void
+backoff_init(struct backoff *backoff, clock_time_t initial_window, clock_time_t base_delay, clock_time_t max_delay)
+{
+  backoff->initial_window = initial_window;
+  backoff->base_delay = base_delay;
+  backoff->max_delay = max_delay;
+  backoff->failures = 0;
+}
+/*---------------------------------------------------------------------------*/
+clock_time_t
+backoff_initial_delay(struct backoff *backoff)
+{
+  return random_delay(0, backoff->initial_window);
+}
+/*---------------------------------------------------------------------------*/
+clock_time_t
+backoff_failure(struct backoff *backoff)
+{
+  clock_time_t delay = backoff->base_delay;
+  uint8_t failure;
+
+  for(failure = 0; failure < backoff->failures && delay < backoff->max_delay; failure++) {
+    delay *= 2;
+  }
+  delay = MIN(delay, backoff->max_delay);
+
+  if(backoff->failures < UINT8_MAX) {
+    backoff->failures = backoff->failures + 1;
+  }
+  return random_delay(delay / 2, delay);
+}
+/*---------------------------------------------------------------------------*/
+void
+backoff_success(struct backoff *backoff)
+{
+  backoff->failures = 0;
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -0,0 +1,71 @@
+/**
+ * \file
+ *         Header file for the randomized exponential backoff
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \defgroup backoff Randomized exponential backoff
+ * @{
+ *
+ * The backoff module computes the delays before the attempts of an operation
+ * that may fail, e.g. the registration to the collector or the connection to
+ * the MQTT broker. The first attempt is delayed by a random time, so that the
+ * monitors booting at the same time (e.g. when the power comes back in a ward)
+ * do not contend for the network in lockstep. After each failure, the delay
+ * doubles up to a maximum value, and a random jitter is applied to it.
+ */
+
+#ifndef SMART_ICU_BACKOFF_H
+#define SMART_ICU_BACKOFF_H
+
+#include <stdint.h>
+#include "contiki.h"
+
+/* Structure representing the state of a randomized exponential backoff. */
+struct backoff {
+  clock_time_t initial_window;   /* Maximum delay before the first attempt. */
+  clock_time_t base_delay;       /* Delay after the first failure. */
+  clock_time_t max_delay;        /* Maximum delay between two attempts. */
+  uint8_t failures;              /* Consecutive failures since the last success. */
+};
+
+/**
+ * \brief                  Initialize a backoff.
+ * \param backoff          A pointer to the backoff.
+ * \param initial_window   The maximum delay before the first attempt.
+ * \param base_delay       The delay after the first failure.
+ * \param max_delay        The maximum delay between two attempts.
+ */
+void backoff_init(struct backoff *backoff, clock_time_t initial_window, clock_time_t base_delay,
+                  clock_time_t max_delay);
+
+/**
+ * \brief             Get the delay before the first attempt.
+ * \param backoff     A pointer to the backoff.
+ * \return            A random delay in the interval [0, <code>initial_window</code>].
+ */
+clock_time_t backoff_initial_delay(struct backoff *backoff);
+
+/**
+ * \brief             Signal the failure of an attempt and get the delay before the next one.
+ * \param backoff     A pointer to the backoff.
+ * \return            The delay before the next attempt.
+ *
+ *                    The delay is <code>base_delay</code> multiplied by 2 for each previous
+ *                    consecutive failure, up to <code>max_delay</code>. The returned value is
+ *                    a random delay between half and the whole of it.
+ */
+clock_time_t backoff_failure(struct backoff *backoff);
+
+/**
+ * \brief             Signal the success of an attempt.
+ * \param backoff     A pointer to the backoff.
+ *
+ *                    The function restarts the delays from <code>base_delay</code>.
+ */
+void backoff_success(struct backoff *backoff);
+
+#endif /* SMART_ICU_BACKOFF_H */
+/** @} */
@@ -14,8 +14,30 @@
 #include <string.h>
 #include "os/sys/clock.h"
 #include "json-message.h"
+#include "./time-sync.h"
 #include "./sensors/utils/sensor-constants.h"
 
+/* Maximum length of a time in milliseconds, as printed by time_sync_snprint(), and of a sequence number. */
+#define JSON_MESSAGE_TIME_MAX_LENGTH             21
+#define JSON_MESSAGE_SEQ_MAX_LENGTH              10
+
+/*
+ * Maximum length of an encoded alarm event and of the closing part of an alarm history message,
+ * the latter including the string terminator.
+ */
+#define JSON_MESSAGE_ALARM_EVENT_MAX_LENGTH      56
+#define JSON_MESSAGE_ALARM_HISTORY_TAIL          "], \"next\": %lu, \"sent\": %s}"
+#define JSON_MESSAGE_ALARM_HISTORY_TAIL_LENGTH   (sizeof("], \"next\": , \"sent\": }") - 1 \
+                                                  + JSON_MESSAGE_SEQ_MAX_LENGTH + JSON_MESSAGE_TIME_MAX_LENGTH)
+
+/* Keys and measurement units of the samples, indexed by sensor_type. */
+static const char *sensor_keys[SENSORS_NUMBER] = {
+  "heartRate", "bloodPressure", "temperature", "respiration", "oxygenSaturation"
+};
+static const char *sensor_units[SENSORS_NUMBER] = {
+  HEART_RATE_UNIT, BLOOD_PRESSURE_UNIT, TEMPERATURE_UNIT, RESPIRATION_UNIT, OXYGEN_SATURATION_UNIT
+};
+
 /*---------------------------------------------------------------------------*/
 static void
 clear_buffer(char *buffer, size_t size)
@@ -23,6 +45,120 @@ clear_buffer(char *buffer, size_t size)
   memset(buffer, 0, size);
 }
 /*---------------------------------------------------------------------------*/
+/**
+ * \brief                  Encode the samples of a sample history in a given range.
+ * \param message_buffer   A pointer to the buffer that will store the message.
+ * \param size             The size of the buffer.
+ * \param history          A pointer to the sample history.
+ * \param since            The sequence number of the first sample to be inserted.
+ * \param until            The sequence number following the last sample to be inserted.
+ * \return                 The length of the generated message, or -1 if the buffer is too small.
+ */
+static int
+encode_sample_history(char *message_buffer, size_t size, struct sample_history *history,
+                      uint32_t since, uint32_t until)
+{
+  const struct sample_record *record;
+  const struct sample_record *previous;
+  char time[JSON_MESSAGE_TIME_MAX_LENGTH];
+  int sensor;
+  uint8_t index;
+  int length;
+
+  clear_buffer(message_buffer, size);
+  length = snprintf(message_buffer, size, "%s", "{\"sampleHistory\": [");
+
+  for(sensor = 0; sensor < SENSORS_NUMBER && length < size; sensor++) {
+    length += snprintf(message_buffer + length, size - length, "%s[", sensor == 0 ? "" : ",");
+    previous = NULL;
+
+    for(index = 0; index < history->length[sensor] && length < size; index++) {
+      record = sample_history_get(history, sensor, index);
+      if(record->seq < since || record->seq >= until) {
+        continue;
+      }
+
+      /*
+       * The first sample is absolute and preceded by its sequence number among the samples
+       * of the sensor, the following ones are deltas from the previous sample.
+       */
+      if(previous == NULL) {
+        time_sync_snprint(time, JSON_MESSAGE_TIME_MAX_LENGTH, record->tick);
+        length += snprintf(message_buffer + length, size - length, "%lu,%lu,%s,%d",
+                           (unsigned long)sample_history_sensor_seq(history, sensor, index),
+                           (unsigned long)record->seq,
+                           time,
+                           record->value);
+      } else {
+        length += snprintf(message_buffer + length, size - length, ",%lu,%lu,%d",
+                           (unsigned long)(record->seq - previous->seq),
+                           (unsigned long)(time_sync_to_ms(record->tick) - time_sync_to_ms(previous->tick)),
+                           record->value - previous->value);
+      }
+      previous = record;
+    }
+
+    if(length < size) {
+      length += snprintf(message_buffer + length, size - length, "%s", "]");
+    }
+  }
+
+  if(length < size) {
+    time_sync_snprint(time, JSON_MESSAGE_TIME_MAX_LENGTH, clock_time());
+    length += snprintf(message_buffer + length, size - length, "], \"next\": %lu, \"sent\": %s}",
+                       (unsigned long)until, time);
+  }
+
+  return length < size ? length : -1;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief                   Encode the state of a patient, eventually preceded by the patient ID.
+ * \param message_buffer    A pointer to the buffer that will store the message.
+ * \param size              The size of the buffer.
+ * \param patient_id        The patient ID, or NULL if it must be left out.
+ * \param samples           The last sample of each sensor, indexed by sensor_type.
+ * \param updated_samples   Bitmask of the sensors that produced a sample since the previous message.
+ * \param alarm             The state of the alarm system.
+ * \param seq               The next sequence number of the sample history.
+ * \return                  The length of the generated message.
+ */
+static int
+encode_patient_state(char *message_buffer, size_t size, char *patient_id, const int *samples,
+                     uint8_t updated_samples, alarm_state alarm, uint32_t seq)
+{
+  char time[JSON_MESSAGE_TIME_MAX_LENGTH];
+  int sensor;
+  int length;
+
+  clear_buffer(message_buffer, size);
+  if(patient_id != NULL) {
+    length = snprintf(message_buffer, size, "{\"patientID\": \"%s\", ", patient_id);
+  } else {
+    length = snprintf(message_buffer, size, "%s", "{");
+  }
+
+  /* Sensors that have not produced a sample yet are left out. */
+  for(sensor = 0; sensor < SENSORS_NUMBER && length < size; sensor++) {
+    if(samples[sensor] >= 0) {
+      length += snprintf(message_buffer + length, size - length, "\"%s\": %d, ", sensor_keys[sensor], samples[sensor]);
+    }
+  }
+
+  if(length < size) {
+    time_sync_snprint(time, JSON_MESSAGE_TIME_MAX_LENGTH, clock_time());
+    length += snprintf(message_buffer + length,
+                       size - length,
+                       "\"updated\": %u, \"seq\": %lu, \"alarm\": %s, \"timestamp\": %s}",
+                       updated_samples,
+                       (unsigned long)seq,
+                       alarm == ALARM_ON ? "true" : "false",
+                       time);
+  }
+
+  return MIN(length, size - 1);
+}
+/*---------------------------------------------------------------------------*/
 void
 json_message_monitor_registration(char *message_buffer, size_t size, char *monitor_id)
 {
@@ -57,60 +193,135 @@ json_message_alarm_stopped(char *message_buffer, size_t size)
   snprintf(message_buffer, size, "%s", "{\"alarm\": false}");
 }
 /*---------------------------------------------------------------------------*/
-void
-json_message_heart_rate_sample(char *message_buffer, size_t size, int sample)
+int
+json_message_sensor_sample(char *message_buffer, size_t size, sensor_type sensor, int sample,
+                           clock_time_t tick)
 {
+  char time[JSON_MESSAGE_TIME_MAX_LENGTH];
+  int length;
+
   clear_buffer(message_buffer, size);
-  snprintf(message_buffer,
-           size,
-           "{\"heartRate\": %d, \"unit\": \"%s\", \"timestamp\": %ld}",
-           sample,
-           HEART_RATE_UNIT,
-           clock_seconds());
+  time_sync_snprint(time, JSON_MESSAGE_TIME_MAX_LENGTH, tick);
+  length = snprintf(message_buffer,
+                    size,
+                    "{\"%s\": %d, \"unit\": \"%s\", \"timestamp\": %s}",
+                    sensor_keys[sensor],
+                    sample,
+                    sensor_units[sensor],
+                    time);
+
+  return MIN(length, size - 1);
 }
 /*---------------------------------------------------------------------------*/
-void json_message_blood_pressure_sample(char *message_buffer, size_t size, int sample)
+int
+json_message_alarm_history(char *message_buffer, size_t size, struct alarm_history *history, uint32_t since)
 {
+  const struct alarm_event *event;
+  uint32_t seq;
+  int length;
+  int event_length;
+  char event_buffer[JSON_MESSAGE_ALARM_EVENT_MAX_LENGTH];
+  char time[JSON_MESSAGE_TIME_MAX_LENGTH];
+
   clear_buffer(message_buffer, size);
-  snprintf(message_buffer,
-           size,
-           "{\"bloodPressure\": %d, \"unit\": \"%s\", \"timestamp\": %ld}",
-           sample,
-           BLOOD_PRESSURE_UNIT,
-           clock_seconds());
+
+  if(since > history->next_seq || since < alarm_history_oldest_seq(history)) {
+    since = alarm_history_oldest_seq(history);
+  }
+
+  length = snprintf(message_buffer, size, "%s", "{\"alarmHistory\": [");
+
+  for(seq = since; seq < history->next_seq; seq++) {
+    event = alarm_history_get(history, seq);
+    time_sync_snprint(time, JSON_MESSAGE_TIME_MAX_LENGTH, event->tick);
+    event_length = snprintf(event_buffer,
+                            JSON_MESSAGE_ALARM_EVENT_MAX_LENGTH,
+                            "%s[%lu,%s,%d,%d,%d]",
+                            seq == since ? "" : ",",
+                            (unsigned long)event->seq,
+                            time,
+                            event->sensor,
+                            event->value,
+                            event->transition == ALARM_ON ? 1 : 0);
+
+    /* Leave room for the closing part of the message. */
+    if(length + event_length + JSON_MESSAGE_ALARM_HISTORY_TAIL_LENGTH >= size) {
+      break;
+    }
+
+    memcpy(message_buffer + length, event_buffer, event_length);
+    length += event_length;
+  }
+
+  time_sync_snprint(time, JSON_MESSAGE_TIME_MAX_LENGTH, clock_time());
+  length += snprintf(message_buffer + length, size - length, JSON_MESSAGE_ALARM_HISTORY_TAIL, (unsigned long)seq, time);
+  return MIN(length, size - 1);
 }
 /*---------------------------------------------------------------------------*/
-void json_message_oxygen_saturation_sample(char *message_buffer, size_t size, int sample)
+int
+json_message_patient_state(char *message_buffer, size_t size, const int *samples, uint8_t updated_samples,
+                           alarm_state alarm, uint32_t seq)
 {
-  clear_buffer(message_buffer, size);
-  snprintf(message_buffer,
-           size,
-           "{\"oxygenSaturation\": %d, \"unit\": \"%s\", \"timestamp\": %ld}",
-           sample,
-           OXYGEN_SATURATION_UNIT,
-           clock_seconds());
+  return encode_patient_state(message_buffer, size, NULL, samples, updated_samples, alarm, seq);
 }
 /*---------------------------------------------------------------------------*/
-void json_message_respiration_sample(char *message_buffer, size_t size, int sample)
+int
+json_message_monitor_state(char *message_buffer, size_t size, char *patient_id, const int *samples,
+                           alarm_state alarm, uint32_t seq)
 {
-  clear_buffer(message_buffer, size);
-  snprintf(message_buffer,
-           size,
-           "{\"respiration\": %d, \"unit\": \"%s\", \"timestamp\": %ld}",
-           sample,
-           RESPIRATION_UNIT,
-           clock_seconds());
+  return encode_patient_state(message_buffer, size, patient_id, samples, 0, alarm, seq);
+}
+/*---------------------------------------------------------------------------*/
+int
+json_message_sample_history(char *message_buffer, size_t size, struct sample_history *history, uint32_t since,
+                            uint32_t *next)
+{
+  uint32_t until = history->next_seq;
+  int length;
+
+  if(since > history->next_seq || since < sample_history_oldest_seq(history)) {
+    since = sample_history_oldest_seq(history);
+  }
+
+  /* If the buffer cannot hold all the samples, the newest ones are left out. */
+  while((length = encode_sample_history(message_buffer, size, history, since, until)) < 0 && until > since) {
+    until = since + (until - since) / 2;
+  }
+
+  if(next != NULL) {
+    *next = until;
+  }
+
+  return MAX(length, 0);
 }
 /*---------------------------------------------------------------------------*/
-void json_message_temperature_sample(char *message_buffer, size_t size, int sample)
+int
+json_message_diagnostics(char *message_buffer, size_t size, const struct monitor_diagnostics *report)
 {
+  char time[JSON_MESSAGE_TIME_MAX_LENGTH];
+  int length;
+
   clear_buffer(message_buffer, size);
-  snprintf(message_buffer,
-           size,
-           "{\"temperature\": %d, \"unit\": \"%s\", \"timestamp\": %ld}",
-           sample,
-           TEMPERATURE_UNIT,
-           clock_seconds());
+  time_sync_snprint(time, JSON_MESSAGE_TIME_MAX_LENGTH, clock_time());
+  length = snprintf(message_buffer,
+                    size,
+                    "{\"period\": %lu, \"cpu\": %lu, \"lpm\": %lu, \"radioTx\": %lu, \"radioRx\": %lu, "
+                    "\"queueHighWaterMark\": %u, \"dropped\": %lu, \"failures\": [%lu,%lu,%lu,%lu,%lu], \"timestamp\": %s}",
+                    (unsigned long)report->period,
+                    (unsigned long)report->cpu_time,
+                    (unsigned long)report->lpm_time,
+                    (unsigned long)report->radio_tx_time,
+                    (unsigned long)report->radio_rx_time,
+                    report->queue_high_water_mark,
+                    (unsigned long)report->dropped_messages,
+                    (unsigned long)report->publish_failures[0],
+                    (unsigned long)report->publish_failures[1],
+                    (unsigned long)report->publish_failures[2],
+                    (unsigned long)report->publish_failures[3],
+                    (unsigned long)report->publish_failures[4],
+                    time);
+
+  return MIN(length, size - 1);
 }
 /*---------------------------------------------------------------------------*/
 /** @} */
@@ -10,12 +10,19 @@
  * @{
  *
  * The json-message module provides functions to generate the JSON payloads of
- * MQTT/CoAP messages exchanged with the collector.
+ * MQTT/CoAP messages exchanged with the collector. All the times are in milliseconds
+ * since the epoch, or since the boot of the monitor until it is synchronized with the
+ * collector (see time-sync).
  */
 
 #ifndef SMART_ICU_JSON_MESSAGE_H
 #define SMART_ICU_JSON_MESSAGE_H
 
+#include <stdint.h>
+#include "./alarm-history.h"
+#include "./sample-history.h"
+#include "./monitor-diagnostics.h"
+
 /**
  * \brief                  Generate a monitor registration message.
  * \param message_buffer   A pointer to the buffer that will store the message.
@@ -61,59 +68,124 @@ void json_message_alarm_started(char *message_buffer, size_t size);
 void json_message_alarm_stopped(char *message_buffer, size_t size);
 
 /**
- * \brief                  Generate a message containing a heart rate sample.
+ * \brief                  Generate a message containing a sample of a sensor.
  * \param message_buffer   A pointer to the buffer that will store the message.
  * \param size             The size of the buffer.
- * \param sample           The heart rate sample.
+ * \param sensor           The sensor that produced the sample.
+ * \param sample           The sample.
+ * \param tick             The clock tick at which the sample was produced.
+ * \return                 The length of the generated message.
  *
- *                         The function generates a message containing a heart rate sample,
- *                         together with its measurement unit and the current timestamp.
+ *                         The function generates a message containing a sample of a sensor,
+ *                         together with its measurement unit and timestamp.
+ *                         The message fits in a single CoAP block.
  */
-void json_message_heart_rate_sample(char *message_buffer, size_t size, int sample);
+int json_message_sensor_sample(char *message_buffer, size_t size, sensor_type sensor, int sample,
+                               clock_time_t tick);
 
 /**
- * \brief                  Generate a message containing a blood pressure sample.
+ * \brief                  Generate a message containing the events stored in an alarm history.
  * \param message_buffer   A pointer to the buffer that will store the message.
  * \param size             The size of the buffer.
- * \param sample           The blood pressure sample.
+ * \param history          A pointer to the alarm history.
+ * \param since            The sequence number of the first event to be inserted.
+ * \return                 The length of the generated message.
  *
- *                         The function generates a message containing a blood pressure sample,
- *                         together with its measurement unit and the current timestamp.
+ *                         The function generates a message containing the events of the alarm history
+ *                         whose sequence number is greater than or equal to <code>since</code>.
+ *                         Each event is encoded as the array [seq, timestamp, sensor, value, alarm],
+ *                         where sensor is the index of the sensor (-1 if none) and alarm is 1 if the
+ *                         alarm was turned on, 0 otherwise. The message also carries the time at which
+ *                         it was generated ("sent") and the field "next",
+ *                         i.e. the sequence number from which a subsequent request should start:
+ *                         if the buffer cannot hold all the events, the newest ones are left out
+ *                         and "next" points to the first of them.
+ *                         If <code>since</code> is greater than the next sequence number of the history
+ *                         (e.g. the requester knows the history of a previous boot), all the stored events
+ *                         are inserted.
  */
-void json_message_blood_pressure_sample(char *message_buffer, size_t size, int sample);
+int json_message_alarm_history(char *message_buffer, size_t size, struct alarm_history *history, uint32_t since);
 
 /**
- * \brief                  Generate a message containing an oxygen saturation sample.
- * \param message_buffer   A pointer to the buffer that will store the message.
- * \param size             The size of the buffer.
- * \param sample           The oxygen saturation sample.
+ * \brief                   Generate a message containing the current state of a patient.
+ * \param message_buffer    A pointer to the buffer that will store the message.
+ * \param size              The size of the buffer.
+ * \param samples           The last sample of each sensor, indexed by sensor_type
+ *                          (negative if the sensor has not produced a sample yet).
+ * \param updated_samples   Bitmask of the sensors (bit i for the sensor of index i)
+ *                          that produced a sample since the previous message.
+ * \param alarm             The state of the alarm system.
+ * \param seq               The next sequence number of the sample history, i.e. the
+ *                          sequence number following the one of the newest sample.
+ * \return                  The length of the generated message.
+ *
+ *                          The function generates a message containing the last samples of
+ *                          all the sensors, the alarm state and the current timestamp. The bitmask
+ *                          allows the receiver to store only the samples that are actually new,
+ *                          while the sequence number allows it to detect the samples it missed.
+ */
+int json_message_patient_state(char *message_buffer, size_t size, const int *samples, uint8_t updated_samples,
+                               alarm_state alarm, uint32_t seq);
+
+/**
+ * \brief                   Generate a message containing the last known state of a monitor.
+ * \param message_buffer    A pointer to the buffer that will store the message.
+ * \param size              The size of the buffer.
+ * \param patient_id        The ID of the patient attached to the monitor (empty if none).
+ * \param samples           The last sample of each sensor, indexed by sensor_type
+ *                          (negative if the sensor has not produced a sample yet).
+ * \param alarm             The state of the alarm system.
+ * \param seq               The next sequence number of the sample history.
+ * \return                  The length of the generated message.
  *
- *                         The function generates a message containing an oxygen saturation sample,
- *                         together with its measurement unit and the current timestamp.
+ *                          The function generates a message with the same fields of a patient
+ *                          state message, preceded by the patient ID. No sample is marked as
+ *                          updated: the message describes the state of the monitor, e.g. for
+ *                          a receiver that just started, and its samples are not new.
  */
-void json_message_oxygen_saturation_sample(char *message_buffer, size_t size, int sample);
+int json_message_monitor_state(char *message_buffer, size_t size, char *patient_id, const int *samples,
+                               alarm_state alarm, uint32_t seq);
 
 /**
- * \brief                  Generate a message containing a respiration sample.
+ * \brief                  Generate a message containing the samples stored in a sample history.
  * \param message_buffer   A pointer to the buffer that will store the message.
  * \param size             The size of the buffer.
- * \param sample           The respiration sample.
+ * \param history          A pointer to the sample history.
+ * \param since            The sequence number of the first sample to be inserted.
+ * \param next             A pointer to the variable that will store the value of the field "next"
+ *                         of the message, or NULL.
+ * \return                 The length of the generated message.
  *
- *                         The function generates a message containing a respiration sample,
- *                         together with its measurement unit and the current timestamp.
+ *                         The function generates a message containing the samples of the history
+ *                         whose sequence number is greater than or equal to <code>since</code>.
+ *                         The samples are grouped in an array per sensor, indexed as sensor_type.
+ *                         In each array, the first sample is encoded as sensor_seq,seq,time,value,
+ *                         where sensor_seq is its sequence number among the samples of the sensor
+ *                         and time the time at which it was captured, while the following ones
+ *                         are encoded as the deltas of seq,time,value from the previous sample of the
+ *                         sensor. The field "sent" carries the time at which the message was generated,
+ *                         so that the receiver can compute how long the samples waited on the monitor
+ *                         and, once the monitor is synchronized, in the network. The message also carries the field "next",
+ *                         i.e. the sequence number from which a subsequent request should start:
+ *                         if the buffer cannot hold all the samples, the newest ones are left out.
+ *                         If <code>since</code> is greater than the next sequence number of the history
+ *                         (e.g. the requester knows the history of a previous boot) or refers to
+ *                         overwritten samples, all the stored samples are inserted.
  */
-void json_message_respiration_sample(char *message_buffer, size_t size, int sample);
+int json_message_sample_history(char *message_buffer, size_t size, struct sample_history *history, uint32_t since,
+                                uint32_t *next);
 
 /**
- * \brief                  Generate a message containing a temperature sample.
+ * \brief                  Generate a diagnostics message.
  * \param message_buffer   A pointer to the buffer that will store the message.
  * \param size             The size of the buffer.
- * \param sample           The temperature sample.
+ * \param report           A pointer to the diagnostics report of the last period.
+ * \return                 The length of the generated message.
  *
- *                         The function generates a message containing a temperature sample,
- *                         together with its measurement unit and the current timestamp.
+ *                         The times of the report are in milliseconds, and the field "failures"
+ *                         carries the refused publications indexed by status (see monitor-diagnostics).
  */
-void json_message_temperature_sample(char *message_buffer, size_t size, int sample);
+int json_message_diagnostics(char *message_buffer, size_t size, const struct monitor_diagnostics *report);
 
 #endif /* SMART_ICU_JSON_MESSAGE_H */
 /** @} */
@@ -0,0 +1,336 @@
+/**
+ * \file
+ *         Implementation of the runtime configuration of a monitor
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \addtogroup monitor-config
+ * @{
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "contiki.h"
+#include "os/sys/log.h"
+#include "os/storage/cfs/cfs.h"
+#include "./alarm-constants.h"
+#include "./sensors/utils/sensor-constants.h"
+#include "./monitor-config.h"
+#include "./monitor-log.h"
+
+#define LOG_MODULE "Monitor config"
+#define LOG_LEVEL LOG_LEVEL_MONITOR_CONFIG
+
+#define MONITOR_CONFIG_VERSION           2    /* Version of the persisted configuration, changed with its layout. */
+#define MONITOR_CONFIG_KEY_MAX_LENGTH    4    /* Maximum length of a key of a command, index excluded. */
+#define MONITOR_CONFIG_VALUE_MAX         9999 /* Maximum absolute value of a parameter. */
+#define MONITOR_CONFIG_LOG_LEVEL_UNSET   -1   /* The log levels of the Contiki modules were not changed. */
+
+/* Structure holding the tunable parameters, as persisted in the file system. */
+struct monitor_config {
+  uint16_t version;
+  int16_t min_thresholds[SENSORS_NUMBER];
+  int16_t max_thresholds[SENSORS_NUMBER];
+  uint16_t sampling_intervals[SENSORS_NUMBER];
+  uint16_t send_interval;
+  int8_t log_level;
+  uint8_t module_log_levels[MONITOR_LOG_MODULES_NUMBER];
+};
+
+/* Configuration built from the compile-time constants, indexed by sensor_type. */
+static const struct monitor_config default_config = {
+  .version = MONITOR_CONFIG_VERSION,
+  .min_thresholds = { ALARM_HEART_RATE_MIN_THRESHOLD, ALARM_BLOOD_PRESSURE_MIN_THRESHOLD, ALARM_TEMPERATURE_MIN_THRESHOLD,
+                      ALARM_RESPIRATION_MIN_THRESHOLD, ALARM_OXYGEN_SATURATION_MIN_THRESHOLD },
+  .max_thresholds = { ALARM_HEART_RATE_MAX_THRESHOLD, ALARM_BLOOD_PRESSURE_MAX_THRESHOLD, ALARM_TEMPERATURE_MAX_THRESHOLD,
+                      ALARM_RESPIRATION_MAX_THRESHOLD, ALARM_OXYGEN_SATURATION_MAX_THRESHOLD },
+  .sampling_intervals = { HEART_RATE_SAMPLING_INTERVAL, BLOOD_PRESSURE_SAMPLING_INTERVAL, TEMPERATURE_SAMPLING_INTERVAL,
+                          RESPIRATION_SAMPLING_INTERVAL, OXYGEN_SATURATION_SAMPLING_INTERVAL },
+  .send_interval = 0,
+  .log_level = MONITOR_CONFIG_LOG_LEVEL_UNSET,
+  .module_log_levels = { MONITOR_LOG_DEFAULT_LEVEL, MONITOR_LOG_DEFAULT_LEVEL, MONITOR_LOG_DEFAULT_LEVEL,
+                         MONITOR_LOG_DEFAULT_LEVEL, MONITOR_LOG_DEFAULT_LEVEL, MONITOR_LOG_DEFAULT_LEVEL,
+                         MONITOR_LOG_DEFAULT_LEVEL },
+};
+
+static struct monitor_config config;
+
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief   Restore the persisted configuration.
+ * \return  true if a valid configuration was restored, false otherwise.
+ */
+static bool
+load(void)
+{
+  struct monitor_config persisted;
+  int fd;
+  int length;
+
+  fd = cfs_open(MONITOR_CONFIG_FILE, CFS_READ);
+  if(fd < 0) {
+    return false;
+  }
+  length = cfs_read(fd, &persisted, sizeof(persisted));
+  cfs_close(fd);
+
+  if(length != sizeof(persisted) || persisted.version != MONITOR_CONFIG_VERSION) {
+    LOG_WARN("Ignoring the persisted configuration: bad format.\n");
+    return false;
+  }
+
+  config = persisted;
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief   Persist the current configuration.
+ * \return  true if the configuration was persisted, false otherwise.
+ */
+static bool
+save(void)
+{
+  int fd;
+  int length;
+
+  cfs_remove(MONITOR_CONFIG_FILE);
+  fd = cfs_open(MONITOR_CONFIG_FILE, CFS_WRITE);
+  if(fd < 0) {
+    LOG_ERR("Failed to open the configuration file.\n");
+    return false;
+  }
+  length = cfs_write(fd, &config, sizeof(config));
+  cfs_close(fd);
+
+  if(length != sizeof(config)) {
+    LOG_ERR("Failed to persist the configuration.\n");
+    return false;
+  }
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief   Apply the configured log levels to the Contiki modules, if any, and to the modules of the monitor.
+ *
+ *          The levels cannot exceed the ones set at compile time for each module.
+ */
+static void
+apply_log_levels(void)
+{
+  int i;
+
+  if(config.log_level != MONITOR_CONFIG_LOG_LEVEL_UNSET) {
+    log_set_level("all", config.log_level);
+  }
+  for(i = 0; i < MONITOR_LOG_MODULES_NUMBER; i++) {
+    monitor_log_set_level(i, config.module_log_levels[i]);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief          Parse a decimal integer, optionally negative.
+ * \param cursor   A pointer to the position of the integer, advanced past it.
+ * \param end      The end of the command.
+ * \param value    A pointer to the variable where the integer is stored.
+ * \return         true if an integer not exceeding MONITOR_CONFIG_VALUE_MAX was parsed, false otherwise.
+ */
+static bool
+parse_int(const char **cursor, const char *end, int *value)
+{
+  bool negative = false;
+  const char *digits;
+  int result = 0;
+
+  if(*cursor < end && **cursor == '-') {
+    negative = true;
+    (*cursor)++;
+  }
+
+  digits = *cursor;
+  while(*cursor < end && **cursor >= '0' && **cursor <= '9') {
+    result = result * 10 + (**cursor - '0');
+    if(result > MONITOR_CONFIG_VALUE_MAX) {
+      return false;
+    }
+    (*cursor)++;
+  }
+  if(*cursor == digits) {
+    return false;
+  }
+
+  *value = negative ? -result : result;
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief          Set a parameter of a configuration.
+ * \param target   The configuration.
+ * \param key      The key of the parameter, without index.
+ * \param index    The index following the key, or -1 if missing.
+ * \param value    The value of the parameter.
+ * \param persist  A pointer to the variable set if the configuration must be persisted.
+ * \return         true if the key, the index and the value are valid, false otherwise.
+ */
+static bool
+set_parameter(struct monitor_config *target, const char *key, int index, int value, bool *persist)
+{
+  int indexes = 0;  /* Number of the valid indexes of the key, or 0 if the key takes none. */
+
+  if(strcmp(key, "min") == 0 || strcmp(key, "max") == 0 || strcmp(key, "int") == 0) {
+    indexes = SENSORS_NUMBER;
+  } else if(strcmp(key, "lvl") == 0) {
+    indexes = MONITOR_LOG_MODULES_NUMBER;
+  }
+  if((indexes > 0) != (index >= 0) || index >= indexes) {
+    return false;
+  }
+
+  if(strcmp(key, "min") == 0) {
+    target->min_thresholds[index] = value;
+    return true;
+  }
+  if(strcmp(key, "max") == 0) {
+    target->max_thresholds[index] = value;
+    return true;
+  }
+  if(strcmp(key, "int") == 0 && value > 0) {
+    target->sampling_intervals[index] = value;
+    return true;
+  }
+  if(strcmp(key, "send") == 0 && value >= 0) {
+    target->send_interval = value;
+    return true;
+  }
+  if(strcmp(key, "log") == 0 && value >= LOG_LEVEL_NONE && value <= LOG_LEVEL_DBG) {
+    target->log_level = value;
+    return true;
+  }
+  if(strcmp(key, "lvl") == 0 && value >= LOG_LEVEL_NONE && value <= LOG_LEVEL_DBG) {
+    target->module_log_levels[index] = value;
+    return true;
+  }
+  if(strcmp(key, "save") == 0 && (value == 0 || value == 1)) {
+    *persist = value;
+    return true;
+  }
+  return false;
+}
+/*---------------------------------------------------------------------------*/
+void
+monitor_config_init(void)
+{
+  if(load()) {
+    LOG_INFO("Restored the persisted configuration.\n");
+  } else {
+    config = default_config;
+  }
+  apply_log_levels();
+}
+/*---------------------------------------------------------------------------*/
+bool
+monitor_config_apply(const char *command, uint16_t length)
+{
+  const char *end = command + length;
+  const char *cursor = command;
+  struct monitor_config updated = config;
+  char key[MONITOR_CONFIG_KEY_MAX_LENGTH + 1];
+  bool persist = false;
+  int key_length;
+  int index;
+  int value;
+  int i;
+
+  /* The command may be null terminated. */
+  while(cursor < end && *cursor != '\0') {
+    key_length = 0;
+    while(cursor < end && *cursor >= 'a' && *cursor <= 'z' && key_length < MONITOR_CONFIG_KEY_MAX_LENGTH) {
+      key[key_length++] = *cursor++;
+    }
+    key[key_length] = '\0';
+
+    index = -1;
+    if(cursor < end && *cursor >= '0' && *cursor <= '9') {
+      index = *cursor++ - '0';
+    }
+
+    if(key_length == 0 || cursor == end || *cursor++ != '='
+       || !parse_int(&cursor, end, &value)
+       || !set_parameter(&updated, key, index, value, &persist)) {
+      LOG_INFO("Discarding the configuration command: bad format.\n");
+      return false;
+    }
+
+    if(cursor < end && *cursor == '&') {
+      cursor++;
+    } else if(cursor < end && *cursor != '\0') {
+      LOG_INFO("Discarding the configuration command: bad format.\n");
+      return false;
+    }
+  }
+
+  for(i = 0; i < SENSORS_NUMBER; i++) {
+    if(updated.min_thresholds[i] >= updated.max_thresholds[i]) {
+      LOG_INFO("Discarding the configuration command: bad thresholds of the sensor %d.\n", i);
+      return false;
+    }
+  }
+
+  config = updated;
+  apply_log_levels();
+  LOG_INFO("Configuration updated.\n");
+
+  if(persist && save()) {
+    LOG_INFO("Configuration persisted.\n");
+  }
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+int
+monitor_config_min_threshold(sensor_type sensor)
+{
+  return config.min_thresholds[sensor];
+}
+/*---------------------------------------------------------------------------*/
+int
+monitor_config_max_threshold(sensor_type sensor)
+{
+  return config.max_thresholds[sensor];
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+monitor_config_sampling_interval(sensor_type sensor)
+{
+  return config.sampling_intervals[sensor];
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+monitor_config_send_interval(uint16_t default_interval)
+{
+  return config.send_interval > 0 ? config.send_interval : default_interval;
+}
+/*---------------------------------------------------------------------------*/
+int
+monitor_config_snprint(char *buffer, size_t size)
+{
+  int length = 0;
+  int i;
+
+  for(i = 0; i < SENSORS_NUMBER && length < size; i++) {
+    length += snprintf(buffer + length, size - length, "min%d=%d&max%d=%d&int%d=%u&",
+                       i, config.min_thresholds[i], i, config.max_thresholds[i], i, config.sampling_intervals[i]);
+  }
+  if(length < size) {
+    length += snprintf(buffer + length, size - length, "send=%u", config.send_interval);
+  }
+  if(length < size && config.log_level != MONITOR_CONFIG_LOG_LEVEL_UNSET) {
+    length += snprintf(buffer + length, size - length, "&log=%d", config.log_level);
+  }
+  for(i = 0; i < MONITOR_LOG_MODULES_NUMBER && length < size; i++) {
+    length += snprintf(buffer + length, size - length, "&lvl%d=%u", i, config.module_log_levels[i]);
+  }
+  return length;
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -0,0 +1,96 @@
+/**
+ * \file
+ *         Header file for the runtime configuration of a monitor
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \defgroup monitor-config Runtime configuration
+ * @{
+ *
+ * The monitor-config module holds the parameters that can be tuned by the collector
+ * without reflashing the monitor: the alarm thresholds and the sampling interval of each
+ * sensor, the interval at which the pending messages are sent and the log levels of the
+ * Contiki modules and of the modules of the monitor. The parameters start from the
+ * compile-time constants and are changed by configuration commands, made of
+ * <code>key=value</code> pairs separated by <code>&</code>:
+ * <ul>
+ *   <li><code>min&lt;i&gt;</code>, <code>max&lt;i&gt;</code>: the alarm thresholds of the sensor with index i;</li>
+ *   <li><code>int&lt;i&gt;</code>: the sampling interval in seconds of the sensor with index i;</li>
+ *   <li><code>send</code>: the send interval in seconds, or 0 for the default of the transport;</li>
+ *   <li><code>log</code>: the log level of the Contiki modules, from LOG_LEVEL_NONE to LOG_LEVEL_DBG;</li>
+ *   <li><code>lvl&lt;i&gt;</code>: the log level of the module of the monitor with index i
+ *       (see monitor-log.h), from LOG_LEVEL_NONE to LOG_LEVEL_DBG;</li>
+ *   <li><code>save</code>: if 1, the resulting configuration is persisted in the file system
+ *       and restored at the next boot.</li>
+ * </ul>
+ * For example, <code>min0=45&max0=130&int0=30&save=1</code>. A command is applied only if
+ * all its pairs are valid. A new sampling interval is applied from the next sample of the sensor.
+ */
+
+#ifndef SMART_ICU_MONITOR_CONFIG_H
+#define SMART_ICU_MONITOR_CONFIG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "./sensors-cmd.h"
+
+#define MONITOR_CONFIG_FILE              "smarticu.cfg" /* Name of the file persisting the configuration. */
+#define MONITOR_CONFIG_MAX_LENGTH        256            /* Maximum length of the representation of the configuration. */
+
+/**
+ * \brief   Initialize the configuration, restoring the persisted one if any,
+ *          or the compile-time constants otherwise.
+ */
+void monitor_config_init(void);
+
+/**
+ * \brief           Apply a configuration command.
+ * \param command   The command, not necessarily null terminated.
+ * \param length    The length of the command.
+ * \return          true if the command was applied, false if it was malformed
+ *                  or carried invalid values, in which case nothing is changed.
+ */
+bool monitor_config_apply(const char *command, uint16_t length);
+
+/**
+ * \brief          Get the minimum alarm threshold of a sensor.
+ * \param sensor   The sensor.
+ * \return         The samples less than or equal to the threshold trigger an alarm.
+ */
+int monitor_config_min_threshold(sensor_type sensor);
+
+/**
+ * \brief          Get the maximum alarm threshold of a sensor.
+ * \param sensor   The sensor.
+ * \return         The samples greater than or equal to the threshold trigger an alarm.
+ */
+int monitor_config_max_threshold(sensor_type sensor);
+
+/**
+ * \brief          Get the sampling interval of a sensor.
+ * \param sensor   The sensor.
+ * \return         The sampling interval, in seconds.
+ */
+uint16_t monitor_config_sampling_interval(sensor_type sensor);
+
+/**
+ * \brief                    Get the interval at which the pending messages are sent.
+ * \param default_interval   The default interval of the transport, in seconds.
+ * \return                   The configured send interval in seconds, or <code>default_interval</code>
+ *                           if the collector did not configure it.
+ */
+uint16_t monitor_config_send_interval(uint16_t default_interval);
+
+/**
+ * \brief          Write the current configuration in the format of the commands.
+ * \param buffer   The buffer where the configuration is written.
+ * \param size     The size of the buffer.
+ * \return         The length of the configuration, as returned by <code>snprintf()</code>.
+ */
+int monitor_config_snprint(char *buffer, size_t size);
+
+#endif /* SMART_ICU_MONITOR_CONFIG_H */
+/** @} */
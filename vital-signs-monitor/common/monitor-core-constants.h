@@ -0,0 +1,32 @@
+/**
+ * \file
+ *         Constants used by the transport-agnostic core of a monitor
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \defgroup monitor-core-constants Monitor core constants
+ * @{
+ *
+ * Constants used by the core of a vital signs monitor to size the patient ID
+ * to interpret the button press events, to space the attempts to reach the collector
+ * and to pace the diagnostics reports, independently of the transport protocol.
+ */
+
+#ifndef SMART_ICU_MONITOR_CORE_CONSTANTS_H
+#define SMART_ICU_MONITOR_CORE_CONSTANTS_H
+
+#define MONITOR_CORE_PATIENT_ID_LENGTH           10 /* The maximum length of a patient ID. */
+#define MONITOR_CORE_RESET_PATIENT_ID_DURATION   10 /* Time in seconds for which the button must be kept pressed to reset the patient ID. */
+#define MONITOR_CORE_RESET_ALARM_DURATION        5  /* Time in seconds for which the button must be kept pressed to reset the alarm state. */
+
+/* Backoff of the registration to the collector (CoAP) or of the connection to the broker (MQTT). */
+#define MONITOR_CORE_BACKOFF_INITIAL_WINDOW      10 /* Maximum random delay in seconds before the first attempt. */
+#define MONITOR_CORE_BACKOFF_BASE_DELAY          4  /* Delay in seconds after the first failure, doubled after each further one. */
+#define MONITOR_CORE_BACKOFF_MAX_DELAY           120 /* Maximum delay in seconds between two attempts. */
+
+#define MONITOR_CORE_DIAGNOSTICS_INTERVAL        5  /* Interval in minutes between two diagnostics reports. */
+
+#endif /* SMART_ICU_MONITOR_CORE_CONSTANTS_H */
+/** @} */
@@ -0,0 +1,244 @@
+/**
+ * \file
+ *         Implementation of the transport-agnostic core of a vital signs monitor
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \addtogroup monitor-core
+ * @{
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "contiki.h"
+#include "os/sys/log.h"
+#include "os/net/ipv6/uip-ds6.h"
+#include "./alarm-constants.h"
+#include "./monitor-core.h"
+#include "./time-sync.h"
+#include "./monitor-config.h"
+#include "./monitor-log.h"
+
+#define LOG_MODULE "Monitor core"
+#define LOG_LEVEL LOG_LEVEL_MONITOR_CORE
+
+/* Names of the sensors, indexed by sensor_type. */
+static const char *sensor_names[SENSORS_NUMBER] = {
+  "heart rate",
+  "blood pressure",
+  "temperature",
+  "respiration",
+  "oxygen saturation",
+};
+
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief                 Check if a sample should trigger an alarm.
+ * \param min_threshold   The minimum threshold that should trigger an alarm.
+ * \param max_threshold   The maximum threshold that should trigger an alarm.
+ * \param sample          The sample to be checked.
+ * \return                true if the event should trigger an alarm, false otherwise.
+ *
+ *                        The function checks if a sample should trigger an alarm,
+ *                        i.e. if the sample is less than or equal to <code>min_threshold</code>,
+ *                        or greater than or equal to <code>max_threshold</code>.
+ */
+static bool
+alarming_sample(int min_threshold, int max_threshold, int sample)
+{
+  if(sample <= min_threshold || sample >= max_threshold) {
+    return true;
+  }
+  return false;
+}
+/*---------------------------------------------------------------------------*/
+/* Callback function used by the ctimer of the diagnostics. */
+static void
+report_diagnostics(void *data)
+{
+  struct monitor_core *core = (struct monitor_core *)data;
+  struct monitor_diagnostics report;
+
+  monitor_diagnostics_collect(&report);
+  LOG_INFO("Diagnostics of the last %lu ms: CPU %lu ms, LPM %lu ms, radio TX %lu ms, radio RX %lu ms.\n",
+           (unsigned long)report.period,
+           (unsigned long)report.cpu_time,
+           (unsigned long)report.lpm_time,
+           (unsigned long)report.radio_tx_time,
+           (unsigned long)report.radio_rx_time);
+  core->transport->publish_diagnostics(&report);
+  ctimer_reset(&core->diagnostics_timer);
+}
+/*---------------------------------------------------------------------------*/
+void
+monitor_core_init(struct monitor_core *core, const struct monitor_transport *transport, struct process *process)
+{
+  core->transport = transport;
+  core->process = process;
+  memset(core->patient_id, 0, MONITOR_CORE_PATIENT_ID_LENGTH);
+
+  /* Initialize the alarm system and its history. */
+  alarm_init(&core->alarm);
+  alarm_history_init(&core->alarm_history);
+
+  /* The times are relative to the boot until the collector sends its time. */
+  time_sync_init();
+
+  /* Restore the parameters tuned by the collector, if persisted. */
+  monitor_config_init();
+
+  /* Account for the resources used by the monitor, reported periodically to the collector. */
+  monitor_diagnostics_init();
+  ctimer_set(&core->diagnostics_timer,
+             MONITOR_CORE_DIAGNOSTICS_INTERVAL*60*CLOCK_SECOND,
+             report_diagnostics,
+             core);
+}
+/*---------------------------------------------------------------------------*/
+void
+monitor_core_set_transport(struct monitor_core *core, const struct monitor_transport *transport)
+{
+  core->transport = transport;
+}
+/*---------------------------------------------------------------------------*/
+bool
+monitor_core_network_ready(void)
+{
+  if(uip_ds6_get_global(ADDR_PREFERRED) == NULL || uip_ds6_defrt_choose() == NULL) {
+    LOG_INFO("Connecting to the network.\n");
+    return false;
+  }
+
+  LOG_INFO("Connected to the network. ");
+  LOG_INFO_("Global address: ");
+  LOG_INFO_6ADDR(&(uip_ds6_get_global(ADDR_PREFERRED)->ipaddr));
+  LOG_INFO_(". Link local address: ");
+  LOG_INFO_6ADDR(&(uip_ds6_get_link_local(ADDR_PREFERRED)->ipaddr));
+  LOG_INFO_("\n");
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+bool
+monitor_core_start(struct monitor_core *core)
+{
+  /* Start the sensor processes (without starting the sampling activity). */
+  sensors_cmd_start_processes();
+
+  return monitor_core_wait_patient_id(core);
+}
+/*---------------------------------------------------------------------------*/
+bool
+monitor_core_wait_patient_id(struct monitor_core *core)
+{
+  LOG_INFO("Waiting for a new patient ID on the serial line.\n");
+
+#ifdef AUTOMATIC_PATIENT_ID_CONFIGURATION
+  LOG_INFO("Automatic configuration of the new patient ID.\n");
+  char random_patient_ID[MONITOR_CORE_PATIENT_ID_LENGTH];
+  snprintf(random_patient_ID, MONITOR_CORE_PATIENT_ID_LENGTH, "auto_%d", rand());
+  monitor_core_set_patient_id(core, random_patient_ID);
+  return true;
+#else
+  return false;
+#endif
+}
+/*---------------------------------------------------------------------------*/
+void
+monitor_core_set_patient_id(struct monitor_core *core, char *patient_id)
+{
+  memcpy(core->patient_id, patient_id, MONITOR_CORE_PATIENT_ID_LENGTH);
+  core->patient_id[MONITOR_CORE_PATIENT_ID_LENGTH - 1] = '\0';
+  LOG_INFO("New patient ID: %s.\n", core->patient_id);
+
+  /* Inform the collector about the new patient ID. */
+  core->transport->publish_patient_id(core->patient_id);
+
+  /* Start the sampling activity of the sensors. */
+  sensors_cmd_start_sampling(core->process);
+}
+/*---------------------------------------------------------------------------*/
+bool
+monitor_core_handle_button_press(struct monitor_core *core, button_hal_button_t *button)
+{
+  LOG_INFO("Button press event: %d s.\n", button->press_duration_seconds);
+
+  if(button->press_duration_seconds == MONITOR_CORE_RESET_ALARM_DURATION
+     || button->press_duration_seconds == MONITOR_CORE_RESET_PATIENT_ID_DURATION) {
+
+    /* The alarm is stopped and the collector is informed, if the alarm was turned on. */
+    LOG_INFO("Resetting the alarm.\n");
+    if(alarm_stop(&core->alarm)) {
+      alarm_history_record(&core->alarm_history, SENSOR_NONE, 0, ALARM_OFF);
+      core->transport->publish_alarm_state(ALARM_OFF);
+    }
+  }
+
+  if(button->press_duration_seconds != MONITOR_CORE_RESET_PATIENT_ID_DURATION) {
+    return false;
+  }
+
+  /* Delete the patient ID in the monitor and in the collector. */
+  LOG_INFO("Resetting the patient ID.\n");
+  memset(core->patient_id, 0, MONITOR_CORE_PATIENT_ID_LENGTH);
+  core->transport->publish_patient_id(core->patient_id);
+
+  /* Stop the sampling activity of the sensors. */
+  sensors_cmd_stop_sampling();
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+void
+monitor_core_handle_sample(struct monitor_core *core, process_event_t event, int sample)
+{
+  sensor_type sensor = sensors_cmd_sample_event_sensor(event);
+  int min_threshold;
+  int max_threshold;
+
+  if(sensor == SENSOR_NONE) {
+    LOG_ERR("Dropping a sample from an unhandled sensor process.\n");
+    return;
+  }
+
+  monitor_log_event(MONITOR_LOG_EVENT_SAMPLE, sensor, sample);
+  core->transport->publish_sample(sensor, sample);
+
+  /* The thresholds can be changed at runtime by the collector. */
+  min_threshold = monitor_config_min_threshold(sensor);
+  max_threshold = monitor_config_max_threshold(sensor);
+  if(alarming_sample(min_threshold, max_threshold, sample)) {
+    LOG_INFO("Alarming %s sample detected: %d. Min threshold: %d, max threshold: %d\n",
+             sensor_names[sensor], sample, min_threshold, max_threshold);
+    LOG_INFO("Starting the alarm.\n");
+
+    if(alarm_start(&core->alarm)) {
+      alarm_history_record(&core->alarm_history, sensor, sample, ALARM_ON);
+      core->transport->publish_alarm_state(ALARM_ON);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+bool
+monitor_core_start_alarm(struct monitor_core *core)
+{
+  LOG_INFO("Starting the alarm upon a command of the collector.\n");
+
+  if(alarm_start(&core->alarm)) {
+    alarm_history_record(&core->alarm_history, SENSOR_NONE, 0, ALARM_ON);
+    return true;
+  }
+  return false;
+}
+/*---------------------------------------------------------------------------*/
+void
+monitor_core_finish(struct monitor_core *core)
+{
+  sensors_cmd_stop_sampling();
+  sensors_cmd_stop_processes();
+  alarm_stop(&core->alarm);
+  ctimer_stop(&core->diagnostics_timer);
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -0,0 +1,166 @@
+/**
+ * \file
+ *         Header file for the transport-agnostic core of a vital signs monitor
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \defgroup monitor-core Transport-agnostic monitor core
+ * @{
+ *
+ * The monitor-core module implements the logic shared by all the vital signs monitors,
+ * independently of the protocol used to exchange data with the collector: network checks,
+ * management of the patient ID, processing of the samples, alarm detection and handling
+ * of the button. Whenever something must be sent to the collector, the core invokes the
+ * functions of a transport, i.e. a small table of callbacks provided by the monitor
+ * (e.g. publishing on an MQTT topic or updating an observable CoAP resource).
+ * The transport can be replaced at runtime, so that a monitor can switch to a different
+ * protocol (e.g. when the MQTT broker is unreachable) without losing its state.
+ */
+
+#ifndef SMART_ICU_MONITOR_CORE_H
+#define SMART_ICU_MONITOR_CORE_H
+
+#include <stdbool.h>
+#include "contiki.h"
+#include "os/sys/ctimer.h"
+#include "os/dev/button-hal.h"
+#include "./alarm.h"
+#include "./alarm-history.h"
+#include "./sensors-cmd.h"
+#include "./monitor-diagnostics.h"
+#include "./monitor-core-constants.h"
+
+/* Structure representing the operations that a transport offers to the monitor core. */
+struct monitor_transport {
+  /* Send a new sample of a sensor to the collector. */
+  void (*publish_sample)(sensor_type sensor, int sample);
+
+  /* Inform the collector about a change of the alarm state. */
+  void (*publish_alarm_state)(alarm_state state);
+
+  /* Inform the collector about the patient attached to the monitor (empty if reset). */
+  void (*publish_patient_id)(char *patient_id);
+  /* Send the diagnostics report of the last period to the collector. */
+  void (*publish_diagnostics)(const struct monitor_diagnostics *report);
+};
+
+/* Structure representing the transport-agnostic state of a monitor. */
+struct monitor_core {
+  const struct monitor_transport *transport;
+  struct process *process;
+  struct alarm_system alarm;
+  struct alarm_history alarm_history;
+
+  /* ID of the patient currently attached to the monitor. */
+  char patient_id[MONITOR_CORE_PATIENT_ID_LENGTH];
+  /* Timer pacing the diagnostics reports. */
+  struct ctimer diagnostics_timer;
+};
+
+/**
+ * \brief             Initialize the monitor core.
+ * \param core        A pointer to the monitor core.
+ * \param transport   A pointer to the transport used to communicate with the collector.
+ * \param process     The process that will receive the samples of the sensors.
+ *
+ *                    The function initializes the alarm system, the alarm history,
+ *                    the patient ID of the monitor, its time synchronization and
+ *                    its runtime configuration. It also starts the diagnostics, whose reports
+ *                    are sent through the transport every MONITOR_CORE_DIAGNOSTICS_INTERVAL minutes.
+ */
+void monitor_core_init(struct monitor_core *core, const struct monitor_transport *transport, struct process *process);
+
+/**
+ * \brief             Replace the transport used by the monitor core.
+ * \param core        A pointer to the monitor core.
+ * \param transport   A pointer to the new transport.
+ */
+void monitor_core_set_transport(struct monitor_core *core, const struct monitor_transport *transport);
+
+/**
+ * \brief    Check if the monitor is correctly connected to the network.
+ * \return   true if the monitor is correctly connected to the network,
+ *           false otherwise.
+ *
+ *           The function checks if the monitor is correctly connected
+ *           to the network, namely if it has a global address
+ *           and a default route, logging its addresses if so.
+ */
+bool monitor_core_network_ready(void);
+
+/**
+ * \brief          Start the sensor processes, without starting their sampling activity.
+ * \param core     A pointer to the monitor core.
+ * \return         true if a patient ID has been configured automatically,
+ *                 false if the monitor is waiting for a patient ID.
+ *
+ *                 The function must be called once the monitor is registered to the collector.
+ *                 It behaves as <code>monitor_core_wait_patient_id()</code> once the processes are started.
+ */
+bool monitor_core_start(struct monitor_core *core);
+
+/**
+ * \brief          Prepare the monitor to receive a new patient ID.
+ * \param core     A pointer to the monitor core.
+ * \return         true if a patient ID has been configured automatically,
+ *                 false if the monitor is waiting for a patient ID on the serial line.
+ *
+ *                 If AUTOMATIC_PATIENT_ID_CONFIGURATION is defined, a random
+ *                 patient ID is generated and set as with <code>monitor_core_set_patient_id()</code>.
+ */
+bool monitor_core_wait_patient_id(struct monitor_core *core);
+
+/**
+ * \brief              Set a new patient ID.
+ * \param core         A pointer to the monitor core.
+ * \param patient_id   The new patient ID.
+ *
+ *                     The function stores the new patient ID, informs the collector
+ *                     and starts the sampling activity of the sensors.
+ */
+void monitor_core_set_patient_id(struct monitor_core *core, char *patient_id);
+
+/**
+ * \brief          Handle the button press event.
+ * \param core     A pointer to the monitor core.
+ * \param button   The button that generated the event.
+ * \return         true if the patient ID has been reset, false otherwise.
+ *
+ *                 The function turns off the alarm system and resets the patient ID if the press
+ *                 duration exceeds a configured number of seconds. If the patient ID is reset,
+ *                 the sampling activity of the sensors is stopped and the caller should
+ *                 wait for a new patient ID.
+ */
+bool monitor_core_handle_button_press(struct monitor_core *core, button_hal_button_t *button);
+
+/**
+ * \brief          Handle the reception of a sample from a sensor process.
+ * \param core     A pointer to the monitor core.
+ * \param event    The event carrying the sample.
+ * \param sample   The sample.
+ *
+ *                 The function sends the sample to the collector. If the sample is an alarming one,
+ *                 it turns on the alarm system, records the transition and informs the collector.
+ */
+void monitor_core_handle_sample(struct monitor_core *core, process_event_t event, int sample);
+
+/**
+ * \brief          Turn on the alarm system upon a command of the collector.
+ * \param core     A pointer to the monitor core.
+ * \return         true if the alarm state was changed, false otherwise.
+ *
+ *                 The transition is recorded in the alarm history, but the collector
+ *                 is not informed, since it issued the command.
+ */
+bool monitor_core_start_alarm(struct monitor_core *core);
+
+/**
+ * \brief          Stop the processes simulating the sensors and the alarm system.
+ * \param core     A pointer to the monitor core.
+ */
+void monitor_core_finish(struct monitor_core *core);
+
+#endif /* SMART_ICU_MONITOR_CORE_H */
+/** @} */
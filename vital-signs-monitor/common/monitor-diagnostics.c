@@ -0,0 +1,97 @@
+/**
+ * \file
+ *         Implementation of the diagnostics of a monitor
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \addtogroup monitor-diagnostics
+ * @{
+ */
+
+#include <string.h>
+#include "contiki.h"
+#include "os/sys/energest.h"
+#include "./monitor-diagnostics.h"
+
+/* Energest counters at the start of the current period, as read by read_energest(). */
+#define ENERGEST_COUNTERS   5
+static uint64_t period_start[ENERGEST_COUNTERS];
+
+/* Counters of the transport in the current period. */
+static struct monitor_diagnostics counters;
+
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief          Read the Energest counters.
+ * \param values   The array where the total time, the CPU, LPM, radio TX and radio RX times are stored,
+ *                 in Energest ticks.
+ */
+static void
+read_energest(uint64_t *values)
+{
+  energest_flush();
+  values[0] = ENERGEST_GET_TOTAL_TIME();
+  values[1] = energest_type_time(ENERGEST_TYPE_CPU);
+  values[2] = energest_type_time(ENERGEST_TYPE_LPM) + energest_type_time(ENERGEST_TYPE_DEEP_LPM);
+  values[3] = energest_type_time(ENERGEST_TYPE_TRANSMIT);
+  values[4] = energest_type_time(ENERGEST_TYPE_LISTEN);
+}
+/*---------------------------------------------------------------------------*/
+/* Convert the difference between two Energest counters into milliseconds. */
+static uint32_t
+to_milliseconds(uint64_t end, uint64_t start)
+{
+  return (uint32_t)(((end - start) * 1000) / ENERGEST_SECOND);
+}
+/*---------------------------------------------------------------------------*/
+void
+monitor_diagnostics_init(void)
+{
+  memset(&counters, 0, sizeof(counters));
+  read_energest(period_start);
+}
+/*---------------------------------------------------------------------------*/
+void
+monitor_diagnostics_record_queue_length(uint16_t length)
+{
+  if(length > counters.queue_high_water_mark) {
+    counters.queue_high_water_mark = length;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+monitor_diagnostics_record_drop(void)
+{
+  counters.dropped_messages++;
+}
+/*---------------------------------------------------------------------------*/
+void
+monitor_diagnostics_record_failure(uint8_t status)
+{
+  /* The statuses unknown to the monitor are counted with the generic errors. */
+  if(status == 0 || status >= MONITOR_DIAGNOSTICS_STATUSES) {
+    status = MONITOR_DIAGNOSTICS_STATUS_OTHER;
+  }
+  counters.publish_failures[status]++;
+}
+/*---------------------------------------------------------------------------*/
+void
+monitor_diagnostics_collect(struct monitor_diagnostics *report)
+{
+  uint64_t now[ENERGEST_COUNTERS];
+
+  read_energest(now);
+  *report = counters;
+  report->period = to_milliseconds(now[0], period_start[0]);
+  report->cpu_time = to_milliseconds(now[1], period_start[1]);
+  report->lpm_time = to_milliseconds(now[2], period_start[2]);
+  report->radio_tx_time = to_milliseconds(now[3], period_start[3]);
+  report->radio_rx_time = to_milliseconds(now[4], period_start[4]);
+
+  memset(&counters, 0, sizeof(counters));
+  memcpy(period_start, now, sizeof(period_start));
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
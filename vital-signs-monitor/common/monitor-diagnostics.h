@@ -0,0 +1,75 @@
+/**
+ * \file
+ *         Header file for the diagnostics of a monitor
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \defgroup monitor-diagnostics Monitor diagnostics
+ * @{
+ *
+ * The monitor-diagnostics module accounts for the resources used by the monitor, so that
+ * the collector can tell its duty cycle and the effect of batching and coalescing on it.
+ * The time spent by the CPU in active and low power mode and by the radio in transmission
+ * and reception is measured by Energest, which must be enabled in project-conf.h. The
+ * transport records the longest its output queue grew, the messages it dropped and the
+ * publications refused by the network stack, grouped by status.<br>
+ * Every MONITOR_CORE_DIAGNOSTICS_INTERVAL minutes, the monitor core collects a report of the
+ * period elapsed since the previous one, and the transport sends it to the collector.
+ */
+
+#ifndef SMART_ICU_MONITOR_DIAGNOSTICS_H
+#define SMART_ICU_MONITOR_DIAGNOSTICS_H
+
+#include <stdint.h>
+
+/* Statuses of a refused publication, numbered as mqtt_status_t so that the MQTT monitor can record its own. */
+#define MONITOR_DIAGNOSTICS_STATUS_QUEUE_FULL      1 /* MQTT_STATUS_OUT_QUEUE_FULL, or no free CoAP transaction. */
+#define MONITOR_DIAGNOSTICS_STATUS_NOT_CONNECTED   2 /* MQTT_STATUS_NOT_CONNECTED_ERROR. */
+#define MONITOR_DIAGNOSTICS_STATUS_INVALID_ARGS    3 /* MQTT_STATUS_INVALID_ARGS_ERROR. */
+#define MONITOR_DIAGNOSTICS_STATUS_OTHER           4 /* MQTT_STATUS_DNS_ERROR, or any other error. */
+#define MONITOR_DIAGNOSTICS_STATUSES               5
+
+/* Structure representing the report of a period. The times are in milliseconds. */
+struct monitor_diagnostics {
+  uint32_t period;                                          /* Length of the period. */
+  uint32_t cpu_time;                                        /* Time spent by the CPU in active mode. */
+  uint32_t lpm_time;                                        /* Time spent by the CPU in (deep) low power mode. */
+  uint32_t radio_tx_time;                                   /* Time spent by the radio transmitting. */
+  uint32_t radio_rx_time;                                   /* Time spent by the radio listening or receiving. */
+  uint16_t queue_high_water_mark;                           /* Longest length reached by the output queue. */
+  uint32_t dropped_messages;                                /* Messages discarded without being sent. */
+  uint32_t publish_failures[MONITOR_DIAGNOSTICS_STATUSES];  /* Refused publications, indexed by status (0 is unused). */
+};
+
+/**
+ * \brief   Initialize the diagnostics, starting the first period.
+ */
+void monitor_diagnostics_init(void);
+
+/**
+ * \brief          Record the length of the output queue of the transport.
+ * \param length   The length of the queue, e.g. after an insertion.
+ */
+void monitor_diagnostics_record_queue_length(uint16_t length);
+
+/**
+ * \brief   Record a message discarded without being sent.
+ */
+void monitor_diagnostics_record_drop(void);
+
+/**
+ * \brief          Record a publication refused by the network stack.
+ * \param status   The status of the refusal, e.g. a mqtt_status_t other than MQTT_STATUS_OK.
+ */
+void monitor_diagnostics_record_failure(uint8_t status);
+
+/**
+ * \brief          Collect the report of the period elapsed since the previous one, and start a new period.
+ * \param report   A pointer to the structure where the report is stored.
+ */
+void monitor_diagnostics_collect(struct monitor_diagnostics *report);
+
+#endif /* SMART_ICU_MONITOR_DIAGNOSTICS_H */
+/** @} */
@@ -0,0 +1,92 @@
+/**
+ * \file
+ *         Implementation of the runtime log levels and the binary event log of a monitor
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \addtogroup monitor-log
+ * @{
+ */
+
+#include <string.h>
+#include "contiki.h"
+#include "os/sys/log.h"
+#include "./monitor-log.h"
+
+/* Structure representing an event recorded in the binary log. */
+struct monitor_log_record {
+  clock_time_t time;
+  int16_t args[2];
+  uint8_t event;
+};
+
+/* Names of the events, indexed by monitor_log_event_type. */
+static const char *event_names[MONITOR_LOG_EVENTS_NUMBER] = {
+  "sample", "publish", "queue-insert", "queue-drop", "queue-retry", "batch", "notification", "coalesced", "push"
+};
+
+uint8_t monitor_log_levels[MONITOR_LOG_MODULES_NUMBER] = {
+  MONITOR_LOG_DEFAULT_LEVEL, MONITOR_LOG_DEFAULT_LEVEL, MONITOR_LOG_DEFAULT_LEVEL, MONITOR_LOG_DEFAULT_LEVEL,
+  MONITOR_LOG_DEFAULT_LEVEL, MONITOR_LOG_DEFAULT_LEVEL, MONITOR_LOG_DEFAULT_LEVEL
+};
+
+static struct monitor_log_record ring[MONITOR_LOG_RING_SIZE];
+static uint16_t next_record;          /* Index of the slot of the next event. */
+static uint32_t recorded_events;      /* Events recorded since the boot, overwritten ones included. */
+
+/*---------------------------------------------------------------------------*/
+void
+monitor_log_set_level(uint8_t module, uint8_t level)
+{
+  if(module < MONITOR_LOG_MODULES_NUMBER && level <= LOG_LEVEL_DBG) {
+    monitor_log_levels[module] = level;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+monitor_log_event(monitor_log_event_type event, int16_t arg0, int16_t arg1)
+{
+  struct monitor_log_record *record = &ring[next_record];
+
+  record->time = clock_time();
+  record->args[0] = arg0;
+  record->args[1] = arg1;
+  record->event = event;
+
+  next_record = (next_record + 1) % MONITOR_LOG_RING_SIZE;
+  recorded_events++;
+}
+/*---------------------------------------------------------------------------*/
+void
+monitor_log_dump(void)
+{
+  uint16_t records = recorded_events < MONITOR_LOG_RING_SIZE ? recorded_events : MONITOR_LOG_RING_SIZE;
+  uint16_t index = (next_record + MONITOR_LOG_RING_SIZE - records) % MONITOR_LOG_RING_SIZE;
+  uint16_t i;
+
+  /* The log is printed even if the levels are lowered, since it is explicitly requested. */
+  LOG_OUTPUT("Event log: %lu events recorded, the last %u follow (time in ticks, %u per second).\n",
+             (unsigned long)recorded_events, records, (unsigned)CLOCK_SECOND);
+  for(i = 0; i < records; i++) {
+    LOG_OUTPUT("%lu %s %d %d\n",
+               (unsigned long)ring[index].time,
+               event_names[ring[index].event],
+               ring[index].args[0],
+               ring[index].args[1]);
+    index = (index + 1) % MONITOR_LOG_RING_SIZE;
+  }
+}
+/*---------------------------------------------------------------------------*/
+bool
+monitor_log_handle_serial_line(const char *line)
+{
+  if(strcmp(line, MONITOR_LOG_DUMP_COMMAND) != 0) {
+    return false;
+  }
+  monitor_log_dump();
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
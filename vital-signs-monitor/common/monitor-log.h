@@ -0,0 +1,109 @@
+/**
+ * \file
+ *         Header file for the runtime log levels and the binary event log of a monitor
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \defgroup monitor-log Runtime log levels and binary event log
+ * @{
+ *
+ * The monitor-log module cuts the cost of logging on the serial line in two ways.<br>
+ * The log level of each module of the monitor can be lowered at runtime, so that the
+ * debug lines compiled in are printed only when the collector asks for them (see the
+ * <code>lvl&lt;i&gt;</code> key of monitor-config). The level set in project-conf.h is the
+ * highest one compiled in, and is wrapped in MONITOR_LOG_LEVEL() to be checked against the
+ * runtime level of the module before formatting each line.<br>
+ * The events of the hot paths (samples, publications, queue operations, notifications) are
+ * not formatted at all: they are recorded in a ring of fixed-size binary records (event ID,
+ * two arguments and timestamp), which is printed on demand by sending
+ * MONITOR_LOG_DUMP_COMMAND on the serial line.
+ *
+ * This header is included by project-conf.h, so it must not depend on any other header.
+ */
+
+#ifndef SMART_ICU_MONITOR_LOG_H
+#define SMART_ICU_MONITOR_LOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Modules of the monitor whose log level can be changed at runtime. */
+#define MONITOR_LOG_SENSORS              0    /* The sensor processes. */
+#define MONITOR_LOG_ALARM_SYSTEM         1    /* The alarm system. */
+#define MONITOR_LOG_MONITOR_CORE         2    /* The transport-agnostic core. */
+#define MONITOR_LOG_TIME_SYNC            3    /* The clock synchronization. */
+#define MONITOR_LOG_MONITOR_CONFIG       4    /* The runtime configuration. */
+#define MONITOR_LOG_TRANSPORT            5    /* The MQTT or CoAP monitor and its utilities. */
+#define MONITOR_LOG_COAP_RESOURCES       6    /* The CoAP resources. */
+#define MONITOR_LOG_MODULES_NUMBER       7
+
+#ifndef MONITOR_LOG_DEFAULT_LEVEL
+#define MONITOR_LOG_DEFAULT_LEVEL        3    /* LOG_LEVEL_INFO: the debug lines are off until requested. */
+#endif
+
+#ifndef MONITOR_LOG_RING_SIZE
+#define MONITOR_LOG_RING_SIZE            32   /* Number of events kept in the binary log. */
+#endif
+
+#define MONITOR_LOG_DUMP_COMMAND         "log" /* Serial line command printing the binary log. */
+
+/**
+ * \brief          The log level of a module: the lowest between the one compiled in and the runtime one.
+ * \param module   The module, e.g. MONITOR_LOG_SENSORS.
+ * \param level    The highest log level compiled in for the module.
+ */
+#define MONITOR_LOG_LEVEL(module, level) \
+  ((level) < monitor_log_levels[module] ? (level) : monitor_log_levels[module])
+
+/* Events recorded in the binary log, with the meaning of their arguments. */
+typedef enum {
+  MONITOR_LOG_EVENT_SAMPLE,              /* A new sample: sensor, value. */
+  MONITOR_LOG_EVENT_PUBLISH,             /* A message handed to the MQTT engine: status, length. */
+  MONITOR_LOG_EVENT_QUEUE_INSERT,        /* A message enqueued for a retry: queue length. */
+  MONITOR_LOG_EVENT_QUEUE_DROP,          /* A message discarded because the queue is full: queue length. */
+  MONITOR_LOG_EVENT_QUEUE_RETRY,         /* A retry of the head of the queue: queue length. */
+  MONITOR_LOG_EVENT_BATCH,               /* A batch of samples published: samples, length. */
+  MONITOR_LOG_EVENT_NOTIFICATION,        /* A CoAP notification: type (0 CON, 1 NON). */
+  MONITOR_LOG_EVENT_COALESCED,           /* An update coalesced in a pending notification. */
+  MONITOR_LOG_EVENT_PUSH,                /* A batch of samples pushed to the collector: samples, length. */
+  MONITOR_LOG_EVENTS_NUMBER
+} monitor_log_event_type;
+
+/* Runtime log level of each module, indexed by the MONITOR_LOG_* module IDs. */
+extern uint8_t monitor_log_levels[MONITOR_LOG_MODULES_NUMBER];
+
+/**
+ * \brief          Set the runtime log level of a module.
+ * \param module   The module.
+ * \param level    The log level, from LOG_LEVEL_NONE to LOG_LEVEL_DBG. The lines above
+ *                 the level compiled in for the module stay off anyway.
+ */
+void monitor_log_set_level(uint8_t module, uint8_t level);
+
+/**
+ * \brief          Record an event in the binary log, overwriting the oldest one if the log is full.
+ * \param event    The event.
+ * \param arg0     The first argument of the event.
+ * \param arg1     The second argument of the event.
+ *
+ *                 Recording an event costs a few stores, against the formatting and the
+ *                 transmission on the serial line of a log line.
+ */
+void monitor_log_event(monitor_log_event_type event, int16_t arg0, int16_t arg1);
+
+/**
+ * \brief          Print the binary log on the serial line, from the oldest event to the newest one.
+ */
+void monitor_log_dump(void);
+
+/**
+ * \brief          Handle a line received from the serial line.
+ * \param line     The line.
+ * \return         true if the line was MONITOR_LOG_DUMP_COMMAND, and the log has been printed.
+ */
+bool monitor_log_handle_serial_line(const char *line);
+
+#endif /* SMART_ICU_MONITOR_LOG_H */
+/** @} */
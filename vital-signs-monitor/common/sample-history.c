@@ -0,0 +1,80 @@
+/**
+ * \file
+ *         Implementation of the sample history
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \addtogroup sample-history
+ * @{
+ */
+
+#include "contiki.h"
+#include "os/sys/clock.h"
+#include "./sample-history.h"
+
+/*---------------------------------------------------------------------------*/
+void
+sample_history_init(struct sample_history *history)
+{
+  int sensor;
+
+  for(sensor = 0; sensor < SENSORS_NUMBER; sensor++) {
+    history->next_index[sensor] = 0;
+    history->length[sensor] = 0;
+    history->next_sensor_seq[sensor] = 0;
+  }
+  history->next_seq = 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+sample_history_record(struct sample_history *history, sensor_type sensor, int value)
+{
+  struct sample_record *record = &history->records[sensor][history->next_index[sensor]];
+
+  record->seq = history->next_seq;
+  record->tick = clock_time();
+  record->value = value;
+
+  history->next_seq = history->next_seq + 1;
+  history->next_sensor_seq[sensor] = history->next_sensor_seq[sensor] + 1;
+  history->next_index[sensor] = (history->next_index[sensor] + 1) % SAMPLE_HISTORY_SIZE;
+  if(history->length[sensor] < SAMPLE_HISTORY_SIZE) {
+    history->length[sensor] = history->length[sensor] + 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+sample_history_oldest_seq(struct sample_history *history)
+{
+  const struct sample_record *oldest;
+  uint32_t oldest_seq = history->next_seq;
+  int sensor;
+
+  for(sensor = 0; sensor < SENSORS_NUMBER; sensor++) {
+    oldest = sample_history_get(history, sensor, 0);
+    if(oldest != NULL && oldest->seq < oldest_seq) {
+      oldest_seq = oldest->seq;
+    }
+  }
+  return oldest_seq;
+}
+/*---------------------------------------------------------------------------*/
+const struct sample_record *
+sample_history_get(struct sample_history *history, sensor_type sensor, uint8_t index)
+{
+  if(index >= history->length[sensor]) {
+    return NULL;
+  }
+  return &history->records[sensor][(history->next_index[sensor] + SAMPLE_HISTORY_SIZE - history->length[sensor] + index)
+                                   % SAMPLE_HISTORY_SIZE];
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+sample_history_sensor_seq(struct sample_history *history, sensor_type sensor, uint8_t index)
+{
+  return history->next_sensor_seq[sensor] - history->length[sensor] + index;
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -0,0 +1,98 @@
+/**
+ * \file
+ *         Header file for the sample history
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \defgroup sample-history Sample history
+ * @{
+ *
+ * The sample-history module keeps the last SAMPLE_HISTORY_SIZE samples of each sensor
+ * of a monitor, in a fixed-size ring buffer per sensor. Each sample is identified by a
+ * sequence number shared by all the sensors, so that a collector that was unreachable
+ * for a while can retrieve all the samples it missed with a single request, starting
+ * from the first sequence number it did not receive. Each sample is also numbered per
+ * sensor, so that the losses of each sensor can be told apart, and carries the clock
+ * tick at which it was captured, so that its latency can be traced up to the collector.
+ * When the ring of a sensor is full, its oldest sample is overwritten.
+ */
+
+#ifndef SMART_ICU_SAMPLE_HISTORY_H
+#define SMART_ICU_SAMPLE_HISTORY_H
+
+#include <stdint.h>
+#include "contiki.h"
+#include "./sensors-cmd.h"
+#include "./sensors/utils/sensor-constants.h"
+
+/* Structure representing a sample stored in the history. */
+struct sample_record {
+  uint32_t seq;
+  clock_time_t tick;          /* Clock tick at which the sample was captured. */
+  int value;
+};
+
+/* Structure representing the history of the samples, organized as a circular buffer per sensor. */
+struct sample_history {
+  struct sample_record records[SENSORS_NUMBER][SAMPLE_HISTORY_SIZE];
+  uint8_t next_index[SENSORS_NUMBER];
+  uint8_t length[SENSORS_NUMBER];
+  uint32_t next_sensor_seq[SENSORS_NUMBER];
+  uint32_t next_seq;
+};
+
+/**
+ * \brief           Initialize the sample history.
+ * \param history   A pointer to the sample history.
+ *
+ *                  The function empties the sample history and restarts
+ *                  the sequence numbers, including the ones of each sensor, from 0.
+ */
+void sample_history_init(struct sample_history *history);
+
+/**
+ * \brief           Record a new sample.
+ * \param history   A pointer to the sample history.
+ * \param sensor    The sensor that produced the sample.
+ * \param value     The sample.
+ *
+ *                  The function records the sample, timestamped with the current clock tick,
+ *                  assigning to it the next sequence number. If the ring of the sensor
+ *                  is full, its oldest sample is overwritten.
+ */
+void sample_history_record(struct sample_history *history, sensor_type sensor, int value);
+
+/**
+ * \brief           Get the sequence number of the oldest sample stored in the history.
+ * \param history   A pointer to the sample history.
+ * \return          The sequence number of the oldest stored sample. If the history is empty,
+ *                  the returned value is equal to <code>next_seq</code>.
+ */
+uint32_t sample_history_oldest_seq(struct sample_history *history);
+
+/**
+ * \brief           Get a sample of a sensor stored in the history.
+ * \param history   A pointer to the sample history.
+ * \param sensor    The sensor.
+ * \param index     The position of the sample, from 0 (the oldest stored sample of the sensor)
+ *                  to <code>length[sensor] - 1</code> (the newest one).
+ * \return          A pointer to the sample, or NULL if the index is out of range.
+ */
+const struct sample_record *sample_history_get(struct sample_history *history, sensor_type sensor, uint8_t index);
+
+/**
+ * \brief           Get the sequence number of a sample among the ones of its sensor.
+ * \param history   A pointer to the sample history.
+ * \param sensor    The sensor.
+ * \param index     The position of the sample, as in <code>sample_history_get()</code>.
+ * \return          The number of samples produced by the sensor before the given one.
+ *
+ *                  The samples of a sensor are stored in sequence, so their per-sensor
+ *                  sequence numbers are not stored but derived from their position.
+ */
+uint32_t sample_history_sensor_seq(struct sample_history *history, sensor_type sensor, uint8_t index);
+
+#endif /* SMART_ICU_SAMPLE_HISTORY_H */
+/** @} */
@@ -18,6 +18,29 @@
 #include "./sensors/oxygen-saturation.h"
 #include "./sensors-cmd.h"
 
+/* Processes simulating the sensors and events controlling their sampling, indexed by sensor_type. */
+static struct process *const sensor_processes[SENSORS_NUMBER] = {
+  &heart_rate_sensor_process,
+  &blood_pressure_sensor_process,
+  &temperature_sensor_process,
+  &respiration_sensor_process,
+  &oxygen_saturation_sensor_process,
+};
+static process_event_t *const start_sampling_events[SENSORS_NUMBER] = {
+  &HEART_RATE_START_SAMPLING_EVENT,
+  &BLOOD_PRESSURE_START_SAMPLING_EVENT,
+  &TEMPERATURE_START_SAMPLING_EVENT,
+  &RESPIRATION_START_SAMPLING_EVENT,
+  &OXYGEN_SATURATION_START_SAMPLING_EVENT,
+};
+static process_event_t *const stop_sampling_events[SENSORS_NUMBER] = {
+  &HEART_RATE_STOP_SAMPLING_EVENT,
+  &BLOOD_PRESSURE_STOP_SAMPLING_EVENT,
+  &TEMPERATURE_STOP_SAMPLING_EVENT,
+  &RESPIRATION_STOP_SAMPLING_EVENT,
+  &OXYGEN_SATURATION_STOP_SAMPLING_EVENT,
+};
+
 /*---------------------------------------------------------------------------*/
 bool
 sensors_cmd_heart_rate_sample_event(process_event_t event)
@@ -77,6 +100,27 @@ sensors_cmd_sample_event(process_event_t event)
   return false;
 }
 /*---------------------------------------------------------------------------*/
+sensor_type
+sensors_cmd_sample_event_sensor(process_event_t event)
+{
+  if(sensors_cmd_heart_rate_sample_event(event)) {
+    return SENSOR_HEART_RATE;
+  }
+  if(sensors_cmd_blood_pressure_sample_event(event)) {
+    return SENSOR_BLOOD_PRESSURE;
+  }
+  if(sensors_cmd_temperature_sample_event(event)) {
+    return SENSOR_TEMPERATURE;
+  }
+  if(sensors_cmd_respiration_sample_event(event)) {
+    return SENSOR_RESPIRATION;
+  }
+  if(sensors_cmd_oxygen_saturation_sample_event(event)) {
+    return SENSOR_OXYGEN_SATURATION;
+  }
+  return SENSOR_NONE;
+}
+/*---------------------------------------------------------------------------*/
 void
 sensors_cmd_start_processes(void)
 {
@@ -90,21 +134,33 @@ sensors_cmd_start_processes(void)
 void
 sensors_cmd_start_sampling(process_data_t subscribing_process)
 {
-  process_post(&heart_rate_sensor_process, HEART_RATE_START_SAMPLING_EVENT, subscribing_process);
-  process_post(&blood_pressure_sensor_process, BLOOD_PRESSURE_START_SAMPLING_EVENT, subscribing_process);
-  process_post(&temperature_sensor_process, TEMPERATURE_START_SAMPLING_EVENT, subscribing_process);
-  process_post(&respiration_sensor_process, RESPIRATION_START_SAMPLING_EVENT, subscribing_process);
-  process_post(&oxygen_saturation_sensor_process, OXYGEN_SATURATION_START_SAMPLING_EVENT, subscribing_process);
+  int sensor;
+
+  for(sensor = 0; sensor < SENSORS_NUMBER; sensor++) {
+    sensors_cmd_start_sensor_sampling(sensor, subscribing_process);
+  }
 }
 /*---------------------------------------------------------------------------*/
 void
 sensors_cmd_stop_sampling(void)
 {
-  process_post(&heart_rate_sensor_process, HEART_RATE_STOP_SAMPLING_EVENT, NULL);
-  process_post(&blood_pressure_sensor_process, BLOOD_PRESSURE_STOP_SAMPLING_EVENT, NULL);
-  process_post(&temperature_sensor_process, TEMPERATURE_STOP_SAMPLING_EVENT, NULL);
-  process_post(&respiration_sensor_process, RESPIRATION_STOP_SAMPLING_EVENT, NULL);
-  process_post(&oxygen_saturation_sensor_process, OXYGEN_SATURATION_STOP_SAMPLING_EVENT, NULL);
+  int sensor;
+
+  for(sensor = 0; sensor < SENSORS_NUMBER; sensor++) {
+    sensors_cmd_stop_sensor_sampling(sensor);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+sensors_cmd_start_sensor_sampling(sensor_type sensor, process_data_t subscribing_process)
+{
+  process_post(sensor_processes[sensor], *start_sampling_events[sensor], subscribing_process);
+}
+/*---------------------------------------------------------------------------*/
+void
+sensors_cmd_stop_sensor_sampling(sensor_type sensor)
+{
+  process_post(sensor_processes[sensor], *stop_sampling_events[sensor], NULL);
 }
 /*---------------------------------------------------------------------------*/
 void
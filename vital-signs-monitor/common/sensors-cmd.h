@@ -10,7 +10,8 @@
  * @{
  *
  * The sensors-cmd module provides a set of utility functions to manage the sensor processes.
- * The functions allow to start/stop the processes and to start/stop their sampling activity;
+ * The functions allow to start/stop the processes and to start/stop their sampling activity,
+ * either for all the sensors or for a single one;
  * moreover, they allow to check if a sample event is coming from a certain type of sensor.
  */
 
@@ -20,6 +21,22 @@
 #include "contiki.h"
 #include <stdbool.h>
 
+/*
+ * Enumerator identifying the sensors of a monitor. The order of the sensors
+ * matches the one of the SensorType enumerator used by the collector, so that
+ * a sensor can be transmitted as its index. SENSOR_NONE is used when an
+ * information is not related to any sensor (e.g. an alarm reset by the button).
+ */
+typedef enum {
+  SENSOR_NONE = -1,
+  SENSOR_HEART_RATE,
+  SENSOR_BLOOD_PRESSURE,
+  SENSOR_TEMPERATURE,
+  SENSOR_RESPIRATION,
+  SENSOR_OXYGEN_SATURATION,
+  SENSORS_NUMBER
+} sensor_type;
+
 /**
  * \brief         Check if an event is a notification of a new sample
  *                sent by the heart rate sensor process.
@@ -74,6 +91,14 @@ bool sensors_cmd_temperature_sample_event(process_event_t event);
  */
 bool sensors_cmd_sample_event(process_event_t event);
 
+/**
+ * \brief         Get the sensor that generated a sample event.
+ * \param event   The event to be checked.
+ * \return        The sensor that generated the event, or SENSOR_NONE
+ *                if the event is not a notification of a new sample.
+ */
+sensor_type sensors_cmd_sample_event_sensor(process_event_t event);
+
 /**
  * \brief   Start the processes simulating the sensors.
  */
@@ -91,6 +116,24 @@ void sensors_cmd_start_sampling(process_data_t subscribing_process);
  */
 void sensors_cmd_stop_sampling(void);
 
+/**
+ * \brief                       Start the sampling activity of the process simulating a sensor.
+ * \param sensor                The sensor.
+ * \param subscribing_process   The process that will receive notifications about
+ *                              the availability of new samples.
+ *
+ *                              The function has no effect if the sensor is already sampling.
+ */
+void sensors_cmd_start_sensor_sampling(sensor_type sensor, process_data_t subscribing_process);
+
+/**
+ * \brief          Stop the sampling activity of the process simulating a sensor.
+ * \param sensor   The sensor.
+ *
+ *                 The function has no effect if the sensor is not sampling.
+ */
+void sensors_cmd_stop_sensor_sampling(sensor_type sensor);
+
 /**
  * \brief   Stop the processes simulating the sensors.
  */
@@ -16,6 +16,7 @@
 #include "sys/log.h"
 #include "./sensor.h"
 #include "./utils/sensor-constants.h"
+#include "../monitor-config.h"
 
 #define LOG_MODULE "Blood pressure sensor"
 #define LOG_LEVEL LOG_LEVEL_BLOOD_PRESSURE_SENSOR
@@ -35,7 +36,7 @@ PROCESS(blood_pressure_sensor_process, "Blood pressure sensor process");
 
 PROCESS_THREAD(blood_pressure_sensor_process, event, data)
 {
-  static struct sensor blood_pressure_sensor = {.sampling_interval = BLOOD_PRESSURE_SAMPLING_INTERVAL*CLOCK_SECOND};
+  static struct sensor blood_pressure_sensor;
   PROCESS_BEGIN();
 
   LOG_INFO("Process started.\n");
@@ -46,8 +47,9 @@ PROCESS_THREAD(blood_pressure_sensor_process, event, data)
   while(true) {
     PROCESS_WAIT_EVENT_UNTIL(event == BLOOD_PRESSURE_START_SAMPLING_EVENT);
     blood_pressure_sensor.subscriber = (struct process *)data;
-    LOG_INFO("Starting sampling with interval %d s. Subscribed process: %s.\n",
-             BLOOD_PRESSURE_SAMPLING_INTERVAL,
+    blood_pressure_sensor.sampling_interval = monitor_config_sampling_interval(SENSOR_BLOOD_PRESSURE)*CLOCK_SECOND;
+    LOG_INFO("Starting sampling with interval %u s. Subscribed process: %s.\n",
+             monitor_config_sampling_interval(SENSOR_BLOOD_PRESSURE),
              blood_pressure_sensor.subscriber->name);
 
     /* Initialize the blood pressure value. */
@@ -62,10 +64,13 @@ PROCESS_THREAD(blood_pressure_sensor_process, event, data)
                                                                    BLOOD_PRESSURE_DEVIATION,
                                                                    BLOOD_PRESSURE_LOWER_BOUND,
                                                                    BLOOD_PRESSURE_UPPER_BOUND);
-        LOG_INFO("New sample: %d %s.\n", blood_pressure_sensor.last_sample, BLOOD_PRESSURE_UNIT);
+        LOG_DBG("New sample: %d %s.\n", blood_pressure_sensor.last_sample, BLOOD_PRESSURE_UNIT);
         process_post(blood_pressure_sensor.subscriber, BLOOD_PRESSURE_SAMPLE_EVENT,
                      &blood_pressure_sensor.last_sample);
-        etimer_reset(&blood_pressure_sensor.sampling_timer);
+
+        /* The sampling interval can be changed at runtime by the collector. */
+        blood_pressure_sensor.sampling_interval = monitor_config_sampling_interval(SENSOR_BLOOD_PRESSURE)*CLOCK_SECOND;
+        etimer_reset_with_new_interval(&blood_pressure_sensor.sampling_timer, blood_pressure_sensor.sampling_interval);
         continue;
       }
 
@@ -16,6 +16,7 @@
 #include "sys/log.h"
 #include "./sensor.h"
 #include "./utils/sensor-constants.h"
+#include "../monitor-config.h"
 
 #define LOG_MODULE "Heart rate sensor"
 #define LOG_LEVEL LOG_LEVEL_HEART_RATE_SENSOR
@@ -35,7 +36,7 @@ PROCESS(heart_rate_sensor_process, "Heart rate sensor process");
 
 PROCESS_THREAD(heart_rate_sensor_process, event, data)
 {
-  static struct sensor heart_rate_sensor = {.sampling_interval = HEART_RATE_SAMPLING_INTERVAL*CLOCK_SECOND};
+  static struct sensor heart_rate_sensor;
   PROCESS_BEGIN();
 
   LOG_INFO("Process started.\n");
@@ -46,8 +47,9 @@ PROCESS_THREAD(heart_rate_sensor_process, event, data)
   while(true) {
     PROCESS_WAIT_EVENT_UNTIL(event == HEART_RATE_START_SAMPLING_EVENT);
     heart_rate_sensor.subscriber = (struct process *)data;
-    LOG_INFO("Starting sampling with interval %d s. Subscribed process: %s.\n",
-             HEART_RATE_SAMPLING_INTERVAL,
+    heart_rate_sensor.sampling_interval = monitor_config_sampling_interval(SENSOR_HEART_RATE)*CLOCK_SECOND;
+    LOG_INFO("Starting sampling with interval %u s. Subscribed process: %s.\n",
+             monitor_config_sampling_interval(SENSOR_HEART_RATE),
              heart_rate_sensor.subscriber->name);
 
     /* Initialize the heart rate value. */
@@ -62,9 +64,12 @@ PROCESS_THREAD(heart_rate_sensor_process, event, data)
                                                                HEART_RATE_DEVIATION,
                                                                HEART_RATE_LOWER_BOUND,
                                                                HEART_RATE_UPPER_BOUND);
-        LOG_INFO("New sample: %d %s.\n", heart_rate_sensor.last_sample, HEART_RATE_UNIT);
+        LOG_DBG("New sample: %d %s.\n", heart_rate_sensor.last_sample, HEART_RATE_UNIT);
         process_post(heart_rate_sensor.subscriber, HEART_RATE_SAMPLE_EVENT, &heart_rate_sensor.last_sample);
-        etimer_reset(&heart_rate_sensor.sampling_timer);
+
+        /* The sampling interval can be changed at runtime by the collector. */
+        heart_rate_sensor.sampling_interval = monitor_config_sampling_interval(SENSOR_HEART_RATE)*CLOCK_SECOND;
+        etimer_reset_with_new_interval(&heart_rate_sensor.sampling_timer, heart_rate_sensor.sampling_interval);
         continue;
       }
 
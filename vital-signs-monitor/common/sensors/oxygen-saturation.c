@@ -16,6 +16,7 @@
 #include "sys/log.h"
 #include "./sensor.h"
 #include "./utils/sensor-constants.h"
+#include "../monitor-config.h"
 
 #define LOG_MODULE "Oxygen saturation sensor"
 #define LOG_LEVEL LOG_LEVEL_OXYGEN_SATURATION_SENSOR
@@ -35,7 +36,7 @@ PROCESS(oxygen_saturation_sensor_process, "Oxygen saturation sensor process");
 
 PROCESS_THREAD(oxygen_saturation_sensor_process, event, data)
 {
-  static struct sensor oxygen_saturation_sensor = {.sampling_interval = OXYGEN_SATURATION_SAMPLING_INTERVAL*CLOCK_SECOND};
+  static struct sensor oxygen_saturation_sensor;
   PROCESS_BEGIN();
 
   LOG_INFO("Process started.\n");
@@ -46,8 +47,9 @@ PROCESS_THREAD(oxygen_saturation_sensor_process, event, data)
   while(true) {
     PROCESS_WAIT_EVENT_UNTIL(event == OXYGEN_SATURATION_START_SAMPLING_EVENT);
     oxygen_saturation_sensor.subscriber = (struct process *)data;
-    LOG_INFO("Starting sampling with interval %d s. Subscribed process: %s.\n",
-             OXYGEN_SATURATION_SAMPLING_INTERVAL,
+    oxygen_saturation_sensor.sampling_interval = monitor_config_sampling_interval(SENSOR_OXYGEN_SATURATION)*CLOCK_SECOND;
+    LOG_INFO("Starting sampling with interval %u s. Subscribed process: %s.\n",
+             monitor_config_sampling_interval(SENSOR_OXYGEN_SATURATION),
              oxygen_saturation_sensor.subscriber->name);
 
     /* Initialize the oxygen saturation value. */
@@ -62,10 +64,13 @@ PROCESS_THREAD(oxygen_saturation_sensor_process, event, data)
                                                                       OXYGEN_SATURATION_DEVIATION,
                                                                       OXYGEN_SATURATION_LOWER_BOUND,
                                                                       OXYGEN_SATURATION_UPPER_BOUND);
-        LOG_INFO("New sample: %d %s.\n", oxygen_saturation_sensor.last_sample, OXYGEN_SATURATION_UNIT);
+        LOG_DBG("New sample: %d %s.\n", oxygen_saturation_sensor.last_sample, OXYGEN_SATURATION_UNIT);
         process_post(oxygen_saturation_sensor.subscriber, OXYGEN_SATURATION_SAMPLE_EVENT,
                      &oxygen_saturation_sensor.last_sample);
-        etimer_reset(&oxygen_saturation_sensor.sampling_timer);
+
+        /* The sampling interval can be changed at runtime by the collector. */
+        oxygen_saturation_sensor.sampling_interval = monitor_config_sampling_interval(SENSOR_OXYGEN_SATURATION)*CLOCK_SECOND;
+        etimer_reset_with_new_interval(&oxygen_saturation_sensor.sampling_timer, oxygen_saturation_sensor.sampling_interval);
         continue;
       }
 
@@ -16,6 +16,7 @@
 #include "sys/log.h"
 #include "./sensor.h"
 #include "./utils/sensor-constants.h"
+#include "../monitor-config.h"
 
 #define LOG_MODULE "Respiration sensor"
 #define LOG_LEVEL LOG_LEVEL_RESPIRATION_SENSOR
@@ -35,7 +36,7 @@ PROCESS(respiration_sensor_process, "Respiration sensor process");
 
 PROCESS_THREAD(respiration_sensor_process, event, data)
 {
-  static struct sensor respiration_sensor = {.sampling_interval = RESPIRATION_SAMPLING_INTERVAL*CLOCK_SECOND};
+  static struct sensor respiration_sensor;
   PROCESS_BEGIN();
 
   LOG_INFO("Process started.\n");
@@ -46,8 +47,9 @@ PROCESS_THREAD(respiration_sensor_process, event, data)
   while(true) {
     PROCESS_WAIT_EVENT_UNTIL(event == RESPIRATION_START_SAMPLING_EVENT);
     respiration_sensor.subscriber = (struct process *)data;
-    LOG_INFO("Starting sampling with interval %d s. Subscribed process: %s.\n",
-             RESPIRATION_SAMPLING_INTERVAL,
+    respiration_sensor.sampling_interval = monitor_config_sampling_interval(SENSOR_RESPIRATION)*CLOCK_SECOND;
+    LOG_INFO("Starting sampling with interval %u s. Subscribed process: %s.\n",
+             monitor_config_sampling_interval(SENSOR_RESPIRATION),
              respiration_sensor.subscriber->name);
 
     /* Initialize the respiration value. */
@@ -62,9 +64,12 @@ PROCESS_THREAD(respiration_sensor_process, event, data)
                                                                 RESPIRATION_DEVIATION,
                                                                 RESPIRATION_LOWER_BOUND,
                                                                 RESPIRATION_UPPER_BOUND);
-        LOG_INFO("New sample: %d %s.\n", respiration_sensor.last_sample, RESPIRATION_UNIT);
+        LOG_DBG("New sample: %d %s.\n", respiration_sensor.last_sample, RESPIRATION_UNIT);
         process_post(respiration_sensor.subscriber, RESPIRATION_SAMPLE_EVENT, &respiration_sensor.last_sample);
-        etimer_reset(&respiration_sensor.sampling_timer);
+
+        /* The sampling interval can be changed at runtime by the collector. */
+        respiration_sensor.sampling_interval = monitor_config_sampling_interval(SENSOR_RESPIRATION)*CLOCK_SECOND;
+        etimer_reset_with_new_interval(&respiration_sensor.sampling_timer, respiration_sensor.sampling_interval);
         continue;
       }
 
@@ -16,6 +16,7 @@
 #include "sys/log.h"
 #include "./sensor.h"
 #include "./utils/sensor-constants.h"
+#include "../monitor-config.h"
 
 #define LOG_MODULE "Temperature sensor"
 #define LOG_LEVEL LOG_LEVEL_TEMPERATURE_SENSOR
@@ -35,7 +36,7 @@ PROCESS(temperature_sensor_process, "Temperature sensor process");
 
 PROCESS_THREAD(temperature_sensor_process, event, data)
 {
-  static struct sensor temperature_sensor = {.sampling_interval = TEMPERATURE_SAMPLING_INTERVAL*CLOCK_SECOND};
+  static struct sensor temperature_sensor;
   PROCESS_BEGIN();
 
   LOG_INFO("Process started.\n");
@@ -46,8 +47,9 @@ PROCESS_THREAD(temperature_sensor_process, event, data)
   while(true) {
     PROCESS_WAIT_EVENT_UNTIL(event == TEMPERATURE_START_SAMPLING_EVENT);
     temperature_sensor.subscriber = (struct process *)data;
-    LOG_INFO("Starting sampling with interval %d s. Subscribed process: %s.\n",
-             TEMPERATURE_SAMPLING_INTERVAL,
+    temperature_sensor.sampling_interval = monitor_config_sampling_interval(SENSOR_TEMPERATURE)*CLOCK_SECOND;
+    LOG_INFO("Starting sampling with interval %u s. Subscribed process: %s.\n",
+             monitor_config_sampling_interval(SENSOR_TEMPERATURE),
              temperature_sensor.subscriber->name);
 
     /* Initialize the temperature value. */
@@ -62,9 +64,12 @@ PROCESS_THREAD(temperature_sensor_process, event, data)
                                                                 TEMPERATURE_DEVIATION,
                                                                 TEMPERATURE_LOWER_BOUND,
                                                                 TEMPERATURE_UPPER_BOUND);
-        LOG_INFO("New sample: %d %s.\n", temperature_sensor.last_sample, TEMPERATURE_UNIT);
+        LOG_DBG("New sample: %d %s.\n", temperature_sensor.last_sample, TEMPERATURE_UNIT);
         process_post(temperature_sensor.subscriber, TEMPERATURE_SAMPLE_EVENT, &temperature_sensor.last_sample);
-        etimer_reset(&temperature_sensor.sampling_timer);
+
+        /* The sampling interval can be changed at runtime by the collector. */
+        temperature_sensor.sampling_interval = monitor_config_sampling_interval(SENSOR_TEMPERATURE)*CLOCK_SECOND;
+        etimer_reset_with_new_interval(&temperature_sensor.sampling_timer, temperature_sensor.sampling_interval);
         continue;
       }
 
@@ -10,7 +10,7 @@
  * @{
  *
  * Constants used by the processes simulating the heart rate, blood pressure, temperature
- * respiration and oxygen saturation sensors.
+ * respiration and oxygen saturation sensors, and the size of the history of their samples.
  */
 
 #ifndef SMART_ICU_SENSOR_CONSTANTS_H
@@ -51,5 +51,10 @@
 #define OXYGEN_SATURATION_DEVIATION           5
 #define OXYGEN_SATURATION_UNIT                "%"
 
+/* Sample history constants (the size can be overridden in the project configuration). */
+#ifndef SAMPLE_HISTORY_SIZE
+#define SAMPLE_HISTORY_SIZE                   8 /* Number of samples of each sensor kept in the sample history. */
+#endif
+
 #endif /* SMART_ICU_SENSOR_CONSTANTS_H */
 /** @} */
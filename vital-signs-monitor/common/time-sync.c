@@ -0,0 +1,113 @@
+/**
+ * \file
+ *         Implementation of the time synchronization with the collector
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \addtogroup time-sync
+ * @{
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "contiki.h"
+#include "os/sys/log.h"
+#include "./time-sync.h"
+
+#define LOG_MODULE "Time sync"
+#define LOG_LEVEL LOG_LEVEL_TIME_SYNC
+
+/* Key of the time in the messages of the collector. */
+#define TIME_SYNC_KEY   "\"time\":"
+
+/* Offset from the time since the boot to the time of the collector, in milliseconds. */
+static uint64_t offset;
+static bool synchronized;
+
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief          Convert a clock tick into milliseconds since the boot.
+ * \param tick     The clock tick.
+ * \return         The milliseconds elapsed from the boot to the tick.
+ */
+static uint64_t
+ticks_to_ms(clock_time_t tick)
+{
+  return (uint64_t)tick * 1000 / CLOCK_SECOND;
+}
+/*---------------------------------------------------------------------------*/
+void
+time_sync_init(void)
+{
+  offset = 0;
+  synchronized = false;
+}
+/*---------------------------------------------------------------------------*/
+bool
+time_sync_handle_message(const char *payload, uint16_t length, clock_time_t request_tick)
+{
+  const char *end = payload + length;
+  const char *cursor;
+  clock_time_t now = clock_time();
+  uint64_t time = 0;
+  uint16_t i;
+
+  /* The payload is not null terminated, so strstr() cannot be used. */
+  for(i = 0; i + sizeof(TIME_SYNC_KEY) - 1 <= length; i++) {
+    if(memcmp(payload + i, TIME_SYNC_KEY, sizeof(TIME_SYNC_KEY) - 1) == 0) {
+      break;
+    }
+  }
+  cursor = payload + i + sizeof(TIME_SYNC_KEY) - 1;
+  if(cursor > end) {
+    LOG_INFO("Discarding the time: bad format.\n");
+    return false;
+  }
+
+  while(cursor < end && *cursor == ' ') {
+    cursor++;
+  }
+  if(cursor == end || *cursor < '0' || *cursor > '9') {
+    LOG_INFO("Discarding the time: bad format.\n");
+    return false;
+  }
+  while(cursor < end && *cursor >= '0' && *cursor <= '9') {
+    time = time * 10 + (*cursor - '0');
+    cursor++;
+  }
+
+  /* The time was read by the collector halfway through the round trip. */
+  offset = time + ticks_to_ms(now - request_tick) / 2 - ticks_to_ms(now);
+  if(!synchronized) {
+    LOG_INFO("Synchronized with the time of the collector.\n");
+  }
+  synchronized = true;
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+bool
+time_sync_synchronized(void)
+{
+  return synchronized;
+}
+/*---------------------------------------------------------------------------*/
+uint64_t
+time_sync_to_ms(clock_time_t tick)
+{
+  return offset + ticks_to_ms(tick);
+}
+/*---------------------------------------------------------------------------*/
+int
+time_sync_snprint(char *buffer, size_t size, clock_time_t tick)
+{
+  uint64_t time = time_sync_to_ms(tick);
+
+  if(time < 1000) {
+    return snprintf(buffer, size, "%u", (unsigned int)time);
+  }
+  return snprintf(buffer, size, "%lu%03u", (unsigned long)(time / 1000), (unsigned int)(time % 1000));
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
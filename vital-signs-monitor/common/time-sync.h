@@ -0,0 +1,72 @@
+/**
+ * \file
+ *         Header file for the time synchronization with the collector
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \defgroup time-sync Time synchronization
+ * @{
+ *
+ * The time-sync module keeps the offset between the clock of the monitor, which
+ * starts from 0 at each boot, and the wall-clock time of the collector, so that the
+ * monitor can timestamp its samples and events with absolute times in milliseconds.
+ * The collector sends its time, in milliseconds since the epoch, in the answer to the
+ * registration and then periodically: when the time is received in answer to a request,
+ * half of the round trip time is added to it. Until the first time is received, the
+ * times are in milliseconds since the boot of the monitor, which the collector tells
+ * apart from the absolute ones by their magnitude.
+ */
+
+#ifndef SMART_ICU_TIME_SYNC_H
+#define SMART_ICU_TIME_SYNC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "contiki.h"
+
+/**
+ * \brief   Initialize the module, forgetting the offset from the time of the collector.
+ */
+void time_sync_init(void);
+
+/**
+ * \brief                  Handle a message carrying the time of the collector.
+ * \param payload          The payload of the message, in the form {"time": <ms>}, not necessarily null terminated.
+ * \param length           The length of the payload.
+ * \param request_tick     The clock tick at which the request answered by the message was sent,
+ *                         or the current clock tick if the message was not requested.
+ * \return                 true if the message carried a valid time, false otherwise.
+ */
+bool time_sync_handle_message(const char *payload, uint16_t length, clock_time_t request_tick);
+
+/**
+ * \brief    Check if the time of the collector has been received.
+ * \return   true if the absolute times are available, false otherwise.
+ */
+bool time_sync_synchronized(void);
+
+/**
+ * \brief          Convert a clock tick of the monitor into a time.
+ * \param tick     The clock tick.
+ * \return         The time of the tick in milliseconds since the epoch, or since
+ *                 the boot of the monitor if it is not synchronized.
+ */
+uint64_t time_sync_to_ms(clock_time_t tick);
+
+/**
+ * \brief          Print the time of a clock tick of the monitor as a decimal number.
+ * \param buffer   A pointer to the buffer that will store the number.
+ * \param size     The size of the buffer.
+ * \param tick     The clock tick.
+ * \return         The value returned by <code>snprintf()</code>.
+ *
+ *                 The time is printed without 64-bit conversions, which are not
+ *                 supported by the printf implementation of every platform.
+ */
+int time_sync_snprint(char *buffer, size_t size, clock_time_t tick);
+
+#endif /* SMART_ICU_TIME_SYNC_H */
+/** @} */
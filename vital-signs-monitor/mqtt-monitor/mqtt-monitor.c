@@ -11,6 +11,9 @@
  *
  * The mqtt-monitor module provides a simulation of a vital signs monitor
  * that uses the MQTT protocol to exchange data with a collector.
+ * Built with "make MQTT_SN=1", the monitor reaches the broker through an MQTT-SN
+ * gateway over UDP instead of connecting to it over TCP: the topics are then
+ * replaced by the predefined topic IDs known by the gateway.
  */
 
 #include <stdbool.h>
@@ -24,10 +27,20 @@
 #include "os/dev/button-hal.h"
 #include "../common/sensors-cmd.h"
 #include "../common/json-message.h"
-#include "../common/alarm.h"
-#include "../common/alarm-constants.h"
+#include "../common/monitor-core.h"
+#include "../common/backoff.h"
+#include "../common/sample-history.h"
+#include "../common/time-sync.h"
+#include "../common/monitor-config.h"
+#include "../common/monitor-log.h"
+#include "../common/monitor-diagnostics.h"
 #include "./utils/mqtt-output-queue.h"
+#include "./utils/mqtt-buffer-pool.h"
+#include "./utils/mqtt-batch.h"
 #include "./utils/mqtt-monitor-constants.h"
+#ifdef MQTT_MONITOR_MQTT_SN
+#include "./utils/mqtt-sn.h"
+#endif
 
 #define LOG_MODULE "MQTT vital signs monitor"
 #define LOG_LEVEL LOG_LEVEL_MQTT_MONITOR
@@ -37,99 +50,122 @@ PROCESS_NAME(mqtt_vital_signs_monitor);
 /* Structure representing an MQTT vital signs monitor. */
 struct mqtt_monitor {
   char monitor_id[MQTT_MONITOR_ID_LENGTH];
-  struct alarm_system alarm;
+  struct monitor_core core;
+
+  /* Handle assigned by the collector at registration, -1 until it is received. */
+  int32_t handle;
+
+  /* Samples waiting to be published in a batch, and time of the last retained state. */
+  struct sample_history sample_history;
+  clock_time_t last_state_time;
 
   /* Internal state. */
   clock_time_t state_check_interval;
   struct etimer state_check_timer;
   uint8_t state;
 
-  /* ID of the patient currently attached to the monitor. */
-  char patient_id[MQTT_MONITOR_PATIENT_ID_LENGTH];
-
   /*
    * Management of the MQTT connection and of the MQTT message output queue.
    * The latter is not implemented by default in the Contiki module
    * (the Contiki MQTT "output queue" has only space for one message at a time).
    */
   struct mqtt_module {
+#ifdef MQTT_MONITOR_MQTT_SN
+    struct mqtt_sn_connection connection;
+#else
     struct mqtt_connection connection;
+#endif
     mqtt_status_t status;
+    struct backoff connection_backoff;
+    clock_time_t next_connection_time;
     struct mqtt_output_queue output_queue;
     struct ctimer output_queue_timer;
     clock_time_t output_queue_timer_interval;
+#ifndef MQTT_MONITOR_MQTT_SN
+    /* Buffer of the message being sent by the MQTT engine, which does not copy the payload. */
+    char *sending_buffer;
+
+    /* Handle assigned while a message was being sent, -1 if none. */
+    int32_t pending_handle;
+#endif
   } mqtt_module;
 
   /* Buffers used to store the topics regarding commands. */
   struct cmd_topics {
     char patient_registration[MQTT_MONITOR_TOPIC_MAX_LENGTH];
     char monitor_registration[MQTT_MONITOR_TOPIC_MAX_LENGTH];
+    char monitor[MQTT_MONITOR_TOPIC_MAX_LENGTH];
+    char handle[MQTT_MONITOR_TOPIC_MAX_LENGTH];
+    char time[MQTT_MONITOR_TOPIC_MAX_LENGTH];
+    char config[MQTT_MONITOR_TOPIC_MAX_LENGTH];
     char alarm_state[MQTT_MONITOR_TOPIC_MAX_LENGTH];
+    char alarm_history[MQTT_MONITOR_TOPIC_MAX_LENGTH];
   } cmd_topics;
 
   /* Buffers used to store the topics regarding telemetry data. */
   struct telemetry_topics {
-    char oxygen_saturation[MQTT_MONITOR_TOPIC_MAX_LENGTH];
-    char blood_pressure[MQTT_MONITOR_TOPIC_MAX_LENGTH];
-    char temperature[MQTT_MONITOR_TOPIC_MAX_LENGTH];
-    char respiration[MQTT_MONITOR_TOPIC_MAX_LENGTH];
+    char batch[MQTT_MONITOR_TOPIC_MAX_LENGTH];
     char alarm_state[MQTT_MONITOR_TOPIC_MAX_LENGTH];
-    char heart_rate[MQTT_MONITOR_TOPIC_MAX_LENGTH];
+    char alarm_history[MQTT_MONITOR_TOPIC_MAX_LENGTH];
+    char state[MQTT_MONITOR_TOPIC_MAX_LENGTH];
+    char diagnostics[MQTT_MONITOR_TOPIC_MAX_LENGTH];
   } telemetry_topics;
-
-  /* Buffers used to store the output messages. */
-  struct output_buffers {
-    char patient_registration[MQTT_MONITOR_OUTPUT_BUFFER_SIZE];
-    char monitor_registration[MQTT_MONITOR_OUTPUT_BUFFER_SIZE];
-    char oxygen_saturation[MQTT_MONITOR_OUTPUT_BUFFER_SIZE];
-    char blood_pressure[MQTT_MONITOR_OUTPUT_BUFFER_SIZE];
-    char temperature[MQTT_MONITOR_OUTPUT_BUFFER_SIZE];
-    char respiration[MQTT_MONITOR_OUTPUT_BUFFER_SIZE];
-    char alarm_state[MQTT_MONITOR_OUTPUT_BUFFER_SIZE];
-    char heart_rate[MQTT_MONITOR_OUTPUT_BUFFER_SIZE];
-  } output_buffers;
 };
 
 static struct mqtt_monitor monitor;
 
+#ifdef MQTT_MONITOR_MQTT_SN
+/* Predefined MQTT-SN topic IDs of the topics of the monitor, with the QoS of their messages. */
+static const struct mqtt_sn_topic {
+  const char *topic;
+  uint16_t topic_id;
+  int8_t qos;
+} mqtt_sn_topics[] = {
+  { monitor.cmd_topics.monitor_registration, MQTT_MONITOR_SN_TOPIC_ID_MONITOR_REGISTRATION, MQTT_MONITOR_SN_EVENTS_QOS },
+  { monitor.cmd_topics.patient_registration, MQTT_MONITOR_SN_TOPIC_ID_PATIENT_REGISTRATION, MQTT_MONITOR_SN_EVENTS_QOS },
+  { monitor.telemetry_topics.batch, MQTT_MONITOR_SN_TOPIC_ID_BATCH, MQTT_MONITOR_SN_SAMPLES_QOS },
+  { monitor.telemetry_topics.alarm_state, MQTT_MONITOR_SN_TOPIC_ID_ALARM_STATE, MQTT_MONITOR_SN_EVENTS_QOS },
+  { monitor.telemetry_topics.alarm_history, MQTT_MONITOR_SN_TOPIC_ID_ALARM_HISTORY, MQTT_MONITOR_SN_EVENTS_QOS },
+  { monitor.telemetry_topics.state, MQTT_MONITOR_SN_TOPIC_ID_STATE, MQTT_MONITOR_SN_SAMPLES_QOS },
+  { monitor.telemetry_topics.diagnostics, MQTT_MONITOR_SN_TOPIC_ID_DIAGNOSTICS, MQTT_MONITOR_SN_SAMPLES_QOS },
+  { monitor.cmd_topics.alarm_state, MQTT_MONITOR_SN_TOPIC_ID_CMD_ALARM_STATE, MQTT_MONITOR_SN_EVENTS_QOS },
+  { monitor.cmd_topics.alarm_history, MQTT_MONITOR_SN_TOPIC_ID_CMD_ALARM_HISTORY, MQTT_MONITOR_SN_EVENTS_QOS },
+  { monitor.cmd_topics.time, MQTT_MONITOR_SN_TOPIC_ID_CMD_TIME, MQTT_MONITOR_SN_EVENTS_QOS },
+  { monitor.cmd_topics.config, MQTT_MONITOR_SN_TOPIC_ID_CMD_CONFIG, MQTT_MONITOR_SN_EVENTS_QOS },
+};
+#define MQTT_SN_TOPICS_NUMBER (sizeof(mqtt_sn_topics) / sizeof(mqtt_sn_topics[0]))
+
 /*---------------------------------------------------------------------------*/
 /**
- * \brief                 Check if a sample should trigger an alarm.
- * \param min_threshold   The minimum threshold that should trigger an alarm.
- * \param max_threshold   The maximum threshold that should trigger an alarm.
- * \param sample          The sample to be checked.
- * \return                true if the event should trigger an alarm, false otherwise.
- *
- *                        The function checks if a sample should trigger an alarm,
- *                        i.e. if the sample is less than or equal to <code>min_threshold</code>,
- *                        or greater than or equal to <code>max_threshold</code>.
+ * \brief          Publish a message through the MQTT-SN gateway.
+ * \param topic    A pointer to the buffer storing the topic, replaced by its predefined topic ID.
+ * \param message  A pointer to the buffer storing the message.
+ * \param retain   The retain flag of the message.
+ * \return         The status of the publishing, as returned by <code>mqtt_sn_publish()</code>.
  */
-static bool
-alarming_sample(int min_threshold, int max_threshold, int sample)
+static mqtt_status_t
+mqtt_sn_publish_topic(char *topic, char *message, mqtt_retain_t retain)
 {
-  if(sample <= min_threshold || sample >= max_threshold) {
-    return true;
-  }
-  return false;
-}
-/*---------------------------------------------------------------------------*/
-/**
- * \brief    Check if the monitor is correctly connected to the network.
- * \return   true if the monitor is correctly connected to the network,
- *           false otherwise.
- *
- *           The function checks if the monitor is correctly connected
- *           to the network, namely if it has a global address
- *           and a default route.
- */
-static bool
-network_ready(void)
-{
-  if(uip_ds6_get_global(ADDR_PREFERRED) == NULL || uip_ds6_defrt_choose() == NULL) {
-    return false;
+  int i;
+
+  /* Every message, queued or not, is published from a topic buffer of the monitor: compare the buffers,
+   * since their content changes with the switch to the short topics. */
+  for(i = 0; i < MQTT_SN_TOPICS_NUMBER; i++) {
+    if(topic == mqtt_sn_topics[i].topic) {
+      return mqtt_sn_publish(&monitor.mqtt_module.connection,
+                             mqtt_sn_topics[i].topic_id,
+                             (uint8_t *)message,
+                             strlen(message),
+                             mqtt_sn_topics[i].qos,
+                             retain);
+    }
   }
-  return true;
+
+  LOG_ERR("No MQTT-SN topic ID for the topic %s.\n", topic);
+  return MQTT_STATUS_INVALID_ARGS_ERROR;
 }
+#endif
+
 /*---------------------------------------------------------------------------*/
 /**
  * \brief   Initialize the buffers holding the command and telemetry topics.
@@ -137,148 +173,563 @@ network_ready(void)
  *          The function initializes the buffers holding the
  *          command and telemetry topics. It must be called
  *          after the monitor ID has been initialized,
- *          which is done in <code>network_ready()</code>.
+ *          which is done in <code>handle_state_network_ready()</code>.<br>
+ *          The telemetry topics embed the monitor ID until the collector
+ *          assigns a handle to the monitor (see <code>init_short_topics()</code>):
+ *          the handle is forgotten, since the collector that assigned it
+ *          may have been restarted in the meantime.
  */
 static void
 init_topics(void)
 {
+  monitor.handle = -1;
+#ifndef MQTT_MONITOR_MQTT_SN
+  monitor.mqtt_module.pending_handle = -1;
+#endif
+
   /* Command topics. */
+  snprintf(monitor.cmd_topics.monitor, MQTT_MONITOR_TOPIC_MAX_LENGTH, MQTT_MONITOR_CMD_TOPIC_MONITOR, monitor.monitor_id);
+  snprintf(monitor.cmd_topics.handle, MQTT_MONITOR_TOPIC_MAX_LENGTH, MQTT_MONITOR_CMD_TOPIC_HANDLE, monitor.monitor_id);
+  snprintf(monitor.cmd_topics.time, MQTT_MONITOR_TOPIC_MAX_LENGTH, MQTT_MONITOR_CMD_TOPIC_TIME, monitor.monitor_id);
+  snprintf(monitor.cmd_topics.config, MQTT_MONITOR_TOPIC_MAX_LENGTH, MQTT_MONITOR_CMD_TOPIC_CONFIG, monitor.monitor_id);
   snprintf(monitor.cmd_topics.alarm_state, MQTT_MONITOR_TOPIC_MAX_LENGTH, MQTT_MONITOR_CMD_TOPIC_ALARM_STATE, monitor.monitor_id);
+  snprintf(monitor.cmd_topics.alarm_history, MQTT_MONITOR_TOPIC_MAX_LENGTH, MQTT_MONITOR_CMD_TOPIC_ALARM_HISTORY, monitor.monitor_id);
   snprintf(monitor.cmd_topics.monitor_registration, MQTT_MONITOR_TOPIC_MAX_LENGTH, "%s", MQTT_MONITOR_CMD_TOPIC_MONITOR_REGISTRATION);
   snprintf(monitor.cmd_topics.patient_registration, MQTT_MONITOR_TOPIC_MAX_LENGTH, "%s",MQTT_MONITOR_CMD_TOPIC_PATIENT_REGISTRATION);
 
   /* Telemetry topics. */
-  snprintf(monitor.telemetry_topics.heart_rate, MQTT_MONITOR_TOPIC_MAX_LENGTH, MQTT_MONITOR_TELEMETRY_TOPIC_HEART_RATE, monitor.monitor_id);
-  snprintf(monitor.telemetry_topics.blood_pressure, MQTT_MONITOR_TOPIC_MAX_LENGTH, MQTT_MONITOR_TELEMETRY_TOPIC_BLOOD_PRESSURE, monitor.monitor_id);
-  snprintf(monitor.telemetry_topics.temperature, MQTT_MONITOR_TOPIC_MAX_LENGTH, MQTT_MONITOR_TELEMETRY_TOPIC_TEMPERATURE, monitor.monitor_id);
-  snprintf(monitor.telemetry_topics.respiration, MQTT_MONITOR_TOPIC_MAX_LENGTH, MQTT_MONITOR_TELEMETRY_TOPIC_RESPIRATION, monitor.monitor_id);
-  snprintf(monitor.telemetry_topics.oxygen_saturation, MQTT_MONITOR_TOPIC_MAX_LENGTH, MQTT_MONITOR_TELEMETRY_TOPIC_OXYGEN_SATURATION, monitor.monitor_id);
+  snprintf(monitor.telemetry_topics.batch, MQTT_MONITOR_TOPIC_MAX_LENGTH, MQTT_MONITOR_TELEMETRY_TOPIC_BATCH, monitor.monitor_id);
   snprintf(monitor.telemetry_topics.alarm_state, MQTT_MONITOR_TOPIC_MAX_LENGTH, MQTT_MONITOR_TELEMETRY_TOPIC_ALARM_STATE, monitor.monitor_id);
-
+  snprintf(monitor.telemetry_topics.alarm_history, MQTT_MONITOR_TOPIC_MAX_LENGTH, MQTT_MONITOR_TELEMETRY_TOPIC_ALARM_HISTORY, monitor.monitor_id);
+  snprintf(monitor.telemetry_topics.state, MQTT_MONITOR_TOPIC_MAX_LENGTH, MQTT_MONITOR_TELEMETRY_TOPIC_STATE, monitor.monitor_id);
+  snprintf(monitor.telemetry_topics.diagnostics, MQTT_MONITOR_TOPIC_MAX_LENGTH, MQTT_MONITOR_TELEMETRY_TOPIC_DIAGNOSTICS, monitor.monitor_id);
+
+  LOG_DBG("Command monitor topic: %s\n", monitor.cmd_topics.monitor);
+  LOG_DBG("Command handle topic: %s\n", monitor.cmd_topics.handle);
+  LOG_DBG("Command time topic: %s\n", monitor.cmd_topics.time);
+  LOG_DBG("Command config topic: %s\n", monitor.cmd_topics.config);
   LOG_DBG("Command alarm state topic: %s\n", monitor.cmd_topics.alarm_state);
+  LOG_DBG("Command alarm history topic: %s\n", monitor.cmd_topics.alarm_history);
   LOG_DBG("Command monitor registration topic: %s\n", monitor.cmd_topics.monitor_registration);
   LOG_DBG("Command patient registration topic: %s\n", monitor.cmd_topics.patient_registration);
-  LOG_DBG("Telemetry heart rate topic: %s\n", monitor.telemetry_topics.heart_rate);
-  LOG_DBG("Telemetry blood pressure topic: %s\n", monitor.telemetry_topics.blood_pressure);
-  LOG_DBG("Telemetry temperature topic: %s\n", monitor.telemetry_topics.temperature);
-  LOG_DBG("Telemetry respiration topic: %s\n", monitor.telemetry_topics.respiration);
-  LOG_DBG("Telemetry oxygen saturation topic: %s\n", monitor.telemetry_topics.oxygen_saturation);
+  LOG_DBG("Telemetry batch topic: %s\n", monitor.telemetry_topics.batch);
   LOG_DBG("Telemetry alarm state topic: %s\n", monitor.telemetry_topics.alarm_state);
+  LOG_DBG("Telemetry alarm history topic: %s\n", monitor.telemetry_topics.alarm_history);
+  LOG_DBG("Telemetry state topic: %s\n", monitor.telemetry_topics.state);
+  LOG_DBG("Telemetry diagnostics topic: %s\n", monitor.telemetry_topics.diagnostics);
 }
 /*---------------------------------------------------------------------------*/
 /**
- * \brief                 Publish a message to a topic.
+ * \brief          Switch the telemetry topics to the short ones embedding a handle.
+ * \param handle   The handle assigned to the monitor by the collector.
+ *
+ *                 The short topics replace the monitor ID with the handle, shrinking
+ *                 every message published afterwards. The patient registration is
+ *                 published in a short topic too, so its payload omits the monitor ID.
+ *                 The messages already in the output queue refer to the same topic buffers,
+ *                 so they are published in the short topics too.
+ */
+static void
+init_short_topics(uint16_t handle)
+{
+  monitor.handle = handle;
+
+  snprintf(monitor.cmd_topics.patient_registration, MQTT_MONITOR_TOPIC_MAX_LENGTH, MQTT_MONITOR_SHORT_TOPIC_PATIENT_REGISTRATION, handle);
+  snprintf(monitor.telemetry_topics.batch, MQTT_MONITOR_TOPIC_MAX_LENGTH, MQTT_MONITOR_SHORT_TOPIC_BATCH, handle);
+  snprintf(monitor.telemetry_topics.alarm_state, MQTT_MONITOR_TOPIC_MAX_LENGTH, MQTT_MONITOR_SHORT_TOPIC_ALARM_STATE, handle);
+  snprintf(monitor.telemetry_topics.alarm_history, MQTT_MONITOR_TOPIC_MAX_LENGTH, MQTT_MONITOR_SHORT_TOPIC_ALARM_HISTORY, handle);
+
+  LOG_INFO("Assigned handle %u: switching to the short topics.\n", handle);
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief    Compute the keep-alive requested to the broker.
+ * \return   The keep-alive, in seconds.
+ *
+ *           A batch is published once per flush window, or once per sampling interval
+ *           if the sensors sample more rarely, so a keep-alive slightly longer than that
+ *           lets the batches keep the connection alive. The keep-alive follows the sampling
+ *           intervals configured by the collector at the time of the connection.
+ */
+static uint16_t
+broker_keep_alive(void)
+{
+  uint16_t batch_interval = UINT16_MAX;
+  int sensor;
+
+  for(sensor = 0; sensor < SENSORS_NUMBER; sensor++) {
+    batch_interval = MIN(batch_interval, monitor_config_sampling_interval(sensor));
+  }
+  batch_interval = MAX(batch_interval, MQTT_MONITOR_BATCH_FLUSH_WINDOW);
+
+  return MIN(batch_interval, UINT16_MAX - MQTT_MONITOR_BROKER_KEEP_ALIVE_MARGIN) + MQTT_MONITOR_BROKER_KEEP_ALIVE_MARGIN;
+}
+#ifndef MQTT_MONITOR_MQTT_SN
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief   Give the buffer of the last message sent by the MQTT engine back to the pool.
+ *
+ *          The function is called by the periodic timer checking the internal state.
+ *          The buffer is given back once the engine is ready to accept a new message,
+ *          i.e. once it is done with the previous one, or once the connection is lost.
+ *          The switch to the short topics postponed while the message was being sent
+ *          is made at the same time.
+ */
+static void
+release_sent_buffer(void)
+{
+  if(monitor.mqtt_module.sending_buffer == NULL
+     || (mqtt_connected(&monitor.mqtt_module.connection) && monitor.mqtt_module.connection.out_queue_full)) {
+    return;
+  }
+
+  mqtt_buffer_pool_free(monitor.mqtt_module.sending_buffer);
+  monitor.mqtt_module.sending_buffer = NULL;
+
+  if(monitor.mqtt_module.pending_handle >= 0) {
+    init_short_topics((uint16_t)monitor.mqtt_module.pending_handle);
+    monitor.mqtt_module.pending_handle = -1;
+  }
+}
+#endif
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief                 Hand a message to the MQTT engine.
  * \param topic           A pointer to the buffer storing the topic.
  * \param output_buffer   A pointer to the buffer storing the message.
+ * \param retain          MQTT_RETAIN_ON if the broker must keep the message as the last one of the topic.
+ * \return                The status of the publishing, also stored in <code>monitor.mqtt_module.status</code>.
  *
- *                        The function publishes a message to a topic. If the operation
- *                        fails due to a MQTT_STATUS_OUT_QUEUE_FULL error, the function
- *                        stores the message, together with its topic, in the monitor
- *                        output queue, so that a retransmission can be attempted later.
- *                        If the monitor output queue is full too, the message is discarded.<br>
- *                        It should be noted that the MQTT module of Contiki does not
- *                        provide an output queue, so only one message at a time could be
- *                        sent using it as it is.
+ *                        The output buffer comes from the message buffer pool. If the message is
+ *                        accepted, the buffer is given back to the pool once the message has been
+ *                        sent: the MQTT engine sends it straight from the buffer, which is held until
+ *                        the engine is ready for the next message (see <code>release_sent_buffer()</code>).
+ *                        Otherwise, the buffer still belongs to the caller.<br>
+ *                        The engine does not copy the topic either: it must be one of the topic
+ *                        buffers of the monitor, which are not rewritten while a message is being sent.
  */
-static void
-publish(char *topic, char* output_buffer)
+static mqtt_status_t
+send_message(char *topic, char *output_buffer, mqtt_retain_t retain)
 {
-  LOG_INFO("Publishing %s in the topic %s.\n", output_buffer, topic);
+  LOG_DBG("Publishing %s in the topic %s.\n", output_buffer, topic);
+#ifdef MQTT_MONITOR_MQTT_SN
+  monitor.mqtt_module.status = mqtt_sn_publish_topic(topic, output_buffer, retain);
+#else
   monitor.mqtt_module.status = mqtt_publish(&monitor.mqtt_module.connection,
                                             NULL,
                                             topic,
                                             (uint8_t *)output_buffer,
                                             strlen(output_buffer),
                                             MQTT_QOS_LEVEL_0,
-                                            MQTT_RETAIN_OFF);
+                                            retain);
+#endif
+  monitor_log_event(MONITOR_LOG_EVENT_PUBLISH, monitor.mqtt_module.status, strlen(output_buffer));
   switch(monitor.mqtt_module.status) {
   case MQTT_STATUS_OK:
-    return;
-  case MQTT_STATUS_NOT_CONNECTED_ERROR: {
+#ifdef MQTT_MONITOR_MQTT_SN
+    /* The MQTT-SN client copies the message in its packet. */
+    mqtt_buffer_pool_free(output_buffer);
+#else
+    /* The engine accepts a message only once done with the previous one. */
+    mqtt_buffer_pool_free(monitor.mqtt_module.sending_buffer);
+    monitor.mqtt_module.sending_buffer = output_buffer;
+#endif
+    break;
+  case MQTT_STATUS_NOT_CONNECTED_ERROR:
     LOG_ERR("Publishing failed. Error: MQTT_STATUS_NOT_CONNECTED_ERROR.\n");
-    return;
-  }
-  case MQTT_STATUS_OUT_QUEUE_FULL: {
+    break;
+  case MQTT_STATUS_OUT_QUEUE_FULL:
     LOG_ERR("Publishing failed. Error: MQTT_STATUS_OUT_QUEUE_FULL.\n");
     break;
-  }
   default:
     LOG_ERR("Publishing failed. Error: unknown.\n");
-    return;
+    break;
   }
 
-  if(!mqtt_output_queue_is_full(&monitor.mqtt_module.output_queue)) {
-    LOG_INFO("Enqueuing the message in the output queue.\n");
-    mqtt_output_queue_insert(&monitor.mqtt_module.output_queue, output_buffer, topic);
-  } else {
-    LOG_INFO("The output queue is full. Discarding the message.\n");
+  if(monitor.mqtt_module.status != MQTT_STATUS_OK) {
+    monitor_diagnostics_record_failure(monitor.mqtt_module.status);
   }
+  return monitor.mqtt_module.status;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief                 Publish a message to a topic.
+ * \param topic           A pointer to the buffer storing the topic.
+ * \param output_buffer   A pointer to the buffer storing the message, borrowed from the message buffer pool.
+ * \param retain          MQTT_RETAIN_ON if the broker must keep the message as the last one of the topic.
+ * \return                true if the message has been sent or enqueued, false otherwise.
+ *
+ *                        The function publishes a message to a topic, taking over its buffer,
+ *                        which is given back to the pool once it is not needed anymore. If the operation
+ *                        fails due to a MQTT_STATUS_OUT_QUEUE_FULL error, the function
+ *                        stores the message, together with its topic, in the monitor
+ *                        output queue, so that a retransmission can be attempted later.
+ *                        If the monitor output queue is full too, the message is discarded.<br>
+ *                        It should be noted that the MQTT module of Contiki does not
+ *                        provide an output queue, so only one message at a time could be
+ *                        sent using it as it is.
+ */
+static bool
+publish(char *topic, char* output_buffer, mqtt_retain_t retain)
+{
+  switch(send_message(topic, output_buffer, retain)) {
+  case MQTT_STATUS_OK:
+    return true;
+  case MQTT_STATUS_OUT_QUEUE_FULL:
+    break;
+  default:
+    monitor_diagnostics_record_drop();
+    mqtt_buffer_pool_free(output_buffer);
+    return false;
+  }
+
+  if(mqtt_output_queue_insert(&monitor.mqtt_module.output_queue, output_buffer, topic, retain)) {
+    monitor_log_event(MONITOR_LOG_EVENT_QUEUE_INSERT, monitor.mqtt_module.output_queue.length, 0);
+    monitor_diagnostics_record_queue_length(monitor.mqtt_module.output_queue.length);
+    return true;
+  }
+
+  LOG_WARN("The output queue is full. Discarding the message.\n");
+  monitor_log_event(MONITOR_LOG_EVENT_QUEUE_DROP, monitor.mqtt_module.output_queue.length, 0);
+  monitor_diagnostics_record_drop();
+  mqtt_buffer_pool_free(output_buffer);
+  return false;
 }
 /*---------------------------------------------------------------------------*/
 /**
  * \brief   Transmit the first message in the MQTT message output queue.
  *
  *          The function transmits the first message in the MQTT message output queue,
- *          if the latter is not empty. The transmission is done combining an
- *          <code>mqtt_output_queue_extract()</code> and a <code>publish()</code>:
- *          this means that, if a MQTT_STATUS_OUT_QUEUE_FULL error occurs also for the
- *          retransmission, the message is enqueued again (not preserving
- *          its original placement).<br>
+ *          if the latter is not empty. The message is published straight from its buffer,
+ *          in the topic buffer of the monitor stored with it, and its slot of the queue is
+ *          released once the MQTT engine accepted it: the engine keeps referring to those
+ *          buffers, not to the slot, which can then be reused. If the engine is still busy
+ *          or the monitor is disconnected, the message keeps its place at the head of the
+ *          queue and is retried at the next expiration.
+ *          A message refused for any other reason is discarded, so that it does not
+ *          block the queue.<br>
  *          This function is the callback of the ctimer initialized for the output queue.
  */
 static void
 retry_message_transmission()
 {
-  static char msg[MQTT_MONITOR_OUTPUT_BUFFER_SIZE];
-  static char topic[MQTT_MONITOR_TOPIC_MAX_LENGTH];
+  char *msg;
+  char *topic;
+  mqtt_retain_t retain;
+  clock_time_t interval;
 
   LOG_DBG("Output queue size: %d, insert_index: %d, extract_index:%d\n",
            monitor.mqtt_module.output_queue.length, monitor.mqtt_module.output_queue.insert_index,
            monitor.mqtt_module.output_queue.extract_index);
 
-  if(!mqtt_output_queue_is_empty(&monitor.mqtt_module.output_queue)) {
-    LOG_INFO("Retrying transmission of messages in the output queue. Output queue size: %d.\n",
-             monitor.mqtt_module.output_queue.length);
-    memset(msg, 0, MQTT_MONITOR_OUTPUT_BUFFER_SIZE);
-    memset(topic, 0, MQTT_MONITOR_TOPIC_MAX_LENGTH);
-    mqtt_output_queue_extract(&monitor.mqtt_module.output_queue, msg, topic);
-    publish(topic, msg);
+  if(mqtt_output_queue_peek(&monitor.mqtt_module.output_queue, &msg, &topic, &retain)) {
+    monitor_log_event(MONITOR_LOG_EVENT_QUEUE_RETRY, monitor.mqtt_module.output_queue.length, 0);
+    switch(send_message(topic, msg, retain)) {
+    case MQTT_STATUS_OUT_QUEUE_FULL:
+    case MQTT_STATUS_NOT_CONNECTED_ERROR:
+      break;
+    case MQTT_STATUS_OK:
+      mqtt_output_queue_commit(&monitor.mqtt_module.output_queue);
+      break;
+    default:
+      mqtt_output_queue_commit(&monitor.mqtt_module.output_queue);
+      monitor_diagnostics_record_drop();
+      mqtt_buffer_pool_free(msg);
+      break;
+    }
   }
 
+  /* The send interval can be changed at runtime by the collector. */
+  interval = monitor_config_send_interval(MQTT_MONITOR_OUTPUT_QUEUE_SEND_INTERVAL)*CLOCK_SECOND;
+  if(interval != monitor.mqtt_module.output_queue_timer_interval) {
+    monitor.mqtt_module.output_queue_timer_interval = interval;
+    ctimer_set(&monitor.mqtt_module.output_queue_timer, interval, retry_message_transmission, NULL);
+    return;
+  }
   ctimer_reset(&monitor.mqtt_module.output_queue_timer);
 }
 /*---------------------------------------------------------------------------*/
 /**
- * \brief   Handle the reception of a new patient ID on the serial line.
+ * \brief   Discard the messages in the output queue, giving their buffers back to the pool.
+ */
+static void
+clear_output_queue(void)
+{
+  char *msg;
+  char *topic;
+  mqtt_retain_t retain;
+
+  while(mqtt_output_queue_peek(&monitor.mqtt_module.output_queue, &msg, &topic, &retain)) {
+    mqtt_output_queue_commit(&monitor.mqtt_module.output_queue);
+    mqtt_buffer_pool_free(msg);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief          Publish the last known state of the monitor as a retained message.
+ * \param alarm    The state of the alarm system.
+ *
+ *                 The state carries the patient ID, the newest sample of each sensor and
+ *                 the alarm state. Being retained by the broker, it is delivered as soon as
+ *                 they subscribe to dashboards and restarted collectors, which otherwise
+ *                 would wait for the next samples (up to the longest sampling interval).
+ *                 Without a patient, the samples of the previous one are left out.
+ */
+static void
+publish_state(alarm_state alarm)
+{
+  const struct sample_record *record;
+  int samples[SENSORS_NUMBER];
+  int sensor;
+  uint8_t length;
+  char *buffer;
+
+  for(sensor = 0; sensor < SENSORS_NUMBER; sensor++) {
+    length = monitor.sample_history.length[sensor];
+    record = length > 0 ? sample_history_get(&monitor.sample_history, sensor, length - 1) : NULL;
+    samples[sensor] = (record != NULL && monitor.core.patient_id[0] != '\0') ? record->value : -1;
+  }
+
+  buffer = mqtt_buffer_pool_alloc();
+  if(buffer == NULL) {
+    return;
+  }
+
+  json_message_monitor_state(buffer,
+                             MQTT_MONITOR_OUTPUT_BUFFER_SIZE,
+                             monitor.core.patient_id,
+                             samples,
+                             alarm,
+                             monitor.sample_history.next_seq);
+  if(publish(monitor.telemetry_topics.state, buffer, MQTT_RETAIN_ON)) {
+    monitor.last_state_time = clock_time();
+  }
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief           Publish a batch of samples in the batch topic of the monitor.
+ * \param message   A pointer to the buffer storing the batch.
+ * \return          true if the batch has been sent or enqueued, false otherwise.
+ *
+ *                  The retained state of the monitor is refreshed together with a batch only
+ *                  every MQTT_MONITOR_RETAINED_STATE_INTERVAL seconds, so that most of the flush
+ *                  windows cost a single message: the changes of the patient and of the alarm
+ *                  state refresh it on their own.
+ *                  While the monitor is not connected the batch is not published: its samples
+ *                  stay in the sample history and are published at the next flush.
+ */
+static bool
+publish_batch(char *message)
+{
+  if(monitor.state != MQTT_MONITOR_STATE_OPERATIONAL) {
+    mqtt_buffer_pool_free(message);
+    return false;
+  }
+
+  if(!publish(monitor.telemetry_topics.batch, message, MQTT_RETAIN_OFF)) {
+    return false;
+  }
+
+  if(clock_time() - monitor.last_state_time >= MQTT_MONITOR_RETAINED_STATE_INTERVAL*CLOCK_SECOND) {
+    publish_state(monitor.core.alarm.state);
+  }
+
+#ifdef MQTT_MONITOR_MQTT_SN
+  LOG_DBG("MQTT-SN traffic: sent %lu bytes in %lu packets (%lu retransmissions, %lu PINGREQs), received %lu bytes.\n",
+          monitor.mqtt_module.connection.stats.sent_bytes,
+          monitor.mqtt_module.connection.stats.sent_packets,
+          monitor.mqtt_module.connection.stats.retransmissions,
+          monitor.mqtt_module.connection.stats.pingreqs,
+          monitor.mqtt_module.connection.stats.received_bytes);
+#endif
+  LOG_DBG("Message buffers in use at the same time: at most %d of %d.\n",
+          mqtt_buffer_pool_max_used(), MQTT_MONITOR_BUFFER_POOL_SIZE);
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief          Send a new sample to the collector.
+ * \param sensor   The sensor that produced the sample.
+ * \param sample   The sample.
+ *
+ *                 The function records the sample in the sample history, from which
+ *                 it is published together with the other samples of the flush window.
+ */
+static void
+publish_sample(sensor_type sensor, int sample)
+{
+  sample_history_record(&monitor.sample_history, sensor, sample);
+  mqtt_batch_sample_recorded();
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief         Inform the collector about a change of the alarm state.
+ * \param state   The new alarm state.
+ *
+ *                The message is published immediately, without waiting for the end of the flush window.
+ */
+static void
+publish_alarm_state(alarm_state state)
+{
+  char *buffer = mqtt_buffer_pool_alloc();
+
+  if(buffer != NULL) {
+    if(state == ALARM_ON) {
+      json_message_alarm_started(buffer, MQTT_MONITOR_OUTPUT_BUFFER_SIZE);
+    } else {
+      json_message_alarm_stopped(buffer, MQTT_MONITOR_OUTPUT_BUFFER_SIZE);
+    }
+    publish(monitor.telemetry_topics.alarm_state, buffer, MQTT_RETAIN_OFF);
+  }
+  publish_state(state);
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief              Inform the collector about the patient attached to the monitor.
+ * \param patient_id   The patient ID (empty if reset).
+ *
+ *                     The function sends a patient registration message to the collector.
+ *                     If the patient ID has been reset, the output queue and the pending samples
+ *                     are cleared before, to avoid that old messages get assigned to the new patient.
+ */
+static void
+publish_patient_id(char *patient_id)
+{
+  char *buffer;
+
+  if(patient_id[0] == '\0') {
+    clear_output_queue();
+    mqtt_batch_discard();
+  }
+
+  /* In the short topic the monitor is identified by its handle. */
+  buffer = mqtt_buffer_pool_alloc();
+  if(buffer != NULL) {
+    json_message_patient_registration(buffer,
+                                      MQTT_MONITOR_OUTPUT_BUFFER_SIZE,
+                                      monitor.handle < 0 ? monitor.monitor_id : NULL,
+                                      patient_id);
+    publish(monitor.cmd_topics.patient_registration, buffer, MQTT_RETAIN_OFF);
+  }
+  publish_state(monitor.core.alarm.state);
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief          Publish the diagnostics report of the last period.
+ * \param report   A pointer to the report.
+ */
+static void
+publish_diagnostics(const struct monitor_diagnostics *report)
+{
+  char *buffer;
+
+  buffer = mqtt_buffer_pool_alloc();
+  if(buffer == NULL) {
+    monitor_diagnostics_record_drop();
+    return;
+  }
+
+  json_message_diagnostics(buffer, MQTT_MONITOR_OUTPUT_BUFFER_SIZE, report);
+  publish(monitor.telemetry_topics.diagnostics, buffer, MQTT_RETAIN_OFF);
+}
+/*---------------------------------------------------------------------------*/
+/* Transport used by the monitor core: the collector is informed through the MQTT broker. */
+static const struct monitor_transport mqtt_transport = {
+  publish_sample,
+  publish_alarm_state,
+  publish_patient_id,
+  publish_diagnostics,
+};
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief                Change the monitor state according to the
+ *                       presence of a patient ID.
+ * \param has_patient   true if a patient ID has been configured.
+ *
+ *                       The function changes the monitor state to MQTT_MONITOR_STATE_OPERATIONAL
+ *                       if a patient ID has been configured, to MQTT_MONITOR_STATE_WAITING_PATIENT_ID
+ *                       otherwise.
+ */
+static void
+update_patient_state(bool has_patient)
+{
+  monitor.state = has_patient ? MQTT_MONITOR_STATE_OPERATIONAL : MQTT_MONITOR_STATE_WAITING_PATIENT_ID;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief   Handle a request for the alarm history sent by the collector.
  *
- *          The function handles the reception of a new patient ID
- *          on the serial line, sending a registration message to
- *          the collector and restarting the sampling activity
- *          of the sensor processes. It changes the
- *          monitor state to MQTT_MONITOR_STATE_OPERATIONAL.
+ *          The function handles a request for the alarm history, publishing
+ *          in a single message the events starting from the sequence number
+ *          specified in the request. A request that does not specify
+ *          a sequence number retrieves all the stored events.
  */
 static void
-handle_new_patient_ID(char *patient_id)
+handle_alarm_history_request(struct mqtt_message *msg)
 {
-  memcpy(monitor.patient_id, patient_id, MQTT_MONITOR_PATIENT_ID_LENGTH);
-  monitor.patient_id[MQTT_MONITOR_PATIENT_ID_LENGTH - 1] = '\0';
-  LOG_INFO("New patient ID: %s.\n", monitor.patient_id);
+  char request[MQTT_MONITOR_INPUT_BUFFER_SIZE];
+  unsigned long since = 0;
+  uint16_t length;
+  char *buffer;
+
+  /* The payload is not null terminated. */
+  length = MIN(msg->payload_chunk_length, MQTT_MONITOR_INPUT_BUFFER_SIZE - 1);
+  memcpy(request, msg->payload_chunk, length);
+  request[length] = '\0';
+
+  if(sscanf(request, "{\"since\": %lu}", &since) != 1) {
+    since = 0;
+  }
+
+  buffer = mqtt_buffer_pool_alloc();
+  if(buffer == NULL) {
+    return;
+  }
 
-  /* Register the new patient ID sending a message to the collector. */
-  json_message_patient_registration(monitor.output_buffers.patient_registration,
-                                    MQTT_MONITOR_OUTPUT_BUFFER_SIZE,
-                                    monitor.monitor_id,
-                                    monitor.patient_id);
-  publish(monitor.cmd_topics.patient_registration, monitor.output_buffers.patient_registration);
+  LOG_INFO("Sending the alarm history since the event %lu.\n", since);
+  json_message_alarm_history(buffer,
+                             MQTT_MONITOR_OUTPUT_BUFFER_SIZE,
+                             &monitor.core.alarm_history,
+                             (uint32_t)since);
+  publish(monitor.telemetry_topics.alarm_history, buffer, MQTT_RETAIN_OFF);
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief   Handle the handle assigned to the monitor by the collector.
+ *
+ *          The function parses the handle sent by the collector in answer
+ *          to the monitor registration and switches to the short topics.
+ */
+static void
+handle_handle_assignment(struct mqtt_message *msg)
+{
+  char assignment[MQTT_MONITOR_INPUT_BUFFER_SIZE];
+  unsigned int handle;
+  uint16_t length;
 
-  /* Start the sampling activity of the sensors. */
-  sensors_cmd_start_sampling(&mqtt_vital_signs_monitor);
+  /* The payload is not null terminated. */
+  length = MIN(msg->payload_chunk_length, MQTT_MONITOR_INPUT_BUFFER_SIZE - 1);
+  memcpy(assignment, msg->payload_chunk, length);
+  assignment[length] = '\0';
 
-  monitor.state = MQTT_MONITOR_STATE_OPERATIONAL;
+  if(sscanf(assignment, "{\"handle\": %u}", &handle) != 1 || handle > UINT16_MAX) {
+    LOG_INFO("Discarding the handle: bad format.\n");
+    return;
+  }
+
+#ifndef MQTT_MONITOR_MQTT_SN
+  /* The MQTT engine is still sending from one of the topic buffers: switch once it is done. */
+  if(monitor.mqtt_module.sending_buffer != NULL) {
+    monitor.mqtt_module.pending_handle = handle;
+    return;
+  }
+#endif
+
+  init_short_topics((uint16_t)handle);
 }
 /*---------------------------------------------------------------------------*/
 /**
- * \brief   Handle the publishing of an MQTT message to the subscribed topic.
+ * \brief   Handle the publishing of an MQTT message to the subscribed topics.
  */
 static void
 handle_mqtt_event_publish(struct mqtt_message *msg)
@@ -287,15 +738,42 @@ handle_mqtt_event_publish(struct mqtt_message *msg)
 
   LOG_INFO("Received %s in the topic %s.\n", msg->payload_chunk, msg->topic);
 
+  /* The handle is sent right after the registration, before the monitor gets a patient ID. */
+  if(strcmp(msg->topic, monitor.cmd_topics.handle) == 0) {
+    handle_handle_assignment(msg);
+    return;
+  }
+
+  /* The collector sends its time after the registration and then periodically, unsolicited. */
+  if(strcmp(msg->topic, monitor.cmd_topics.time) == 0) {
+    time_sync_handle_message((const char *)msg->payload_chunk, msg->payload_chunk_length, clock_time());
+    return;
+  }
+
+  /* The configuration can be tuned at any time, also while waiting for a patient ID. */
+  if(strcmp(msg->topic, monitor.cmd_topics.config) == 0) {
+    monitor_config_apply((const char *)msg->payload_chunk, msg->payload_chunk_length);
+    return;
+  }
+
+  /* The alarm history can be requested also while waiting for a patient ID, e.g. right after the registration. */
+  if(strcmp(msg->topic, monitor.cmd_topics.alarm_history) == 0) {
+    handle_alarm_history_request(msg);
+    return;
+  }
+
   if(monitor.state != MQTT_MONITOR_STATE_OPERATIONAL) {
     LOG_INFO("Discarding the MQTT message. The monitor is not in an operating state.\n");
     return;
   }
 
   json_message_alarm_started(start_alarm_msg, MQTT_MONITOR_INPUT_BUFFER_SIZE);
-  if(strcmp(start_alarm_msg, (char*)msg->payload_chunk) == 0) {
-    LOG_INFO("Starting the alarm.\n");
-    alarm_start(&monitor.alarm); /* There is no need to notify the collector about the state change. */
+  if(strcmp(msg->topic, monitor.cmd_topics.alarm_state) == 0
+     && strcmp(start_alarm_msg, (char*)msg->payload_chunk) == 0) {
+    /* The change is recorded in the history and published, so that the retained state follows it. */
+    if(monitor_core_start_alarm(&monitor.core)) {
+      publish_alarm_state(ALARM_ON);
+    }
     return;
   }
 
@@ -309,8 +787,8 @@ handle_mqtt_event_publish(struct mqtt_message *msg)
  *          the MQTT protocol. More in details:<br>
  *          1) if the connection to the broker is successful, it changes the
  *             monitor state to MQTT_MONITOR_STATE_CONNECTED;<br>
- *          2) if the monitor gets disconnected from the broker, it changes the
- *             monitor state to MQTT_MONITOR_STATE_DISCONNECTED;<br>
+ *          2) if the monitor gets disconnected from the broker (or the connection
+ *             attempt fails), it changes the monitor state to MQTT_MONITOR_STATE_DISCONNECTED;<br>
  *          3) it handles the publishing of an MQTT message to the subscribed topic;<br>
  *          4) if the subscription to the topic of interest succeeds, it changes the
  *             monitor state to MQTT_MONITOR_STATE_SUBSCRIBED.
@@ -321,9 +799,15 @@ handle_mqtt_event(struct mqtt_connection *m, mqtt_event_t event, void *data)
   switch(event) {
   case MQTT_EVENT_CONNECTED: {
     LOG_INFO("Connected to the MQTT broker.\n");
+    backoff_success(&monitor.mqtt_module.connection_backoff);
     monitor.state = MQTT_MONITOR_STATE_CONNECTED;
     break;
   }
+  case MQTT_EVENT_CONNECTION_REFUSED_ERROR: {
+    /* The MQTT engine aborts the connection, which is signaled by a MQTT_EVENT_DISCONNECTED. */
+    LOG_ERR("Connection refused by the MQTT broker.\n");
+    break;
+  }
   case MQTT_EVENT_DISCONNECTED: {
     LOG_ERR("Disconnected from the MQTT broker. Reason %u.\n", *((mqtt_event_t *)data));
     monitor.state = MQTT_MONITOR_STATE_DISCONNECTED;
@@ -354,7 +838,7 @@ handle_mqtt_event(struct mqtt_connection *m, mqtt_event_t event, void *data)
     break;
   }
   case MQTT_EVENT_PUBACK: {
-    LOG_INFO("Publishing completed.\n");
+    LOG_DBG("Publishing completed.\n");
     break;
   }
   default:
@@ -362,6 +846,43 @@ handle_mqtt_event(struct mqtt_connection *m, mqtt_event_t event, void *data)
     break;
   }
 }
+#ifdef MQTT_MONITOR_MQTT_SN
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief   Handle the events received from the MQTT-SN gateway.
+ *
+ *          The events are handled as the ones of the MQTT engine. The messages
+ *          published by the gateway are given the topic corresponding to their
+ *          predefined topic ID.
+ */
+static void
+handle_mqtt_sn_event(struct mqtt_sn_connection *conn, mqtt_event_t event, void *data)
+{
+  static struct mqtt_message msg;
+  struct mqtt_sn_message *sn_msg = (struct mqtt_sn_message *)data;
+  int i;
+
+  if(event != MQTT_EVENT_PUBLISH) {
+    handle_mqtt_event(NULL, event, data);
+    return;
+  }
+
+  for(i = 0; i < MQTT_SN_TOPICS_NUMBER; i++) {
+    if(mqtt_sn_topics[i].topic_id == sn_msg->topic_id) {
+      memset(&msg, 0, sizeof(struct mqtt_message));
+      strncpy(msg.topic, mqtt_sn_topics[i].topic, sizeof(msg.topic) - 1);
+      msg.payload_chunk = (uint8_t *)sn_msg->payload;
+      msg.payload_chunk_length = sn_msg->payload_length;
+      msg.payload_length = sn_msg->payload_length;
+      msg.first_chunk = 1;
+      handle_mqtt_event(NULL, MQTT_EVENT_PUBLISH, &msg);
+      return;
+    }
+  }
+
+  LOG_INFO("Discarding the MQTT-SN message: unknown topic ID %u.\n", sn_msg->topic_id);
+}
+#endif
 /*---------------------------------------------------------------------------*/
 /**
  * \brief   Handle the MQTT_MONITOR_STATE_STARTED state.
@@ -374,33 +895,21 @@ handle_mqtt_event(struct mqtt_connection *m, mqtt_event_t event, void *data)
 static void
 handle_state_started(void)
 {
-  if(network_ready()) {
-    LOG_INFO("Connected to the network. ");
-    LOG_INFO_("Global address: ");
-    LOG_INFO_6ADDR(&(uip_ds6_get_global(ADDR_PREFERRED)->ipaddr));
-    LOG_INFO_(". Link local address: ");
-    LOG_INFO_6ADDR(&(uip_ds6_get_link_local(ADDR_PREFERRED)->ipaddr));
-    LOG_INFO_("\n");
+  if(monitor_core_network_ready()) {
     monitor.state = MQTT_MONITOR_STATE_NETWORK_READY;
-  } else {
-    LOG_INFO("Connecting to the network.\n");
   }
 }
 /*---------------------------------------------------------------------------*/
 /**
- * \brief    Handle the MQTT_MONITOR_STATE_NETWORK_READY state.
- * \return   true if the MQTT broker parameters are valid and a connection
- *           attempt was issued, false otherwise.
+ * \brief   Handle the MQTT_MONITOR_STATE_NETWORK_READY state.
  *
- *           The function handles the MQTT_MONITOR_STATE_NETWORK_READY state,
- *           initializing the monitor ID and the MQTT engine, and issuing a connection
- *           attempt to the MQTT broker. If the connection attempt is issued,
- *           i.e. if the broker parameters are valid, it changes the monitor state
- *           to MQTT_MONITOR_STATE_CONNECTING. It should be noted that the
- *           connection to the broker is finalized only when a MQTT_EVENT_CONNECTED
- *           is received, which is handled by <code>handle_mqtt_event()</code>.
+ *          The function handles the MQTT_MONITOR_STATE_NETWORK_READY state,
+ *          initializing the monitor ID and the MQTT engine, and scheduling the
+ *          first connection attempt to the MQTT broker after a random delay,
+ *          so that the monitors booting together do not connect at the same time.
+ *          It changes the monitor state to MQTT_MONITOR_STATE_CONNECTION_PENDING.
  */
-static bool
+static void
 handle_state_network_ready(void)
 {
   /* Initialize the monitor ID as the global IPv6 address. */
@@ -409,20 +918,60 @@ handle_state_network_ready(void)
                         &(uip_ds6_get_global(ADDR_PREFERRED)->ipaddr));
 
   /* Initialize MQTT engine. */
+#ifdef MQTT_MONITOR_MQTT_SN
+  mqtt_sn_register(&monitor.mqtt_module.connection, monitor.monitor_id, handle_mqtt_sn_event);
+#else
   mqtt_register(&monitor.mqtt_module.connection,
                 &mqtt_vital_signs_monitor,
                 monitor.monitor_id,
                 handle_mqtt_event,
                 MQTT_MONITOR_MAX_TCP_SEGMENT_SIZE);
+#endif
   LOG_INFO("MQTT engine initialized. Monitor id: %s.\n", monitor.monitor_id);
 
-  /* Connect to the broker. */
+  monitor.mqtt_module.next_connection_time = clock_time()
+                                             + backoff_initial_delay(&monitor.mqtt_module.connection_backoff);
+  monitor.state = MQTT_MONITOR_STATE_CONNECTION_PENDING;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief    Handle the MQTT_MONITOR_STATE_CONNECTION_PENDING state.
+ * \return   false if the MQTT broker parameters are invalid, true otherwise.
+ *
+ *           The function handles the MQTT_MONITOR_STATE_CONNECTION_PENDING state,
+ *           issuing a connection attempt to the MQTT broker once the scheduled time
+ *           is reached. If the connection attempt is issued, i.e. if the broker
+ *           parameters are valid, it changes the monitor state to
+ *           MQTT_MONITOR_STATE_CONNECTING. It should be noted that the
+ *           connection to the broker is finalized only when a MQTT_EVENT_CONNECTED
+ *           is received, which is handled by <code>handle_mqtt_event()</code>.
+ */
+static bool
+handle_state_connection_pending(void)
+{
+  if(CLOCK_LT(clock_time(), monitor.mqtt_module.next_connection_time)) {
+    return true;
+  }
+
+  /*
+   * Connect to the broker. The session is persistent, so that the broker keeps the subscription
+   * of the monitor and the QoS 1 commands published while it is disconnected.
+   */
+#ifdef MQTT_MONITOR_MQTT_SN
+  LOG_INFO("Connecting to the MQTT-SN gateway at %s, %d.\n", MQTT_MONITOR_SN_GATEWAY_IP_ADDRESS, MQTT_MONITOR_SN_GATEWAY_PORT);
+  monitor.mqtt_module.status = mqtt_sn_connect(&monitor.mqtt_module.connection,
+                                               MQTT_MONITOR_SN_GATEWAY_IP_ADDRESS,
+                                               MQTT_MONITOR_SN_GATEWAY_PORT,
+                                               broker_keep_alive(),
+                                               MQTT_CLEAN_SESSION_OFF);
+#else
   LOG_INFO("Connecting to the MQTT broker at %s, %d.\n", MQTT_MONITOR_BROKER_IP_ADDRESS, MQTT_MONITOR_BROKER_PORT);
   monitor.mqtt_module.status = mqtt_connect(&monitor.mqtt_module.connection,
                                             MQTT_MONITOR_BROKER_IP_ADDRESS,
                                             MQTT_MONITOR_BROKER_PORT,
-                                            MQTT_MONITOR_BROKER_KEEP_ALIVE,
-                                            MQTT_CLEAN_SESSION_ON);
+                                            broker_keep_alive(),
+                                            MQTT_CLEAN_SESSION_OFF);
+#endif
 
   if(monitor.mqtt_module.status == MQTT_STATUS_ERROR) {
     LOG_ERR("Error while connecting to the MQTT broker: invalid IP address\n");
@@ -435,12 +984,12 @@ handle_state_network_ready(void)
 /*---------------------------------------------------------------------------*/
 /**
  * \brief    Handle the MQTT_MONITOR_STATE_CONNECTED state.
- * \return   true if the subscription to the alarm commands topic is successful,
+ * \return   true if the subscription to the commands topic of the monitor is successful,
  *           false otherwise.
  *
  *           The function handles the MQTT_MONITOR_STATE_CONNECTED state,
- *           issuing a subscription attempt to the topic of alarm commands
- *           sent by the collector. If the attempt is issued, it changes the monitor
+ *           issuing a subscription attempt to the topics of the commands
+ *           (handle assignment, alarm commands and alarm history requests) sent by the collector. If the attempt is issued, it changes the monitor
  *           state to MQTT_MONITOR_STATE_SUBSCRIBING. It should be noted that the
  *           subscription to the topic is finalized only when a MQTT_EVENT_SUBACK
  *           is received, which is handled by <code>handle_mqtt_event()</code>.
@@ -451,15 +1000,24 @@ handle_state_connected(void)
   /* Initialize the topics, using the monitor ID. */
   init_topics();
 
-  /* Subscribe to the topic of alarm commands sent by the collector. */
-  LOG_INFO("Subscribing to the topic %s.\n", monitor.cmd_topics.alarm_state);
+  /*
+   * Subscribe to the topics of the commands sent by the collector to the monitor. The subscription
+   * is renewed at every connection, since the broker may have lost the session (e.g. if restarted).
+   */
+  LOG_INFO("Subscribing to the topic %s.\n", monitor.cmd_topics.monitor);
+#ifdef MQTT_MONITOR_MQTT_SN
+  monitor.mqtt_module.status = mqtt_sn_subscribe(&monitor.mqtt_module.connection,
+                                                 MQTT_MONITOR_SN_TOPIC_ID_COMMANDS,
+                                                 MQTT_MONITOR_SN_EVENTS_QOS);
+#else
   monitor.mqtt_module.status = mqtt_subscribe(&monitor.mqtt_module.connection,
                                               NULL,
-                                              monitor.cmd_topics.alarm_state,
-                                              MQTT_QOS_LEVEL_0);
+                                              monitor.cmd_topics.monitor,
+                                              MQTT_QOS_LEVEL_1);
+#endif
 
   if(monitor.mqtt_module.status != MQTT_STATUS_OK) {
-    LOG_ERR("Failed to subscribe to the topic %s.\n", monitor.cmd_topics.alarm_state);
+    LOG_ERR("Failed to subscribe to the topic %s.\n", monitor.cmd_topics.monitor);
     return false;
   }
 
@@ -468,168 +1026,60 @@ handle_state_connected(void)
 }
 /*---------------------------------------------------------------------------*/
 /**
- * \brief   Handle the MQTT_MONITOR_STATE_SUBSCRIBED state.
+ * \brief   Handle the MQTT_MONITOR_STATE_DISCONNECTED state.
  *
- *          The function handles the MQTT_MONITOR_STATE_SUBSCRIBED state,
- *          registering the monitor to the collector, starting the sensor
- *          processes and initializing the alarm system. It changes the
- *          monitor state to MQTT_MONITOR_STATE_WAITING_PATIENT_ID.
+ *          The function handles the MQTT_MONITOR_STATE_DISCONNECTED state,
+ *          scheduling a new connection attempt after the delay given by the
+ *          connection backoff. It changes the monitor state to
+ *          MQTT_MONITOR_STATE_CONNECTION_PENDING.
  */
 static void
-handle_state_subscribed(void)
+handle_state_disconnected(void)
 {
-  /* Register the monitor sending a message to the collector. */
-  json_message_monitor_registration(monitor.output_buffers.monitor_registration,
-                                    MQTT_MONITOR_OUTPUT_BUFFER_SIZE,
-                                    monitor.monitor_id);
-  publish(monitor.cmd_topics.monitor_registration, monitor.output_buffers.monitor_registration);
-
-  /* Start the sensor processes (without starting the sampling activity). */
-  sensors_cmd_start_processes();
-
-  /* Initialize the alarm system. */
-  alarm_init(&monitor.alarm);
+  clock_time_t delay = backoff_failure(&monitor.mqtt_module.connection_backoff);
 
-  /*
-   * From this point on, monitor.state_check_timer is used only to check
-   * for eventual disconnections (state MQTT_MONITOR_STATE_DISCONNECTED).
-   */
-  monitor.state = MQTT_MONITOR_STATE_WAITING_PATIENT_ID;
-  LOG_INFO("Waiting for a new patient ID on the serial line.\n");
-
-#ifdef AUTOMATIC_PATIENT_ID_CONFIGURATION
-  LOG_INFO("Automatic configuration of the new patient ID.\n");
-  char random_patient_ID[MQTT_MONITOR_PATIENT_ID_LENGTH];
-  snprintf(random_patient_ID, MQTT_MONITOR_PATIENT_ID_LENGTH, "auto_%d", rand());
-  handle_new_patient_ID(random_patient_ID);
-#endif
+  LOG_INFO("Reconnecting to the MQTT broker in %lu s.\n", (unsigned long)(delay / CLOCK_SECOND));
+  monitor.mqtt_module.next_connection_time = clock_time() + delay;
+  monitor.state = MQTT_MONITOR_STATE_CONNECTION_PENDING;
 }
 /*---------------------------------------------------------------------------*/
 /**
- * \brief   Handle the button press event.
+ * \brief   Handle the MQTT_MONITOR_STATE_SUBSCRIBED state.
  *
- *          The function handles the button press event, turning off
- *          the alarm system and resetting the patient ID if the press
- *          duration exceeds a configured number of seconds.
- *          If the patient ID is reset, it changes the
- *          monitor state to MQTT_MONITOR_STATE_WAITING_PATIENT_ID.
+ *          The function handles the MQTT_MONITOR_STATE_SUBSCRIBED state,
+ *          registering the monitor to the collector and starting the sensor
+ *          processes. It changes the monitor state to
+ *          MQTT_MONITOR_STATE_WAITING_PATIENT_ID. If the monitor is reconnecting
+ *          and a patient ID is already configured, the patient ID is sent again
+ *          to the collector and the monitor goes back to MQTT_MONITOR_STATE_OPERATIONAL.
  */
 static void
-handle_button_press(button_hal_button_t *button)
+handle_state_subscribed(void)
 {
-  LOG_INFO("Button press event: %d s.\n", button->press_duration_seconds);
-
-  if(button->press_duration_seconds == MQTT_MONITOR_RESET_ALARM_DURATION
-     || button->press_duration_seconds == MQTT_MONITOR_RESET_PATIENT_ID_DURATION) {
-    bool alarm_state_changed;
+  char *buffer;
 
-    /* The alarm is stopped and an update is sent to the collector, if the alarm was turned on. */
-    LOG_INFO("Resetting the alarm.\n");
-    alarm_state_changed = alarm_stop(&monitor.alarm);
-
-    if(alarm_state_changed) {
-      json_message_alarm_stopped(monitor.output_buffers.alarm_state, MQTT_MONITOR_OUTPUT_BUFFER_SIZE);
-      publish(monitor.telemetry_topics.alarm_state, monitor.output_buffers.alarm_state);
-    }
+  /* Register the monitor sending a message to the collector. */
+  buffer = mqtt_buffer_pool_alloc();
+  if(buffer != NULL) {
+    json_message_monitor_registration(buffer, MQTT_MONITOR_OUTPUT_BUFFER_SIZE, monitor.monitor_id);
+    publish(monitor.cmd_topics.monitor_registration, buffer, MQTT_RETAIN_OFF);
   }
 
-  if(button->press_duration_seconds == MQTT_MONITOR_RESET_PATIENT_ID_DURATION) {
-    LOG_INFO("Resetting the patient ID.\n");
-
-    /* Clear the output queue, to avoid that old messages get assigned to the new patient. */
-    mqtt_output_queue_init(&monitor.mqtt_module.output_queue);
-
-    /* Delete the patient ID in the monitor and in the collector. */
-    memset(monitor.patient_id, 0, MQTT_MONITOR_PATIENT_ID_LENGTH);
-    json_message_patient_registration(monitor.output_buffers.patient_registration,
-                                      MQTT_MONITOR_OUTPUT_BUFFER_SIZE,
-                                      monitor.monitor_id,
-                                      monitor.patient_id);
-    publish(monitor.cmd_topics.patient_registration, monitor.output_buffers.patient_registration);
-
-    /* Stop the sampling activity of the sensors. */
-    sensors_cmd_stop_sampling();
-
-    monitor.state = MQTT_MONITOR_STATE_WAITING_PATIENT_ID;
-    LOG_INFO("Waiting for a new patient ID on the serial line.\n");
+  if(monitor.core.patient_id[0] != '\0') {
+    publish_patient_id(monitor.core.patient_id);
+    update_patient_state(true);
 
-#ifdef AUTOMATIC_PATIENT_ID_CONFIGURATION
-    LOG_INFO("Automatic configuration of the new patient ID.\n");
-    char random_patient_ID[MQTT_MONITOR_PATIENT_ID_LENGTH];
-    snprintf(random_patient_ID, MQTT_MONITOR_PATIENT_ID_LENGTH, "auto_%d", rand());
-    handle_new_patient_ID(random_patient_ID);
-#endif
-  }
-}
-/*---------------------------------------------------------------------------*/
-/**
- * \brief   Handle the reception of a sample from a sensor process.
- *
- *          The function handles the reception of a sample from a
- *          sensor process, sending it to the collector in the correct
- *          telemetry topic. If the sample is an alarming one, it turns
- *          on the alarm system and informs the collector.
- */
-static void
-handle_sensor_sample(process_event_t event, int sample)
-{
-  char *sensor;
-  int min_threshold;
-  int max_threshold;
-
-  if(sensors_cmd_heart_rate_sample_event(event)) {
-    sensor = "heart rate";
-    min_threshold = ALARM_HEART_RATE_MIN_THRESHOLD;
-    max_threshold = ALARM_HEART_RATE_MAX_THRESHOLD;
-    json_message_heart_rate_sample(monitor.output_buffers.heart_rate, MQTT_MONITOR_OUTPUT_BUFFER_SIZE, sample);
-    publish(monitor.telemetry_topics.heart_rate, monitor.output_buffers.heart_rate);
-
-  } else if(sensors_cmd_blood_pressure_sample_event(event)) {
-    sensor = "blood pressure";
-    min_threshold = ALARM_BLOOD_PRESSURE_MIN_THRESHOLD;
-    max_threshold = ALARM_BLOOD_PRESSURE_MAX_THRESHOLD;
-    json_message_blood_pressure_sample(monitor.output_buffers.blood_pressure, MQTT_MONITOR_OUTPUT_BUFFER_SIZE, sample);
-    publish(monitor.telemetry_topics.blood_pressure, monitor.output_buffers.blood_pressure);
-
-  } else if(sensors_cmd_oxygen_saturation_sample_event(event)) {
-    sensor = "oxygen saturation";
-    min_threshold = ALARM_OXYGEN_SATURATION_MIN_THRESHOLD;
-    max_threshold = ALARM_OXYGEN_SATURATION_MAX_THRESHOLD;
-    json_message_oxygen_saturation_sample(monitor.output_buffers.oxygen_saturation, MQTT_MONITOR_OUTPUT_BUFFER_SIZE, sample);
-    publish(monitor.telemetry_topics.oxygen_saturation, monitor.output_buffers.oxygen_saturation);
-
-  } else if(sensors_cmd_respiration_sample_event(event)) {
-    sensor = "respiration";
-    min_threshold = ALARM_RESPIRATION_MIN_THRESHOLD;
-    max_threshold = ALARM_RESPIRATION_MAX_THRESHOLD;
-    json_message_respiration_sample(monitor.output_buffers.respiration, MQTT_MONITOR_OUTPUT_BUFFER_SIZE, sample);
-    publish(monitor.telemetry_topics.respiration, monitor.output_buffers.respiration);
-
-  } else if(sensors_cmd_temperature_sample_event(event)) {
-    sensor = "temperature";
-    min_threshold = ALARM_TEMPERATURE_MIN_THRESHOLD;
-    max_threshold = ALARM_TEMPERATURE_MAX_THRESHOLD;
-    json_message_temperature_sample(monitor.output_buffers.temperature, MQTT_MONITOR_OUTPUT_BUFFER_SIZE, sample);
-    publish(monitor.telemetry_topics.temperature, monitor.output_buffers.temperature);
-
-  } else {
-    LOG_ERR("Dropping a sample from an unhandled sensor process.\n");
+    /* The samples recorded while disconnected are not left waiting for the next window. */
+    mqtt_batch_flush();
     return;
   }
 
-  if(alarming_sample(min_threshold, max_threshold, sample)) {
-    bool alarm_state_changed;
-
-    LOG_INFO("Alarming %s sample detected: %d. Min threshold: %d, max threshold: %d\n",
-             sensor, sample, min_threshold, max_threshold);
-    LOG_INFO("Starting the alarm.\n");
-
-    alarm_state_changed = alarm_start(&monitor.alarm);
-    if(alarm_state_changed) {
-      json_message_alarm_started(monitor.output_buffers.alarm_state, MQTT_MONITOR_OUTPUT_BUFFER_SIZE);
-      publish(monitor.telemetry_topics.alarm_state, monitor.output_buffers.alarm_state);
-    }
-  }
+  /*
+   * Start the sensor processes and wait for a patient ID. From this point on,
+   * monitor.state_check_timer is used only to check for eventual
+   * disconnections (state MQTT_MONITOR_STATE_DISCONNECTED).
+   */
+  update_patient_state(monitor_core_start(&monitor.core));
 }
 /*---------------------------------------------------------------------------*/
 /**
@@ -639,14 +1089,29 @@ static void
 init_monitor()
 {
   monitor.state = MQTT_MONITOR_STATE_STARTED;
+  monitor.handle = -1;
+
+  /* Initialize the alarm system, its history and the patient ID. */
+  monitor_core_init(&monitor.core, &mqtt_transport, &mqtt_vital_signs_monitor);
+
+  /* Initialize the sample history and the batched publishing of the samples. */
+  sample_history_init(&monitor.sample_history);
+  mqtt_batch_init(&monitor.sample_history, publish_batch);
+
+  /* Initialize the backoff of the connection attempts to the broker. */
+  backoff_init(&monitor.mqtt_module.connection_backoff,
+               MONITOR_CORE_BACKOFF_INITIAL_WINDOW*CLOCK_SECOND,
+               MONITOR_CORE_BACKOFF_BASE_DELAY*CLOCK_SECOND,
+               MONITOR_CORE_BACKOFF_MAX_DELAY*CLOCK_SECOND);
 
   /* Initialize the periodic timer to check the internal state. */
   monitor.state_check_interval = MQTT_MONITOR_STATE_CHECK_INTERVAL*CLOCK_SECOND;
   etimer_set(&monitor.state_check_timer, monitor.state_check_interval);
 
-  /* Initialize the message output queue and the periodic timer to send its messages. */
+  /* Initialize the message buffers, the output queue and the periodic timer to send its messages. */
+  mqtt_buffer_pool_init();
   mqtt_output_queue_init(&monitor.mqtt_module.output_queue);
-  monitor.mqtt_module.output_queue_timer_interval = MQTT_MONITOR_OUTPUT_QUEUE_SEND_INTERVAL*CLOCK_SECOND;
+  monitor.mqtt_module.output_queue_timer_interval = monitor_config_send_interval(MQTT_MONITOR_OUTPUT_QUEUE_SEND_INTERVAL)*CLOCK_SECOND;
   ctimer_set(&monitor.mqtt_module.output_queue_timer,
              monitor.mqtt_module.output_queue_timer_interval,
              retry_message_transmission,
@@ -662,9 +1127,7 @@ finish_monitor()
 {
   etimer_stop(&monitor.state_check_timer);
   ctimer_stop(&monitor.mqtt_module.output_queue_timer);
-  sensors_cmd_stop_sampling();
-  sensors_cmd_stop_processes();
-  alarm_stop(&monitor.alarm);
+  monitor_core_finish(&monitor.core);
 }
 /*---------------------------------------------------------------------------*/
 /*
@@ -678,6 +1141,7 @@ finish_monitor()
  * re-inserted pressing the button of the monitor for at least 10 seconds.
  * If the alarm system is triggered, the alarm state can be turned off by
  * pressing the same button for at least 5 seconds.
+ * The events recorded in the binary log are printed by sending "log" on the serial line.
  */
 PROCESS(mqtt_vital_signs_monitor, "MQTT vital signs monitor");
 AUTOSTART_PROCESSES(&mqtt_vital_signs_monitor);
@@ -697,7 +1161,11 @@ PROCESS_THREAD(mqtt_vital_signs_monitor, event, data)
       }
 
       if(monitor.state == MQTT_MONITOR_STATE_NETWORK_READY) {
-        bool success = handle_state_network_ready();
+        handle_state_network_ready();
+      }
+
+      if(monitor.state == MQTT_MONITOR_STATE_CONNECTION_PENDING) {
+        bool success = handle_state_connection_pending();
         if(!success) {
           break;
         }
@@ -718,25 +1186,41 @@ PROCESS_THREAD(mqtt_vital_signs_monitor, event, data)
 
       /* MQTT_MONITOR_STATE_DISCONNECTED is set by handle_mqtt_event(). */
       if(monitor.state == MQTT_MONITOR_STATE_DISCONNECTED) {
-        break;
+        handle_state_disconnected();
+      }
+
+#ifndef MQTT_MONITOR_MQTT_SN
+      release_sent_buffer();
+#endif
+
+      /* The polls (e.g. on a disconnection) are extra checks: they must not move the periodic ones. */
+      if(event == PROCESS_EVENT_TIMER && data == &monitor.state_check_timer) {
+        etimer_reset(&monitor.state_check_timer);
       }
+      continue;
+    }
 
-      etimer_reset(&monitor.state_check_timer);
+    /* The event log can be dumped in any state, so the command is never taken for a patient ID. */
+    if(event == serial_line_event_message && monitor_log_handle_serial_line((char *)data)) {
       continue;
     }
 
     if(event == serial_line_event_message && monitor.state == MQTT_MONITOR_STATE_WAITING_PATIENT_ID) {
-      handle_new_patient_ID((char*)data);
+      monitor_core_set_patient_id(&monitor.core, (char*)data);
+      update_patient_state(true);
       continue;
     }
 
     if(event == button_hal_periodic_event && monitor.state == MQTT_MONITOR_STATE_OPERATIONAL) {
-      handle_button_press((button_hal_button_t *)data);
+      if(monitor_core_handle_button_press(&monitor.core, (button_hal_button_t *)data)) {
+        update_patient_state(monitor_core_wait_patient_id(&monitor.core));
+      }
       continue;
     }
 
-    if(sensors_cmd_sample_event(event) && monitor.state == MQTT_MONITOR_STATE_OPERATIONAL) {
-      handle_sensor_sample(event, *((int *)data));
+    /* The samples are recorded also while disconnected, to be published after the reconnection. */
+    if(sensors_cmd_sample_event(event) && monitor.core.patient_id[0] != '\0') {
+      monitor_core_handle_sample(&monitor.core, event, *((int *)data));
       continue;
     }
   }
@@ -1,21 +1,45 @@
 #ifndef __PROJECT_CONF_H
 #define __PROJECT_CONF_H
 
-/* Log levels. */
-#define LOG_LEVEL_HEART_RATE_SENSOR          LOG_LEVEL_INFO
-#define LOG_LEVEL_BLOOD_PRESSURE_SENSOR      LOG_LEVEL_INFO
-#define LOG_LEVEL_TEMPERATURE_SENSOR         LOG_LEVEL_INFO
-#define LOG_LEVEL_RESPIRATION_SENSOR         LOG_LEVEL_INFO
-#define LOG_LEVEL_OXYGEN_SATURATION_SENSOR   LOG_LEVEL_INFO
-#define LOG_LEVEL_MQTT_MONITOR               LOG_LEVEL_DBG
-#define LOG_LEVEL_ALARM_SYSTEM               LOG_LEVEL_INFO
+/*
+ * Log levels: the highest level compiled in for each module, lowered at runtime to the
+ * level set by the collector, LOG_LEVEL_INFO by default (see common/monitor-log.h).
+ */
+#include "../common/monitor-log.h"
+#define LOG_LEVEL_HEART_RATE_SENSOR          MONITOR_LOG_LEVEL(MONITOR_LOG_SENSORS, LOG_LEVEL_DBG)
+#define LOG_LEVEL_BLOOD_PRESSURE_SENSOR      MONITOR_LOG_LEVEL(MONITOR_LOG_SENSORS, LOG_LEVEL_DBG)
+#define LOG_LEVEL_TEMPERATURE_SENSOR         MONITOR_LOG_LEVEL(MONITOR_LOG_SENSORS, LOG_LEVEL_DBG)
+#define LOG_LEVEL_RESPIRATION_SENSOR         MONITOR_LOG_LEVEL(MONITOR_LOG_SENSORS, LOG_LEVEL_DBG)
+#define LOG_LEVEL_OXYGEN_SATURATION_SENSOR   MONITOR_LOG_LEVEL(MONITOR_LOG_SENSORS, LOG_LEVEL_DBG)
+#define LOG_LEVEL_MQTT_MONITOR               MONITOR_LOG_LEVEL(MONITOR_LOG_TRANSPORT, LOG_LEVEL_DBG)
+#define LOG_LEVEL_ALARM_SYSTEM               MONITOR_LOG_LEVEL(MONITOR_LOG_ALARM_SYSTEM, LOG_LEVEL_INFO)
+#define LOG_LEVEL_MONITOR_CORE               MONITOR_LOG_LEVEL(MONITOR_LOG_MONITOR_CORE, LOG_LEVEL_INFO)
+#define LOG_LEVEL_TIME_SYNC                  MONITOR_LOG_LEVEL(MONITOR_LOG_TIME_SYNC, LOG_LEVEL_INFO)
+#define LOG_LEVEL_MONITOR_CONFIG             MONITOR_LOG_LEVEL(MONITOR_LOG_MONITOR_CONFIG, LOG_LEVEL_INFO)
 
 /* PAN ID configuration. */
 #undef IEEE802154_CONF_PANID
 #define IEEE802154_CONF_PANID 0x0041
 
-/* Enable TCP. */
+/* Energest accounts for the CPU and radio times reported to the collector (see monitor-diagnostics). */
+#define ENERGEST_CONF_ON 1
+
+/*
+ * Samples of each sensor kept in the sample history, i.e. the samples that survive a disconnection
+ * from the broker. The RAM is taken from the message buffers, shared in a pool (see mqtt-buffer-pool).
+ */
+#define SAMPLE_HISTORY_SIZE                  32
+
+/* Enable TCP, which is not needed by the MQTT-SN transport (enabled with "make MQTT_SN=1"). */
+#ifndef MQTT_MONITOR_MQTT_SN
 #define UIP_CONF_TCP 1
+#endif
+
+/* Multicast forwarding of the group commands of the collector (enabled with "make MULTICAST=1"). */
+#ifdef SMART_ICU_MULTICAST
+#include "net/ipv6/multicast/uip-mcast6-engines.h"
+#define UIP_MCAST6_CONF_ENGINE UIP_MCAST6_ENGINE_ESMRF
+#endif
 
 /* Enable automatic configuration of the patient ID. */
 // #define AUTOMATIC_PATIENT_ID_CONFIGURATION
@@ -0,0 +1,114 @@
+/**
+ * \file
+ *         Implementation of the batched publishing of the samples
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \addtogroup mqtt-batch
+ * @{
+ */
+
+#include <string.h>
+#include "contiki.h"
+#include "os/sys/log.h"
+#include "os/sys/ctimer.h"
+#include "../../common/json-message.h"
+#include "../../common/monitor-log.h"
+#include "./mqtt-monitor-constants.h"
+#include "./mqtt-buffer-pool.h"
+#include "./mqtt-batch.h"
+
+#define LOG_MODULE "MQTT batch"
+#define LOG_LEVEL LOG_LEVEL_MQTT_MONITOR
+
+/* State of the batching. */
+static struct sample_history *sample_history;
+static bool (*publish)(char *message);
+static uint32_t published_seq;                  /* Sequence number of the first sample not published yet. */
+
+/* Timer closing the flush window. */
+static struct ctimer flush_timer;
+
+/* Number of samples and batches published by the monitor. */
+static unsigned long published_samples;
+static unsigned long published_batches;
+
+/*---------------------------------------------------------------------------*/
+/* Callback function used by the ctimer. */
+static void
+flush_timer_expired(void *data)
+{
+  mqtt_batch_flush();
+}
+/*---------------------------------------------------------------------------*/
+void
+mqtt_batch_init(struct sample_history *history, bool (*publish_batch)(char *message))
+{
+  sample_history = history;
+  publish = publish_batch;
+  published_seq = history->next_seq;
+  published_samples = 0;
+  published_batches = 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+mqtt_batch_sample_recorded(void)
+{
+  if(sample_history->next_seq - published_seq >= MQTT_MONITOR_BATCH_MAX_SAMPLES) {
+    mqtt_batch_flush();
+    return;
+  }
+
+  /* The first pending sample opens the window. */
+  if(ctimer_expired(&flush_timer)) {
+    ctimer_set(&flush_timer, MQTT_MONITOR_BATCH_FLUSH_WINDOW*CLOCK_SECOND, flush_timer_expired, NULL);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+mqtt_batch_flush(void)
+{
+  uint32_t since;
+  uint32_t next;
+  char *batch;
+
+  ctimer_stop(&flush_timer);
+  if(published_seq == sample_history->next_seq) {
+    return;
+  }
+
+  /*
+   * The samples overwritten in the history before being published are lost. The buffer
+   * of the batch is handed to the publishing function, which gives it back to the pool.
+   */
+  since = MAX(published_seq, sample_history_oldest_seq(sample_history));
+  batch = mqtt_buffer_pool_alloc();
+  if(batch != NULL) {
+    json_message_sample_history(batch, MQTT_MONITOR_OUTPUT_BUFFER_SIZE, sample_history, since, &next);
+    if(next == since) {
+      mqtt_buffer_pool_free(batch);
+    } else if(publish(batch)) {
+      monitor_log_event(MONITOR_LOG_EVENT_BATCH, next - since, strlen(batch));
+      published_samples += next - since;
+      published_batches++;
+      published_seq = next;
+      LOG_DBG("Published %lu samples in %lu batches.\n", published_samples, published_batches);
+    }
+  }
+
+  /* The samples left out wait for the next window. */
+  if(published_seq != sample_history->next_seq) {
+    ctimer_set(&flush_timer, MQTT_MONITOR_BATCH_FLUSH_WINDOW*CLOCK_SECOND, flush_timer_expired, NULL);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+mqtt_batch_discard(void)
+{
+  ctimer_stop(&flush_timer);
+  published_seq = sample_history->next_seq;
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
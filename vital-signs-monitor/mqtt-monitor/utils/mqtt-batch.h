@@ -0,0 +1,62 @@
+/**
+ * \file
+ *         Header file for the batched publishing of the samples
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \defgroup mqtt-batch Batched publishing of the samples
+ * @{
+ *
+ * The mqtt-batch module lets the MQTT monitor publish the samples of all the sensors
+ * in a single message per flush window, instead of a message per sample. The first
+ * sample recorded after a publishing opens a window of MQTT_MONITOR_BATCH_FLUSH_WINDOW
+ * seconds, at the end of which the pending samples are taken from the sample history
+ * and published as a sample history message, whose deltas keep the message compact.
+ * The batch is published before the end of the window if MQTT_MONITOR_BATCH_MAX_SAMPLES
+ * samples are pending, so that they are not overwritten in the sample history.
+ * A batch that cannot be published (e.g. while the monitor is disconnected from the
+ * broker) is kept pending and retried at the end of the next window. The sequence
+ * numbers carried by the message let the collector detect the lost batches.
+ */
+
+#ifndef SMART_ICU_MQTT_BATCH_H
+#define SMART_ICU_MQTT_BATCH_H
+
+#include <stdbool.h>
+#include "contiki.h"
+#include "../../common/sample-history.h"
+
+/**
+ * \brief                 Initialize the batched publishing of the samples.
+ * \param history         A pointer to the sample history holding the samples to publish.
+ * \param publish_batch   The function publishing a batch, which returns false
+ *                        if the message has been neither sent nor enqueued. The batch is
+ *                        encoded in a buffer of the message buffer pool, which the function
+ *                        must give back once the message has been sent or discarded.
+ *
+ *                        The samples recorded in the history before the initialization are not published.
+ */
+void mqtt_batch_init(struct sample_history *history, bool (*publish_batch)(char *message));
+
+/**
+ * \brief   Inform the module that a new sample has been recorded in the sample history.
+ */
+void mqtt_batch_sample_recorded(void);
+
+/**
+ * \brief   Publish the pending samples without waiting for the end of the window.
+ *
+ *          The samples that do not fit in a single message are published
+ *          at the end of the next window.
+ */
+void mqtt_batch_flush(void);
+
+/**
+ * \brief   Discard the pending samples, e.g. because the patient they belong to has been detached.
+ */
+void mqtt_batch_discard(void);
+
+#endif /* SMART_ICU_MQTT_BATCH_H */
+/** @} */
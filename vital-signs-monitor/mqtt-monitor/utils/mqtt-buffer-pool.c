@@ -0,0 +1,77 @@
+/**
+ * \file
+ *         Implementation of the pool of MQTT message buffers
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \addtogroup mqtt-buffer-pool
+ * @{
+ */
+
+#include "contiki.h"
+#include "os/lib/memb.h"
+#include "os/sys/log.h"
+#include "./mqtt-buffer-pool.h"
+
+#define LOG_MODULE "MQTT buffer pool"
+#define LOG_LEVEL LOG_LEVEL_MQTT_MONITOR
+
+/* Structure representing a message buffer of the pool. */
+struct mqtt_buffer {
+  char data[MQTT_MONITOR_OUTPUT_BUFFER_SIZE];
+};
+
+MEMB(mqtt_buffers, struct mqtt_buffer, MQTT_MONITOR_BUFFER_POOL_SIZE);
+
+/* Number of buffers in use, and largest number of buffers in use at the same time. */
+static int used;
+static int max_used;
+
+/*---------------------------------------------------------------------------*/
+void
+mqtt_buffer_pool_init(void)
+{
+  memb_init(&mqtt_buffers);
+  used = 0;
+  max_used = 0;
+}
+/*---------------------------------------------------------------------------*/
+char *
+mqtt_buffer_pool_alloc(void)
+{
+  struct mqtt_buffer *buffer = memb_alloc(&mqtt_buffers);
+
+  if(buffer == NULL) {
+    LOG_ERR("No message buffer available.\n");
+    return NULL;
+  }
+
+  if(++used > max_used) {
+    max_used = used;
+  }
+  buffer->data[0] = '\0';
+  return buffer->data;
+}
+/*---------------------------------------------------------------------------*/
+void
+mqtt_buffer_pool_free(char *buffer)
+{
+  if(buffer == NULL) {
+    return;
+  }
+
+  /* The data are the first member of the buffer. */
+  if(memb_free(&mqtt_buffers, (struct mqtt_buffer *)buffer) == 0) {
+    used--;
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+mqtt_buffer_pool_max_used(void)
+{
+  return max_used;
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
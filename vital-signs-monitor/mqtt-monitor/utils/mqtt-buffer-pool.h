@@ -0,0 +1,51 @@
+/**
+ * \file
+ *         Header file for the pool of MQTT message buffers
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \defgroup mqtt-buffer-pool MQTT message buffer pool
+ * @{
+ *
+ * The mqtt-buffer-pool module provides the buffers in which the MQTT monitor encodes
+ * its messages. Instead of a dedicated buffer per message type, the buffers are borrowed
+ * from a pool of MQTT_MONITOR_BUFFER_POOL_SIZE buffers when a message is encoded, and given
+ * back once the message has been sent or discarded: only the messages being encoded, waiting
+ * in the output queue or being sent by the MQTT engine hold a buffer. The module keeps track
+ * of the largest number of buffers in use at the same time, to size the pool.
+ */
+
+#ifndef SMART_ICU_MQTT_BUFFER_POOL_H
+#define SMART_ICU_MQTT_BUFFER_POOL_H
+
+#include "./mqtt-monitor-constants.h"
+
+/**
+ * \brief   Initialize the pool, giving back all the buffers.
+ */
+void mqtt_buffer_pool_init(void);
+
+/**
+ * \brief    Borrow a buffer from the pool.
+ * \return   A pointer to a buffer of MQTT_MONITOR_OUTPUT_BUFFER_SIZE bytes,
+ *           or NULL if all the buffers are in use.
+ */
+char *mqtt_buffer_pool_alloc(void);
+
+/**
+ * \brief          Give a buffer back to the pool.
+ * \param buffer   A pointer to the buffer, as returned by <code>mqtt_buffer_pool_alloc()</code>.
+ *                 Nothing is done if it is NULL.
+ */
+void mqtt_buffer_pool_free(char *buffer);
+
+/**
+ * \brief    Get the largest number of buffers that have been in use at the same time.
+ * \return   The high-water mark of the pool since its initialization.
+ */
+int mqtt_buffer_pool_max_used(void);
+
+#endif /* SMART_ICU_MQTT_BUFFER_POOL_H */
+/** @} */
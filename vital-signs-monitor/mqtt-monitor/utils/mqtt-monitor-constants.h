@@ -19,7 +19,8 @@
 /* MQTT broker constants. */
 #define MQTT_MONITOR_BROKER_IP_ADDRESS                   "fd00::1" /* IPv6 address of the MQTT broker. */
 #define MQTT_MONITOR_BROKER_PORT                         1883      /* Port of the MQTT broker. */
-#define MQTT_MONITOR_BROKER_KEEP_ALIVE                   60        /* Keep-alive for the MQTT connection. */
+#define MQTT_MONITOR_BROKER_KEEP_ALIVE_MARGIN            30        /* Time in seconds added to the batch interval to get the keep-alive. */
+#define MQTT_MONITOR_BROKER_PINGRESP_TIMEOUT             10        /* Time in seconds within which a PINGRESP must be received. */
 
 /* MQTT monitor (MQTT client) constants. */
 #define MQTT_MONITOR_ID_LENGTH                           46  /* The maximum length of a monitor ID (an IPv6 address). */
@@ -28,11 +29,25 @@
 #define MQTT_MONITOR_INPUT_BUFFER_SIZE                   32  /* Size of the MQTT input buffer. */
 #define MQTT_MONITOR_OUTPUT_BUFFER_SIZE                  256 /* Size of the MQTT output buffer. */
 #define MQTT_MONITOR_TOPIC_MAX_LENGTH                    128 /* Maximum length of a topic label. */
-#define MQTT_MONITOR_OUTPUT_QUEUE_SIZE                   10  /* Size of the output queue used to store MQTT messages. */
+#define MQTT_MONITOR_BUFFER_POOL_SIZE                    6   /* Number of message buffers shared by the messages being encoded, queued and sent. */
+#define MQTT_MONITOR_OUTPUT_QUEUE_SIZE                   (MQTT_MONITOR_BUFFER_POOL_SIZE - 1) /* Size of the output queue (one buffer is being sent). */
 #define MQTT_MONITOR_OUTPUT_QUEUE_SEND_INTERVAL          5   /* Interval in seconds used by the periodic timer to empty the output queue. */
-#define MQTT_MONITOR_PATIENT_ID_LENGTH                   10 /* The maximum length of a patient ID. */
-#define MQTT_MONITOR_RESET_PATIENT_ID_DURATION           10 /* Time in seconds for which the button must be kept pressed to reset the patient ID. */
-#define MQTT_MONITOR_RESET_ALARM_DURATION                5  /* Time in seconds for which the button must be kept pressed to reset the alarm state. */
+
+/* MQTT-SN constants (used when the monitor is built with "make MQTT_SN=1"). */
+#define MQTT_MONITOR_SN_GATEWAY_IP_ADDRESS               "fd00::1" /* IPv6 address of the MQTT-SN gateway. */
+#define MQTT_MONITOR_SN_GATEWAY_PORT                     1884      /* UDP port of the MQTT-SN gateway. */
+#define MQTT_MONITOR_SN_LOCAL_PORT                       1884      /* Local UDP port of the MQTT-SN client. */
+#define MQTT_MONITOR_SN_RETRY_INTERVAL                   5         /* Interval in seconds before a request not acknowledged is sent again. */
+#define MQTT_MONITOR_SN_MAX_RETRIES                      3         /* Retransmissions of a request before the gateway is considered lost. */
+#define MQTT_MONITOR_SN_SAMPLES_QOS                      0         /* QoS (-1, 0 or 1) of the batches, of the states and of the diagnostics of the monitor. */
+#define MQTT_MONITOR_SN_EVENTS_QOS                       1         /* QoS (-1, 0 or 1) of the registrations and of the alarm messages. */
+#define MQTT_MONITOR_SN_SILENCE_KEEP_ALIVES              4         /* Keep-alives without anything from the gateway before a PINGREQ checks it. */
+#define MQTT_MONITOR_SN_PACKET_SIZE                      (MQTT_MONITOR_OUTPUT_BUFFER_SIZE + 9) /* Maximum size of an MQTT-SN packet. */
+
+/* Sample batching constants. */
+#define MQTT_MONITOR_BATCH_FLUSH_WINDOW                  60  /* Time in seconds during which the samples are collected before being published. */
+#define MQTT_MONITOR_BATCH_MAX_SAMPLES                   8   /* Number of pending samples that triggers the publishing before the end of the window. */
+#define MQTT_MONITOR_RETAINED_STATE_INTERVAL             600 /* Minimum interval in seconds between two refreshes of the retained state along with the batches. */
 
 /* MQTT monitor internal states. */
 #define MQTT_MONITOR_STATE_STARTED                       0 /* Initial state. */
@@ -41,20 +56,49 @@
 #define MQTT_MONITOR_STATE_CONNECTED                     3 /* Successfully connected to the broker. */
 #define MQTT_MONITOR_STATE_SUBSCRIBING                   4 /* Subscribing to the topics of interest. */
 #define MQTT_MONITOR_STATE_SUBSCRIBED                    5 /* Subscribed to the topics of interest. */
-#define MQTT_MONITOR_STATE_DISCONNECTED                  6 /* Disconnected from the MQTT broker. */
+#define MQTT_MONITOR_STATE_DISCONNECTED                  6 /* Disconnected from the MQTT broker, a new connection will be scheduled. */
 #define MQTT_MONITOR_STATE_WAITING_PATIENT_ID            7 /* Waiting for a patient ID as input. */
 #define MQTT_MONITOR_STATE_OPERATIONAL                   8 /* Ready for working. */
+#define MQTT_MONITOR_STATE_CONNECTION_PENDING            9 /* Waiting for the delay before a connection attempt. */
 
 /* MQTT command and telemetry topics. */
+#define MQTT_MONITOR_CMD_TOPIC_MONITOR                   "cmd/smartICU/%s/#"
+#define MQTT_MONITOR_CMD_TOPIC_HANDLE                    "cmd/smartICU/%s/handle"
+#define MQTT_MONITOR_CMD_TOPIC_TIME                      "cmd/smartICU/%s/time"
+#define MQTT_MONITOR_CMD_TOPIC_CONFIG                    "cmd/smartICU/%s/config"
 #define MQTT_MONITOR_CMD_TOPIC_ALARM_STATE               "cmd/smartICU/%s/patient-state/alarm-state"
+#define MQTT_MONITOR_CMD_TOPIC_ALARM_HISTORY             "cmd/smartICU/%s/patient-state/alarm-history"
 #define MQTT_MONITOR_CMD_TOPIC_MONITOR_REGISTRATION      "cmd/smartICU/collector/monitor-registration"
 #define MQTT_MONITOR_CMD_TOPIC_PATIENT_REGISTRATION      "cmd/smartICU/collector/patient-registration"
-#define MQTT_MONITOR_TELEMETRY_TOPIC_HEART_RATE          "telemetry/smartICU/%s/patient-state/heart-rate"
-#define MQTT_MONITOR_TELEMETRY_TOPIC_BLOOD_PRESSURE      "telemetry/smartICU/%s/patient-state/blood-pressure"
-#define MQTT_MONITOR_TELEMETRY_TOPIC_TEMPERATURE         "telemetry/smartICU/%s/patient-state/temperature"
-#define MQTT_MONITOR_TELEMETRY_TOPIC_RESPIRATION         "telemetry/smartICU/%s/patient-state/respiration"
-#define MQTT_MONITOR_TELEMETRY_TOPIC_OXYGEN_SATURATION   "telemetry/smartICU/%s/patient-state/oxygen-saturation"
+#define MQTT_MONITOR_TELEMETRY_TOPIC_BATCH               "telemetry/smartICU/%s/batch"
 #define MQTT_MONITOR_TELEMETRY_TOPIC_ALARM_STATE         "telemetry/smartICU/%s/patient-state/alarm-state"
+#define MQTT_MONITOR_TELEMETRY_TOPIC_ALARM_HISTORY       "telemetry/smartICU/%s/patient-state/alarm-history"
+#define MQTT_MONITOR_TELEMETRY_TOPIC_STATE               "telemetry/smartICU/%s/state"
+#define MQTT_MONITOR_TELEMETRY_TOPIC_DIAGNOSTICS         "telemetry/smartICU/%s/diagnostics"
+
+/* Short topics, used in place of the ones above once the collector assigned a handle to the monitor. */
+#define MQTT_MONITOR_SHORT_TOPIC_BATCH                   "t/%u/b"
+#define MQTT_MONITOR_SHORT_TOPIC_ALARM_STATE             "t/%u/as"
+#define MQTT_MONITOR_SHORT_TOPIC_ALARM_HISTORY           "t/%u/ah"
+#define MQTT_MONITOR_SHORT_TOPIC_PATIENT_REGISTRATION    "t/%u/p"
+
+/*
+ * MQTT-SN predefined topic IDs, known in advance by the monitor and the gateway.
+ * The gateway expands the IDs of the telemetry and command topics with the client ID
+ * of the monitor, e.g. MQTT_MONITOR_SN_TOPIC_ID_BATCH in telemetry/smartICU/<monitorID>/batch.
+ */
+#define MQTT_MONITOR_SN_TOPIC_ID_MONITOR_REGISTRATION    1  /* cmd/smartICU/collector/monitor-registration */
+#define MQTT_MONITOR_SN_TOPIC_ID_PATIENT_REGISTRATION    2  /* cmd/smartICU/collector/patient-registration */
+#define MQTT_MONITOR_SN_TOPIC_ID_BATCH                   3  /* telemetry/smartICU/<monitorID>/batch */
+#define MQTT_MONITOR_SN_TOPIC_ID_ALARM_STATE             4  /* telemetry/smartICU/<monitorID>/patient-state/alarm-state */
+#define MQTT_MONITOR_SN_TOPIC_ID_ALARM_HISTORY           5  /* telemetry/smartICU/<monitorID>/patient-state/alarm-history */
+#define MQTT_MONITOR_SN_TOPIC_ID_STATE                   6  /* telemetry/smartICU/<monitorID>/state */
+#define MQTT_MONITOR_SN_TOPIC_ID_DIAGNOSTICS             7  /* telemetry/smartICU/<monitorID>/diagnostics */
+#define MQTT_MONITOR_SN_TOPIC_ID_COMMANDS                16 /* cmd/smartICU/<monitorID>/patient-state/+, /time and /config (subscription only) */
+#define MQTT_MONITOR_SN_TOPIC_ID_CMD_ALARM_STATE         17 /* cmd/smartICU/<monitorID>/patient-state/alarm-state */
+#define MQTT_MONITOR_SN_TOPIC_ID_CMD_ALARM_HISTORY       18 /* cmd/smartICU/<monitorID>/patient-state/alarm-history */
+#define MQTT_MONITOR_SN_TOPIC_ID_CMD_TIME                19 /* cmd/smartICU/<monitorID>/time */
+#define MQTT_MONITOR_SN_TOPIC_ID_CMD_CONFIG              20 /* cmd/smartICU/<monitorID>/config */
 
 #endif /* SMART_ICU_MQTT_MONITOR_CONSTANTS_H */
 /** @} */
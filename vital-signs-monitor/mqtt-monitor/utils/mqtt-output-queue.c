@@ -10,7 +10,6 @@
  * @{
  */
 
-#include <string.h>
 #include "./mqtt-output-queue.h"
 
 /*---------------------------------------------------------------------------*/
@@ -40,20 +39,15 @@ mqtt_output_queue_init(struct mqtt_output_queue *queue)
   queue->length = 0;
 }
 /*---------------------------------------------------------------------------*/
-bool mqtt_output_queue_insert(struct mqtt_output_queue *queue, char *msg, char *topic)
+bool mqtt_output_queue_insert(struct mqtt_output_queue *queue, char *msg, char *topic, mqtt_retain_t retain)
 {
   if(mqtt_output_queue_is_full(queue)) {
     return false;
   }
 
-  memset(queue->msg_queue[queue->insert_index], 0, MQTT_MONITOR_OUTPUT_BUFFER_SIZE);
-  memset(queue->topic_queue[queue->insert_index], 0, MQTT_MONITOR_TOPIC_MAX_LENGTH);
-
-  memcpy(queue->msg_queue[queue->insert_index], msg, MQTT_MONITOR_OUTPUT_BUFFER_SIZE);
-  queue->msg_queue[queue->insert_index][MQTT_MONITOR_OUTPUT_BUFFER_SIZE - 1] = '\0';
-
-  memcpy(queue->topic_queue[queue->insert_index], topic, MQTT_MONITOR_TOPIC_MAX_LENGTH);
-  queue->msg_queue[queue->insert_index][MQTT_MONITOR_TOPIC_MAX_LENGTH - 1] = '\0';
+  queue->msg_queue[queue->insert_index] = msg;
+  queue->topic_queue[queue->insert_index] = topic;
+  queue->retain_queue[queue->insert_index] = retain;
 
   queue->length = queue->length + 1;
   queue->insert_index = (queue->insert_index + 1) % MQTT_MONITOR_OUTPUT_QUEUE_SIZE;
@@ -61,22 +55,27 @@ bool mqtt_output_queue_insert(struct mqtt_output_queue *queue, char *msg, char *
   return true;
 }
 /*---------------------------------------------------------------------------*/
-bool mqtt_output_queue_extract(struct mqtt_output_queue *queue, char *msg, char *topic)
+bool mqtt_output_queue_peek(struct mqtt_output_queue *queue, char **msg, char **topic, mqtt_retain_t *retain)
 {
   if(mqtt_output_queue_is_empty(queue)) {
     return false;
   }
 
-  memcpy(msg, queue->msg_queue[queue->extract_index], MQTT_MONITOR_OUTPUT_BUFFER_SIZE);
-  msg[MQTT_MONITOR_OUTPUT_BUFFER_SIZE - 1] = '\0';
+  *msg = queue->msg_queue[queue->extract_index];
+  *topic = queue->topic_queue[queue->extract_index];
+  *retain = queue->retain_queue[queue->extract_index];
 
-  memcpy(topic, queue->topic_queue[queue->extract_index], MQTT_MONITOR_TOPIC_MAX_LENGTH);
-  topic[MQTT_MONITOR_TOPIC_MAX_LENGTH - 1] = '\0';
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+void mqtt_output_queue_commit(struct mqtt_output_queue *queue)
+{
+  if(mqtt_output_queue_is_empty(queue)) {
+    return;
+  }
 
   queue->length = queue->length - 1;
   queue->extract_index = (queue->extract_index + 1) % MQTT_MONITOR_OUTPUT_QUEUE_SIZE;
-
-  return true;
 }
 /*---------------------------------------------------------------------------*/
 /** @} */
@@ -11,23 +11,28 @@
  *
  * The mqtt-output-queue module provides the implementation of a simple fixed-size FIFO queue.
  * The queue is organized as a circular buffer and does not overwrite old messages if full,
- * i.e. messages are not inserted if the queue is full.
+ * i.e. messages are not inserted if the queue is full. The messages are not copied: the queue
+ * holds the buffers borrowed from the message buffer pool (see mqtt-buffer-pool), which are
+ * given back by whoever removes them from the queue.
  */
 
 #ifndef SMART_ICU_MQTT_OUTPUT_QUEUE_H
 #define SMART_ICU_MQTT_OUTPUT_QUEUE_H
 
 #include <stdbool.h>
+#include "os/net/app-layer/mqtt/mqtt.h"
 #include "./mqtt-monitor-constants.h"
 
 /*
  * Structure representing an MQTT message queue.
- * For each message, the relative publishing topic is saved: given a message in the position i
- * of msg_queue, the associated topic is saved in the same position i of topic_queue.
+ * For each message, the relative publishing topic is saved: given the buffer of a message in the position i
+ * of msg_queue, the buffer holding the associated topic is saved in the same position i of topic_queue,
+ * and the retain flag with which it must be published in the position i of retain_queue.
  */
 struct mqtt_output_queue {
-  char msg_queue[MQTT_MONITOR_OUTPUT_QUEUE_SIZE][MQTT_MONITOR_OUTPUT_BUFFER_SIZE];
-  char topic_queue[MQTT_MONITOR_OUTPUT_QUEUE_SIZE][MQTT_MONITOR_TOPIC_MAX_LENGTH];
+  char *msg_queue[MQTT_MONITOR_OUTPUT_QUEUE_SIZE];
+  char *topic_queue[MQTT_MONITOR_OUTPUT_QUEUE_SIZE];
+  mqtt_retain_t retain_queue[MQTT_MONITOR_OUTPUT_QUEUE_SIZE];
   int insert_index;
   int extract_index;
   int length;
@@ -68,32 +73,44 @@ void mqtt_output_queue_init(struct mqtt_output_queue *queue);
 /**
  * \brief         Insert a message and the relative topic in the given queue.
  * \param queue   A pointer to the queue.
- * \param msg     A pointer to the message to be inserted.
+ * \param msg     A pointer to the buffer of the message to be inserted.
  * \param topic   A pointer to the topic of the message.
+ * \param retain  The retain flag of the message.
  * \return        true if the insertion succeeded, false otherwise.
  *
  *                The function inserts a message and the relative topic in the given queue.
- *                The insertion succeeds only if the queue is not full.
- *                The message must be at most MQTT_MONITOR_OUTPUT_BUFFER_SIZE - 1 long and the topic
- *                must be at most MQTT_MONITOR_TOPIC_MAX_LENGTH - 1 long, otherwise they are truncated.
- *                The inserted messages and topics are always null terminated.
+ *                The insertion succeeds only if the queue is not full: in that case, the queue
+ *                holds the buffer of the message until it is removed, otherwise the buffer
+ *                still belongs to the caller. The topic is not copied: it must be one of the
+ *                topic buffers of the monitor, which outlive the message. A message then follows
+ *                the changes of its topic made while it waits in the queue, e.g. the switch to the
+ *                short topics.
  */
-bool mqtt_output_queue_insert(struct mqtt_output_queue *queue, char *msg, char *topic);
+bool mqtt_output_queue_insert(struct mqtt_output_queue *queue, char *msg, char *topic, mqtt_retain_t retain);
 
 /**
- * \brief         Extract a message and the relative topic from the given queue.
+ * \brief         Get the first message of the given queue, without removing it.
  * \param queue   A pointer to the queue.
- * \param msg     A pointer to the buffer that will hold the message.
- * \param topic   A pointer to the buffer that will hold the topic of the message.
- * \return        true if the extraction succeeded, false otherwise.
+ * \param msg     A pointer to the variable that will point to the message.
+ * \param topic   A pointer to the variable that will point to the topic of the message.
+ * \param retain  A pointer to the variable that will hold the retain flag of the message.
+ * \return        true if the queue is not empty, false otherwise.
  *
- *                The function extracts a message and the relative topic from the given queue.
- *                The extraction succeeds only if the queue is not empty.
- *                The message buffer must be at least MQTT_MONITOR_OUTPUT_BUFFER_SIZE long and the topic
- *                buffer must be at least MQTT_MONITOR_TOPIC_MAX_LENGTH long, otherwise the strings
- *                could be truncated. The extracted messages and topics are always null terminated.
+ *                The function gives access to the first message of the given queue and to the buffer
+ *                holding its topic, so that they can be published without being copied. The message stays
+ *                in the queue until <code>mqtt_output_queue_commit()</code> is called: it must be
+ *                called only once the message has been handed to the MQTT engine.
  */
-bool mqtt_output_queue_extract(struct mqtt_output_queue *queue, char *msg, char *topic);
+bool mqtt_output_queue_peek(struct mqtt_output_queue *queue, char **msg, char **topic, mqtt_retain_t *retain);
+
+/**
+ * \brief         Remove the first message of the given queue.
+ * \param queue   A pointer to the queue.
+ *
+ *                The function removes the message returned by <code>mqtt_output_queue_peek()</code>,
+ *                if the queue is not empty. The buffer of the message then belongs to the caller.
+ */
+void mqtt_output_queue_commit(struct mqtt_output_queue *queue);
 
 #endif /* SMART_ICU_MQTT_OUTPUT_QUEUE_H */
 /** @} */
@@ -0,0 +1,486 @@
+/**
+ * \file
+ *         Implementation of the MQTT-SN client
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \addtogroup mqtt-sn
+ * @{
+ */
+
+#include <string.h>
+#include "contiki.h"
+#include "os/sys/log.h"
+#include "os/net/ipv6/uiplib.h"
+#include "./mqtt-sn.h"
+
+#define LOG_MODULE "MQTT-SN client"
+#define LOG_LEVEL LOG_LEVEL_MQTT_MONITOR
+
+/* MQTT-SN message types. */
+#define MQTT_SN_CONNECT                 0x04
+#define MQTT_SN_CONNACK                 0x05
+#define MQTT_SN_PUBLISH                 0x0C
+#define MQTT_SN_PUBACK                  0x0D
+#define MQTT_SN_SUBSCRIBE               0x12
+#define MQTT_SN_SUBACK                  0x13
+#define MQTT_SN_PINGREQ                 0x16
+#define MQTT_SN_PINGRESP                0x17
+#define MQTT_SN_DISCONNECT              0x18
+
+/* MQTT-SN flags and fields. */
+#define MQTT_SN_FLAG_DUP                0x80
+#define MQTT_SN_FLAG_RETAIN             0x10
+#define MQTT_SN_FLAG_CLEAN_SESSION      0x04
+#define MQTT_SN_FLAG_TOPIC_PREDEFINED   0x01
+#define MQTT_SN_FLAG_QOS(qos)           ((qos) < 0 ? 0x60 : ((qos) & 0x03) << 5)
+#define MQTT_SN_FLAG_GET_QOS(flags)     (((flags) & 0x60) == 0x60 ? -1 : ((flags) & 0x60) >> 5)
+#define MQTT_SN_PROTOCOL_ID             0x01
+#define MQTT_SN_RETURN_CODE_ACCEPTED    0x00
+
+/* States of the connection. */
+#define MQTT_SN_STATE_DISCONNECTED      0
+#define MQTT_SN_STATE_CONNECTING        1
+#define MQTT_SN_STATE_CONNECTED         2
+
+/* Buffer holding the packets that do not wait for an acknowledgement. */
+static uint8_t packet[MQTT_MONITOR_SN_PACKET_SIZE];
+
+/*---------------------------------------------------------------------------*/
+static void
+write_uint16(uint8_t *buffer, uint16_t value)
+{
+  buffer[0] = value >> 8;
+  buffer[1] = value & 0xFF;
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+read_uint16(const uint8_t *buffer)
+{
+  return (buffer[0] << 8) | buffer[1];
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief               Write the header of a packet.
+ * \param buffer        A pointer to the buffer of the packet.
+ * \param type          The message type.
+ * \param body_length   The length of the packet following the header.
+ * \return              The length of the header, after which the body must be written.
+ *
+ *                      Packets longer than 255 bytes encode their length in three bytes.
+ */
+static uint16_t
+write_header(uint8_t *buffer, uint8_t type, uint16_t body_length)
+{
+  if(body_length + 2 <= 0xFF) {
+    buffer[0] = body_length + 2;
+    buffer[1] = type;
+    return 2;
+  }
+
+  buffer[0] = 0x01;
+  write_uint16(buffer + 1, body_length + 4);
+  buffer[3] = type;
+  return 4;
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_packet(struct mqtt_sn_connection *conn, const uint8_t *buffer, uint16_t length)
+{
+  simple_udp_sendto_port(&conn->udp, buffer, length, &conn->gateway, conn->gateway_port);
+  conn->stats.sent_bytes += length;
+  conn->stats.sent_packets++;
+  conn->last_sent = clock_time();
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+next_msg_id(struct mqtt_sn_connection *conn)
+{
+  if(++conn->next_msg_id == 0) {
+    conn->next_msg_id = 1;
+  }
+  return conn->next_msg_id;
+}
+/*---------------------------------------------------------------------------*/
+static void
+clear_pending(struct mqtt_sn_connection *conn)
+{
+  ctimer_stop(&conn->retransmission_timer);
+  conn->pending_length = 0;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief           Close the connection and notify the application.
+ * \param conn      A pointer to the connection.
+ * \param reason    The reason of the disconnection, passed with MQTT_EVENT_DISCONNECTED.
+ */
+static void
+lose_connection(struct mqtt_sn_connection *conn, mqtt_event_t reason)
+{
+  static mqtt_event_t disconnection_reason;
+
+  conn->state = MQTT_SN_STATE_DISCONNECTED;
+  clear_pending(conn);
+  ctimer_stop(&conn->keep_alive_timer);
+
+  disconnection_reason = reason;
+  conn->event_callback(conn, MQTT_EVENT_DISCONNECTED, &disconnection_reason);
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief   Send again the request waiting for an acknowledgement.
+ *
+ *          This function is the callback of the retransmission ctimer. Once the
+ *          retransmissions are exhausted, the gateway is considered lost.
+ */
+static void
+retransmit(void *ptr)
+{
+  struct mqtt_sn_connection *conn = (struct mqtt_sn_connection *)ptr;
+  uint16_t type_index = conn->pending[0] == 0x01 ? 3 : 1;
+
+  if(conn->retransmissions >= MQTT_MONITOR_SN_MAX_RETRIES) {
+    LOG_ERR("No acknowledgement from the gateway.\n");
+    lose_connection(conn, MQTT_EVENT_ERROR);
+    return;
+  }
+
+  /* A PUBLISH sent again is marked as duplicate. */
+  if(conn->pending[type_index] == MQTT_SN_PUBLISH) {
+    conn->pending[type_index + 1] |= MQTT_SN_FLAG_DUP;
+  }
+
+  conn->retransmissions++;
+  conn->stats.retransmissions++;
+  send_packet(conn, conn->pending, conn->pending_length);
+  ctimer_restart(&conn->retransmission_timer);
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief          Send the request stored in the pending buffer, waiting for its acknowledgement.
+ * \param conn     A pointer to the connection.
+ * \param length   The length of the request.
+ * \param msg_id   The message ID of the acknowledgement (0 for CONNECT).
+ */
+static void
+send_request(struct mqtt_sn_connection *conn, uint16_t length, uint16_t msg_id)
+{
+  conn->pending_length = length;
+  conn->pending_msg_id = msg_id;
+  conn->retransmissions = 0;
+  send_packet(conn, conn->pending, length);
+  ctimer_set(&conn->retransmission_timer, MQTT_MONITOR_SN_RETRY_INTERVAL * CLOCK_SECOND, retransmit, conn);
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief   Check the liveness of the gateway and send a PINGREQ if needed.
+ *
+ *          This function is the callback of the keep-alive ctimer. The published messages
+ *          keep the connection alive on their own, so the PINGREQ is sent only after a whole
+ *          keep-alive without sending anything. Since the QoS 0 messages are not acknowledged,
+ *          the liveness of the gateway is also checked with a PINGREQ after
+ *          MQTT_MONITOR_SN_SILENCE_KEEP_ALIVES keep-alives without receiving anything from it.
+ *          The gateway is considered lost if nothing is received within
+ *          MQTT_MONITOR_BROKER_PINGRESP_TIMEOUT seconds from the PINGREQ.
+ */
+static void
+keep_alive(void *ptr)
+{
+  struct mqtt_sn_connection *conn = (struct mqtt_sn_connection *)ptr;
+  clock_time_t interval = conn->keep_alive * CLOCK_SECOND;
+  clock_time_t silence = MQTT_MONITOR_SN_SILENCE_KEEP_ALIVES * interval;
+  clock_time_t sent_idle;
+  clock_time_t received_idle;
+  uint16_t length;
+
+  if(conn->state != MQTT_SN_STATE_CONNECTED) {
+    return;
+  }
+
+  if(conn->waiting_for_pingresp) {
+    LOG_ERR("No PINGRESP from the gateway.\n");
+    lose_connection(conn, MQTT_EVENT_ERROR);
+    return;
+  }
+
+  sent_idle = clock_time() - conn->last_sent;
+  received_idle = clock_time() - conn->last_activity;
+  if(sent_idle < interval && received_idle < silence) {
+    ctimer_set(&conn->keep_alive_timer, MIN(interval - sent_idle, silence - received_idle), keep_alive, conn);
+    return;
+  }
+
+  length = write_header(packet, MQTT_SN_PINGREQ, 0);
+  send_packet(conn, packet, length);
+  conn->stats.pingreqs++;
+  conn->waiting_for_pingresp = true;
+  ctimer_set(&conn->keep_alive_timer, MQTT_MONITOR_BROKER_PINGRESP_TIMEOUT * CLOCK_SECOND, keep_alive, conn);
+}
+/*---------------------------------------------------------------------------*/
+static void
+handle_connack(struct mqtt_sn_connection *conn, const uint8_t *body, uint16_t length)
+{
+  if(conn->state != MQTT_SN_STATE_CONNECTING || length < 1) {
+    return;
+  }
+
+  clear_pending(conn);
+  if(body[0] != MQTT_SN_RETURN_CODE_ACCEPTED) {
+    LOG_ERR("Connection refused by the gateway. Return code: %u.\n", body[0]);
+    conn->event_callback(conn, MQTT_EVENT_CONNECTION_REFUSED_ERROR, NULL);
+    lose_connection(conn, MQTT_EVENT_CONNECTION_REFUSED_ERROR);
+    return;
+  }
+
+  conn->state = MQTT_SN_STATE_CONNECTED;
+  ctimer_set(&conn->keep_alive_timer, conn->keep_alive * CLOCK_SECOND, keep_alive, conn);
+  conn->event_callback(conn, MQTT_EVENT_CONNECTED, NULL);
+}
+/*---------------------------------------------------------------------------*/
+static void
+handle_suback(struct mqtt_sn_connection *conn, const uint8_t *body, uint16_t length)
+{
+  /* Flags, topic ID, message ID and return code. */
+  if(length < 6 || conn->pending_length == 0 || read_uint16(body + 3) != conn->pending_msg_id) {
+    return;
+  }
+
+  clear_pending(conn);
+  if(body[5] != MQTT_SN_RETURN_CODE_ACCEPTED) {
+    LOG_ERR("Subscription refused by the gateway. Return code: %u.\n", body[5]);
+    mqtt_sn_disconnect(conn);
+    lose_connection(conn, MQTT_EVENT_ERROR);
+    return;
+  }
+
+  conn->event_callback(conn, MQTT_EVENT_SUBACK, NULL);
+}
+/*---------------------------------------------------------------------------*/
+static void
+handle_puback(struct mqtt_sn_connection *conn, const uint8_t *body, uint16_t length)
+{
+  /* Topic ID, message ID and return code. */
+  if(length < 5 || conn->pending_length == 0 || read_uint16(body + 2) != conn->pending_msg_id) {
+    return;
+  }
+
+  clear_pending(conn);
+  if(body[4] != MQTT_SN_RETURN_CODE_ACCEPTED) {
+    LOG_ERR("Message %u rejected by the gateway. Return code: %u.\n", read_uint16(body + 2), body[4]);
+  }
+
+  conn->event_callback(conn, MQTT_EVENT_PUBACK, NULL);
+}
+/*---------------------------------------------------------------------------*/
+static void
+handle_publish(struct mqtt_sn_connection *conn, const uint8_t *body, uint16_t length)
+{
+  struct mqtt_sn_message message;
+  uint16_t header_length;
+
+  /* Flags, topic ID and message ID. */
+  if(length < 5) {
+    return;
+  }
+
+  message.topic_id = read_uint16(body + 1);
+  message.payload = body + 5;
+  message.payload_length = length - 5;
+
+  if(MQTT_SN_FLAG_GET_QOS(body[0]) == 1) {
+    header_length = write_header(packet, MQTT_SN_PUBACK, 5);
+    memcpy(packet + header_length, body + 1, 4);
+    packet[header_length + 4] = MQTT_SN_RETURN_CODE_ACCEPTED;
+    send_packet(conn, packet, header_length + 5);
+  }
+
+  conn->event_callback(conn, MQTT_EVENT_PUBLISH, &message);
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief   Handle a packet received from the gateway.
+ */
+static void
+receive(struct simple_udp_connection *c, const uip_ipaddr_t *sender_addr, uint16_t sender_port,
+        const uip_ipaddr_t *receiver_addr, uint16_t receiver_port, const uint8_t *data, uint16_t datalen)
+{
+  /* The UDP connection is the first member of the MQTT-SN connection. */
+  struct mqtt_sn_connection *conn = (struct mqtt_sn_connection *)c;
+  uint16_t length;
+  uint16_t offset;
+
+  if(!uip_ipaddr_cmp(sender_addr, &conn->gateway) || datalen < 2) {
+    return;
+  }
+
+  if(data[0] == 0x01) {
+    if(datalen < 4) {
+      return;
+    }
+    length = read_uint16(data + 1);
+    offset = 3;
+  } else {
+    length = data[0];
+    offset = 1;
+  }
+
+  if(length > datalen || length <= offset) {
+    LOG_ERR("Discarding a malformed packet.\n");
+    return;
+  }
+
+  conn->stats.received_bytes += datalen;
+  conn->last_activity = clock_time();
+  conn->waiting_for_pingresp = false;
+
+  switch(data[offset]) {
+  case MQTT_SN_CONNACK:
+    handle_connack(conn, data + offset + 1, length - offset - 1);
+    break;
+  case MQTT_SN_SUBACK:
+    handle_suback(conn, data + offset + 1, length - offset - 1);
+    break;
+  case MQTT_SN_PUBACK:
+    handle_puback(conn, data + offset + 1, length - offset - 1);
+    break;
+  case MQTT_SN_PUBLISH:
+    handle_publish(conn, data + offset + 1, length - offset - 1);
+    break;
+  case MQTT_SN_PINGRESP:
+    break;
+  case MQTT_SN_DISCONNECT:
+    if(conn->state != MQTT_SN_STATE_DISCONNECTED) {
+      LOG_ERR("Disconnected by the gateway.\n");
+      lose_connection(conn, MQTT_EVENT_DISCONNECTED);
+    }
+    break;
+  default:
+    LOG_DBG("Skipping unhandled message type 0x%02x.\n", data[offset]);
+    break;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+mqtt_sn_register(struct mqtt_sn_connection *conn, const char *client_id, mqtt_sn_event_callback_t event_callback)
+{
+  memset(conn, 0, sizeof(struct mqtt_sn_connection));
+  conn->client_id = client_id;
+  conn->event_callback = event_callback;
+  conn->state = MQTT_SN_STATE_DISCONNECTED;
+  simple_udp_register(&conn->udp, MQTT_MONITOR_SN_LOCAL_PORT, NULL, 0, receive);
+}
+/*---------------------------------------------------------------------------*/
+mqtt_status_t
+mqtt_sn_connect(struct mqtt_sn_connection *conn, const char *host, uint16_t port, uint16_t keep_alive,
+                mqtt_clean_session_t clean_session)
+{
+  uint16_t client_id_length = strlen(conn->client_id);
+  uint16_t offset;
+
+  if(uiplib_ip6addrconv(host, &conn->gateway) == 0) {
+    return MQTT_STATUS_ERROR;
+  }
+
+  /* A connection attempt replaces the previous one. */
+  clear_pending(conn);
+  ctimer_stop(&conn->keep_alive_timer);
+  conn->gateway_port = port;
+  conn->keep_alive = keep_alive;
+  conn->waiting_for_pingresp = false;
+  conn->state = MQTT_SN_STATE_CONNECTING;
+
+  /* Flags, protocol ID, duration and client ID. */
+  offset = write_header(conn->pending, MQTT_SN_CONNECT, 4 + client_id_length);
+  conn->pending[offset] = clean_session == MQTT_CLEAN_SESSION_ON ? MQTT_SN_FLAG_CLEAN_SESSION : 0;
+  conn->pending[offset + 1] = MQTT_SN_PROTOCOL_ID;
+  write_uint16(conn->pending + offset + 2, keep_alive);
+  memcpy(conn->pending + offset + 4, conn->client_id, client_id_length);
+
+  send_request(conn, offset + 4 + client_id_length, 0);
+  return MQTT_STATUS_OK;
+}
+/*---------------------------------------------------------------------------*/
+mqtt_status_t
+mqtt_sn_subscribe(struct mqtt_sn_connection *conn, uint16_t topic_id, int8_t qos)
+{
+  uint16_t msg_id;
+  uint16_t offset;
+
+  if(conn->state != MQTT_SN_STATE_CONNECTED) {
+    return MQTT_STATUS_NOT_CONNECTED_ERROR;
+  }
+
+  if(conn->pending_length > 0) {
+    return MQTT_STATUS_OUT_QUEUE_FULL;
+  }
+
+  /* Flags, message ID and topic ID. */
+  msg_id = next_msg_id(conn);
+  offset = write_header(conn->pending, MQTT_SN_SUBSCRIBE, 5);
+  conn->pending[offset] = MQTT_SN_FLAG_QOS(qos) | MQTT_SN_FLAG_TOPIC_PREDEFINED;
+  write_uint16(conn->pending + offset + 1, msg_id);
+  write_uint16(conn->pending + offset + 3, topic_id);
+
+  send_request(conn, offset + 5, msg_id);
+  return MQTT_STATUS_OK;
+}
+/*---------------------------------------------------------------------------*/
+mqtt_status_t
+mqtt_sn_publish(struct mqtt_sn_connection *conn, uint16_t topic_id, const uint8_t *payload, uint16_t length,
+                int8_t qos, mqtt_retain_t retain)
+{
+  uint8_t *buffer = qos == 1 ? conn->pending : packet;
+  uint16_t msg_id = 0;
+  uint16_t offset;
+
+  /* Flags, topic ID, message ID and payload, after a header of at most 4 bytes. */
+  if(length + 9 > MQTT_MONITOR_SN_PACKET_SIZE) {
+    return MQTT_STATUS_INVALID_ARGS_ERROR;
+  }
+
+  /* Only QoS -1 messages can be sent without a connection. */
+  if(qos >= 0 && conn->state != MQTT_SN_STATE_CONNECTED) {
+    return MQTT_STATUS_NOT_CONNECTED_ERROR;
+  }
+
+  if(qos == 1) {
+    if(conn->pending_length > 0) {
+      return MQTT_STATUS_OUT_QUEUE_FULL;
+    }
+    msg_id = next_msg_id(conn);
+  }
+
+  offset = write_header(buffer, MQTT_SN_PUBLISH, 5 + length);
+  buffer[offset] = MQTT_SN_FLAG_QOS(qos)
+                   | (retain == MQTT_RETAIN_ON ? MQTT_SN_FLAG_RETAIN : 0)
+                   | MQTT_SN_FLAG_TOPIC_PREDEFINED;
+  write_uint16(buffer + offset + 1, topic_id);
+  write_uint16(buffer + offset + 3, msg_id);
+  memcpy(buffer + offset + 5, payload, length);
+
+  if(qos == 1) {
+    send_request(conn, offset + 5 + length, msg_id);
+  } else {
+    send_packet(conn, buffer, offset + 5 + length);
+  }
+  return MQTT_STATUS_OK;
+}
+/*---------------------------------------------------------------------------*/
+void
+mqtt_sn_disconnect(struct mqtt_sn_connection *conn)
+{
+  uint16_t length;
+
+  if(conn->state != MQTT_SN_STATE_DISCONNECTED) {
+    length = write_header(packet, MQTT_SN_DISCONNECT, 0);
+    send_packet(conn, packet, length);
+  }
+
+  conn->state = MQTT_SN_STATE_DISCONNECTED;
+  clear_pending(conn);
+  ctimer_stop(&conn->keep_alive_timer);
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
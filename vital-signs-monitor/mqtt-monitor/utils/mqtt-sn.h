@@ -0,0 +1,146 @@
+/**
+ * \file
+ *         Header file for the MQTT-SN client
+ * \author
+ *         Diego Casu
+ */
+
+/**
+ * \defgroup mqtt-sn MQTT-SN client
+ * @{
+ *
+ * The mqtt-sn module implements the subset of the MQTT-SN v1.2 client protocol used by
+ * the MQTT monitor to reach the broker through a gateway over UDP, avoiding the handshakes,
+ * keep-alives and per-segment acknowledgements of TCP on the 6LoWPAN network.
+ * Only predefined topic IDs are supported, so no topic registration is needed: the
+ * monitor connects, subscribes to the topic of its commands and publishes with QoS -1, 0
+ * or 1. A single request waiting for an acknowledgement (CONNECT, SUBSCRIBE or a QoS 1
+ * PUBLISH) is allowed at a time, and it is sent again every MQTT_MONITOR_SN_RETRY_INTERVAL
+ * seconds up to MQTT_MONITOR_SN_MAX_RETRIES times, after which the gateway is considered lost.
+ * The events are reported with the codes of the Contiki MQTT module, so that the monitor
+ * handles both transports in the same way.
+ */
+
+#ifndef SMART_ICU_MQTT_SN_H
+#define SMART_ICU_MQTT_SN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "contiki.h"
+#include "os/sys/ctimer.h"
+#include "os/net/ipv6/simple-udp.h"
+#include "os/net/app-layer/mqtt/mqtt.h"
+#include "./mqtt-monitor-constants.h"
+
+/* Structure representing a message published by the gateway in a subscribed topic. */
+struct mqtt_sn_message {
+  uint16_t topic_id;
+  const uint8_t *payload;
+  uint16_t payload_length;
+};
+
+/* Structure holding the traffic exchanged with the gateway, to be compared with the one of MQTT over TCP. */
+struct mqtt_sn_stats {
+  unsigned long sent_bytes;
+  unsigned long received_bytes;
+  unsigned long sent_packets;
+  unsigned long retransmissions;
+  unsigned long pingreqs;
+};
+
+struct mqtt_sn_connection;
+
+/*
+ * Callback reporting the events of the connection: MQTT_EVENT_CONNECTED, MQTT_EVENT_DISCONNECTED
+ * (with a pointer to the mqtt_event_t reason), MQTT_EVENT_CONNECTION_REFUSED_ERROR, MQTT_EVENT_SUBACK,
+ * MQTT_EVENT_PUBACK and MQTT_EVENT_PUBLISH (with a pointer to a struct mqtt_sn_message).
+ */
+typedef void (*mqtt_sn_event_callback_t)(struct mqtt_sn_connection *conn, mqtt_event_t event, void *data);
+
+/* Structure representing the connection of an MQTT-SN client to a gateway. */
+struct mqtt_sn_connection {
+  struct simple_udp_connection udp;
+  uip_ipaddr_t gateway;
+  uint16_t gateway_port;
+  const char *client_id;
+  mqtt_sn_event_callback_t event_callback;
+  uint8_t state;
+
+  /* Keep-alive of the connection. */
+  uint16_t keep_alive;
+  clock_time_t last_activity;
+  clock_time_t last_sent;
+  bool waiting_for_pingresp;
+  struct ctimer keep_alive_timer;
+
+  /* Request waiting for an acknowledgement. */
+  uint8_t pending[MQTT_MONITOR_SN_PACKET_SIZE];
+  uint16_t pending_length;
+  uint16_t pending_msg_id;
+  uint8_t retransmissions;
+  struct ctimer retransmission_timer;
+  uint16_t next_msg_id;
+
+  struct mqtt_sn_stats stats;
+};
+
+/**
+ * \brief                  Initialize an MQTT-SN connection.
+ * \param conn             A pointer to the connection.
+ * \param client_id        The client ID, which must stay valid for the whole lifetime of the connection.
+ * \param event_callback   The function that will be notified about the events of the connection.
+ */
+void mqtt_sn_register(struct mqtt_sn_connection *conn, const char *client_id, mqtt_sn_event_callback_t event_callback);
+
+/**
+ * \brief                 Connect to a gateway.
+ * \param conn            A pointer to the connection.
+ * \param host            The IPv6 address of the gateway.
+ * \param port            The UDP port of the gateway.
+ * \param keep_alive      The keep-alive of the connection, in seconds.
+ * \param clean_session   MQTT_CLEAN_SESSION_OFF to ask the gateway to keep the subscriptions.
+ * \return                MQTT_STATUS_OK if the CONNECT has been sent, MQTT_STATUS_ERROR if the address
+ *                        is invalid, MQTT_STATUS_OUT_QUEUE_FULL if a request is still waiting for an acknowledgement.
+ *
+ *                        The connection is established only when MQTT_EVENT_CONNECTED is reported.
+ */
+mqtt_status_t mqtt_sn_connect(struct mqtt_sn_connection *conn, const char *host, uint16_t port, uint16_t keep_alive,
+                              mqtt_clean_session_t clean_session);
+
+/**
+ * \brief            Subscribe to a predefined topic.
+ * \param conn       A pointer to the connection.
+ * \param topic_id   The predefined topic ID.
+ * \param qos        The maximum QoS (0 or 1) of the messages delivered by the gateway.
+ * \return           MQTT_STATUS_OK if the SUBSCRIBE has been sent, MQTT_STATUS_NOT_CONNECTED_ERROR if the client
+ *                   is not connected, MQTT_STATUS_OUT_QUEUE_FULL if a request is still waiting for an acknowledgement.
+ */
+mqtt_status_t mqtt_sn_subscribe(struct mqtt_sn_connection *conn, uint16_t topic_id, int8_t qos);
+
+/**
+ * \brief            Publish a message in a predefined topic.
+ * \param conn       A pointer to the connection.
+ * \param topic_id   The predefined topic ID.
+ * \param payload    A pointer to the payload.
+ * \param length     The length of the payload.
+ * \param qos        The QoS of the message: -1 (sent also while not connected), 0 or 1.
+ * \param retain     MQTT_RETAIN_ON if the broker must retain the message.
+ * \return           MQTT_STATUS_OK if the message has been sent, MQTT_STATUS_NOT_CONNECTED_ERROR if the client
+ *                   is not connected (QoS 0 and 1), MQTT_STATUS_OUT_QUEUE_FULL if a request is still waiting
+ *                   for an acknowledgement (QoS 1), MQTT_STATUS_INVALID_ARGS_ERROR if the payload is too long.
+ *
+ *                   The payload is copied, so the buffer can be reused as soon as the function returns.
+ */
+mqtt_status_t mqtt_sn_publish(struct mqtt_sn_connection *conn, uint16_t topic_id, const uint8_t *payload, uint16_t length,
+                              int8_t qos, mqtt_retain_t retain);
+
+/**
+ * \brief          Disconnect from the gateway.
+ * \param conn     A pointer to the connection.
+ *
+ *                 No event is reported: the connection is closed by the client itself.
+ */
+void mqtt_sn_disconnect(struct mqtt_sn_connection *conn);
+
+#endif /* SMART_ICU_MQTT_SN_H */
+/** @} */